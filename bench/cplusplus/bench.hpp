@@ -0,0 +1,116 @@
+#ifndef GOLD_BENCH_HPP
+#define GOLD_BENCH_HPP
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Gold {
+    namespace bench {
+
+	/**********************************//**
+	* Passed to every benchmark body. The body
+	* runs its workload iterations() times and
+	* may report how much work one iteration does.
+	**************************************/
+	class state {
+	public:
+	    typedef std::chrono::steady_clock clock;
+
+	    state(long _arg, std::size_t _iterations) : arg_value(_arg), iteration_count(_iterations) { }
+	    long arg() const { return arg_value; }
+	    std::size_t iterations() const { return iteration_count; }
+
+	    void set_items_processed(std::size_t items) { items_processed = items; }
+	    void set_bytes_processed(std::size_t bytes) { bytes_processed = bytes; }
+	    std::size_t items() const { return items_processed; }
+	    std::size_t bytes() const { return bytes_processed; }
+
+	    void pause_timing() { pause_start = clock::now(); }
+	    void resume_timing() { paused += clock::now() - pause_start; }
+	    clock::duration paused_time() const { return paused; }
+
+	private:
+	    long arg_value;
+	    std::size_t iteration_count;
+	    std::size_t items_processed = 0;
+	    std::size_t bytes_processed = 0;
+	    clock::time_point pause_start;
+	    clock::duration paused = clock::duration::zero();
+	};
+
+	typedef void (*body)(state&);
+
+	struct benchmark {
+	    std::string name;
+	    std::vector<long> args;
+	    body function;
+	};
+
+	inline std::vector<benchmark>& registry() {
+	    static std::vector<benchmark> benchmarks;
+	    return benchmarks;
+	}
+
+	struct registrar {
+	    registrar(const char* name, std::vector<long> args, body function) {
+		registry().push_back(benchmark { name, std::move(args), function });
+	    }
+	};
+
+	/**********************************//**
+	* Keep the optimizer from discarding a
+	* value that is only computed for timing.
+	**************************************/
+	template <typename T>
+	inline void do_not_optimize(const T& value) {
+	    asm volatile("" : : "r,m"(value) : "memory");
+	}
+
+	/*****************************************************************************************//**
+	* Run every registered benchmark whose name contains argv[1] (or all of them), growing the
+	* iteration count until a run takes at least a tenth of a second, and print one line per
+	* benchmark argument.
+	*********************************************************************************************/
+	inline int run_all(int argc, char** argv) {
+	    const char* filter = argc > 1 ? argv[1] : "";
+	    std::printf("%-52s %16s %16s %12s\n", "benchmark", "time/iter", "items/s", "MB/s");
+	    for (const benchmark& bench : registry()) {
+		for (long arg : bench.args) {
+		    std::string name = bench.name + "/" + std::to_string(arg);
+		    if (name.find(filter) == std::string::npos) {
+			continue;
+		    }
+		    std::size_t iterations = 1;
+		    double seconds = 0;
+		    state result(arg, iterations);
+		    while (true) {
+			state run(arg, iterations);
+			auto start = state::clock::now();
+			bench.function(run);
+			auto elapsed = state::clock::now() - start - run.paused_time();
+			seconds = std::chrono::duration<double>(elapsed).count();
+			result = run;
+			if (seconds >= 0.1 || iterations >= (std::size_t(1) << 30)) {
+			    break;
+			}
+			iterations *= (seconds < 0.01) ? 10 : 2;
+		    }
+		    double per_iteration = seconds / iterations;
+		    std::printf("%-52s %13.1f ns %16.0f %12.2f\n", name.c_str(), per_iteration * 1e9,
+				result.items() / per_iteration, result.bytes() / per_iteration / 1e6);
+		}
+	    }
+	    return 0;
+	}
+    }
+}
+
+#define GOLD_BENCHMARK(group, name, ...)					\
+    static void group##_##name##_benchmark(Gold::bench::state& state);	\
+    static Gold::bench::registrar group##_##name##_registrar(#group "/" #name, { __VA_ARGS__ }, group##_##name##_benchmark); \
+    static void group##_##name##_benchmark(Gold::bench::state& state)
+
+#endif
@@ -0,0 +1,13 @@
+#include "bench.hpp"
+#include "Gold/math/node_pool.hpp"
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char** argv) {
+    // Set GOLD_NODE_POOL=0 to compare against nodes allocated one by one with new
+    const char* pool = std::getenv("GOLD_NODE_POOL");
+    if (!pool || std::strcmp(pool, "0") != 0) {
+	Gold::math::node::pool::set_mode(Gold::math::node::pool::mode::pooled);
+    }
+    return Gold::bench::run_all(argc, argv);
+}
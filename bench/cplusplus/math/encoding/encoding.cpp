@@ -0,0 +1,62 @@
+#include "bench.hpp"
+#include "Gold/math/encoding.hpp"
+
+namespace {
+
+    Gold::math::expression make_expression(long terms) {
+	std::string formula;
+	for (long i = 0; i < terms; i++) {
+	    if (i != 0) {
+		formula.append(i % 3 == 0 ? "-" : "+");
+	    }
+	    formula.append("x").append(std::to_string(i % 7)).append("*2.5^(y-")
+		.append(std::to_string(i)).append(")/Sin[z+1]");
+	}
+	return Gold::math::expression(formula);
+    }
+}
+
+GOLD_BENCHMARK(Encoding, Encode, 16, 256, 4096) {
+    Gold::math::expression expr = make_expression(state.arg());
+    std::string data;
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	data.clear();
+	Gold::math::encode(expr, data);
+	Gold::bench::do_not_optimize(data);
+    }
+    state.set_bytes_processed(data.size());
+    state.set_items_processed(state.arg());
+}
+
+GOLD_BENCHMARK(Encoding, Decode, 16, 256, 4096) {
+    std::string data = Gold::math::encode(make_expression(state.arg()));
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::expression expr = Gold::math::decode(data);
+	Gold::bench::do_not_optimize(expr);
+    }
+    state.set_bytes_processed(data.size());
+    state.set_items_processed(state.arg());
+}
+
+GOLD_BENCHMARK(Encoding, Print, 16, 256, 4096) {
+    // The text round trip that encoding replaces, for comparison
+    Gold::math::expression expr = make_expression(state.arg());
+    std::size_t length = 0;
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::expression copy = expr;
+	length = copy.string().size();
+	Gold::bench::do_not_optimize(length);
+    }
+    state.set_bytes_processed(length);
+    state.set_items_processed(state.arg());
+}
+
+GOLD_BENCHMARK(Encoding, Parse, 16, 256, 4096) {
+    std::string text = make_expression(state.arg()).string();
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::expression expr(text);
+	Gold::bench::do_not_optimize(expr);
+    }
+    state.set_bytes_processed(text.size());
+    state.set_items_processed(state.arg());
+}
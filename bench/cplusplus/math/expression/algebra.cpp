@@ -0,0 +1,41 @@
+#include "bench.hpp"
+#include "Gold/math/expression.hpp"
+
+namespace {
+    Gold::math::expression make_operand(long terms, char variable) {
+	std::string formula;
+	for (long i = 0; i < terms; i++) {
+	    if (i != 0) {
+		formula.append("+");
+	    }
+	    formula.append(1, variable).append("^").append(std::to_string(i + 2)).append("*Sin[y]");
+	}
+	return Gold::math::expression(formula);
+    }
+}
+
+GOLD_BENCHMARK(Algebra, Products, 16, 256) {
+    // Only the four named operands are copied. The products are temporaries, moved into the sum
+    Gold::math::expression a = make_operand(state.arg(), 'a');
+    Gold::math::expression b = make_operand(state.arg(), 'b');
+    Gold::math::expression c = make_operand(state.arg(), 'c');
+    Gold::math::expression d = make_operand(state.arg(), 'd');
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::expression result = a*b + c*d;
+	Gold::bench::do_not_optimize(result);
+    }
+    state.set_items_processed(4 * state.arg());
+}
+
+GOLD_BENCHMARK(Algebra, Accumulate, 16, 256) {
+    // Each step moves the sum so far, so building it is linear rather than quadratic in its size
+    Gold::math::expression x("x");
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::expression sum(0);
+	for (long j = 0; j < state.arg(); j++) {
+	    sum = std::move(sum) + pow(x, Gold::math::expression(int(j))) / Gold::math::expression(int(j + 1));
+	}
+	Gold::bench::do_not_optimize(sum);
+    }
+    state.set_items_processed(state.arg());
+}
@@ -0,0 +1,18 @@
+#include "bench.hpp"
+#include "Gold/math/batch.hpp"
+
+GOLD_BENCHMARK(ParseBatch, Threads, 1, 2, 4, 8, 16) {
+    std::vector<std::string> sources;
+    for (int i = 0; i < 20000; i++) {
+	sources.push_back("a" + std::to_string(i % 13) + "*Sin[x^2-" + std::to_string(i) +
+			  "]/(1+Exp[-k*t]) + c*(y-" + std::to_string(i % 7) + ".5)^3");
+    }
+    std::vector<std::string_view> views(sources.begin(), sources.end());
+    Gold::math::thread_pool pool(unsigned(state.arg()));
+    std::vector<Gold::math::parse_error> errors;
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	std::vector<Gold::math::expression> results = Gold::math::parse_batch(views, errors, pool);
+	Gold::bench::do_not_optimize(results);
+    }
+    state.set_items_processed(sources.size());
+}
@@ -0,0 +1,68 @@
+#include "bench.hpp"
+#include "Gold/math/disk_cache.hpp"
+#include <filesystem>
+
+namespace {
+    std::vector<std::string> make_catalog(long count) {
+	std::vector<std::string> catalog;
+	for (long i = 0; i < count; i++) {
+	    catalog.push_back("a*Sin[x^2 - " + std::to_string(i) + "] / (1 + Exp[-k*t]) + c*(y - 1.5)^3 - " +
+			      "Ln[Abs[z]]*(x + y + z)^(1/2)");
+	}
+	return catalog;
+    }
+
+    struct cache_directory {
+	std::string path;
+	explicit cache_directory(const std::string& _path) : path(_path) { std::filesystem::remove_all(path); }
+	~cache_directory() { std::filesystem::remove_all(path); }
+    };
+}
+
+GOLD_BENCHMARK(DiskCache, Parse, 2000) {
+    // Startup without a cache
+    std::vector<std::string> catalog = make_catalog(state.arg());
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	for (const std::string& source : catalog) {
+	    Gold::math::expression expr(source);
+	    Gold::bench::do_not_optimize(expr);
+	}
+    }
+    state.set_items_processed(catalog.size());
+}
+
+GOLD_BENCHMARK(DiskCache, Cold, 2000) {
+    // First start: every formula is parsed, then the pack is written
+    std::vector<std::string> catalog = make_catalog(state.arg());
+    cache_directory directory("gold_bench_cache_cold");
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	std::filesystem::remove_all(directory.path);
+	Gold::math::disk_cache cache(directory.path);
+	for (const std::string& source : catalog) {
+	    Gold::math::expression expr = cache.parse(source);
+	    Gold::bench::do_not_optimize(expr);
+	}
+	cache.flush();
+    }
+    state.set_items_processed(catalog.size());
+}
+
+GOLD_BENCHMARK(DiskCache, Warm, 2000) {
+    // Later starts: the pack is mapped and every formula is decoded from it
+    std::vector<std::string> catalog = make_catalog(state.arg());
+    cache_directory directory("gold_bench_cache_warm");
+    {
+	Gold::math::disk_cache cache(directory.path);
+	for (const std::string& source : catalog) {
+	    cache.parse(source);
+	}
+    }
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::disk_cache cache(directory.path);
+	for (const std::string& source : catalog) {
+	    Gold::math::expression expr = cache.parse(source);
+	    Gold::bench::do_not_optimize(expr);
+	}
+    }
+    state.set_items_processed(catalog.size());
+}
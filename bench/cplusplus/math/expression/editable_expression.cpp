@@ -0,0 +1,31 @@
+#include "bench.hpp"
+#include "Gold/math/editable_expression.hpp"
+
+namespace {
+    std::string make_source(std::size_t groups) {
+	std::string source = "q*(p+1)^2";
+	for (std::size_t i = 0; i < groups; i++) {
+	    source += " + a" + std::to_string(i) + "*Sin[x*(y-" + std::to_string(i) + ")]";
+	}
+	return source;
+    }
+}
+
+GOLD_BENCHMARK(EditableExpression, Reparse, 256) {
+    std::string source = make_source(state.arg());
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	source[3] = (i % 2) ? 'p' : 'r';
+	Gold::math::expression expr(source);
+	Gold::bench::do_not_optimize(expr);
+    }
+    state.set_bytes_processed(source.size());
+}
+
+GOLD_BENCHMARK(EditableExpression, Edit, 256) {
+    Gold::math::editable_expression expr(make_source(state.arg()));
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	expr.edit({ 3, 1, (i % 2) ? "p" : "r" });
+	Gold::bench::do_not_optimize(expr);
+    }
+    state.set_bytes_processed(expr.source().size());
+}
@@ -0,0 +1,31 @@
+#include "bench.hpp"
+#include "Gold/math/expression_builder.hpp"
+
+// A polynomial in x with arg terms. Time per term should not grow with the number of terms.
+
+GOLD_BENCHMARK(ExpressionBuilder, Polynomial, 1000, 10000, 100000, 1000000) {
+    Gold::math::expression x("x");
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::expression_builder builder = Gold::math::expression_builder::sum();
+	builder.reserve(state.arg());
+	for (long j = 0; j < state.arg(); j++) {
+	    builder.append(Gold::math::expression(0.5 * j) * pow(x, Gold::math::expression(int(j))));
+	}
+	Gold::math::expression sum = builder.finish();
+	Gold::bench::do_not_optimize(sum);
+    }
+    state.set_items_processed(state.arg());
+}
+
+GOLD_BENCHMARK(ExpressionBuilder, Operators, 1000) {
+    // The same with acc = acc + term, for comparison
+    Gold::math::expression x("x");
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::expression sum(0);
+	for (long j = 0; j < state.arg(); j++) {
+	    sum = sum + Gold::math::expression(0.5 * j) * pow(x, Gold::math::expression(int(j)));
+	}
+	Gold::bench::do_not_optimize(sum);
+    }
+    state.set_items_processed(state.arg());
+}
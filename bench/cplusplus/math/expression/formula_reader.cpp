@@ -0,0 +1,42 @@
+#include "bench.hpp"
+#include "Gold/math/formula_reader.hpp"
+#include <cstdio>
+#include <fstream>
+
+namespace {
+    struct catalog_file {
+	std::string path = "gold_bench_catalog.txt";
+	catalog_file() {
+	    std::ofstream out(path, std::ios::binary);
+	    for (int i = 0; i < 50000; i++) {
+		out << "a*Sin[x^2 - " << i << "] / (1 + Exp[-k*t]) + c*(y - 1.5)^3\n";
+	    }
+	}
+	~catalog_file() { std::remove(path.c_str()); }
+    };
+
+    const std::string& catalog() {
+	static const catalog_file file;
+	return file.path;
+    }
+}
+
+GOLD_BENCHMARK(FormulaReader, Sequential, 65536) {
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::formula_reader reader(catalog(), state.arg(), false);
+	for (auto& rec : reader) {
+	    Gold::bench::do_not_optimize(rec);
+	}
+    }
+    state.set_items_processed(50000);
+}
+
+GOLD_BENCHMARK(FormulaReader, Pipelined, 65536) {
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::formula_reader reader(catalog(), state.arg(), true);
+	for (auto& rec : reader) {
+	    Gold::bench::do_not_optimize(rec);
+	}
+    }
+    state.set_items_processed(50000);
+}
@@ -0,0 +1,66 @@
+#include "bench.hpp"
+#include "Gold/math/library.hpp"
+#include <cstdio>
+
+namespace {
+    std::string source(long i) {
+	return "a*Sin[x^2 - " + std::to_string(i) + "] / (1 + Exp[-k*t]) + c*(y - 1.5)^3";
+    }
+
+    struct library_file {
+	std::string path = "gold_bench_library.image";
+	explicit library_file(long count) {
+	    Gold::math::library_builder builder;
+	    for (long i = 0; i < count; i++) {
+		builder.add("f" + std::to_string(i), Gold::math::expression(source(i)));
+	    }
+	    builder.write(path);
+	}
+	~library_file() { std::remove(path.c_str()); }
+    };
+
+    const std::map<std::string, double> args = { {"a", 1}, {"x", 0.5}, {"k", 2}, {"t", 0.1}, {"c", 3}, {"y", 2} };
+}
+
+GOLD_BENCHMARK(Library, Open, 10000) {
+    // What each worker pays at startup: map the image and check it
+    state.pause_timing();
+    library_file file(state.arg());
+    state.resume_timing();
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::expression_library library = Gold::math::expression_library::open(file.path);
+	Gold::bench::do_not_optimize(library);
+    }
+    state.set_items_processed(state.arg());
+}
+
+GOLD_BENCHMARK(Library, Evaluate, 10000) {
+    state.pause_timing();
+    library_file file(state.arg());
+    Gold::math::expression_library library = Gold::math::expression_library::open(file.path);
+    state.resume_timing();
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	for (std::size_t j = 0; j < library.size(); j++) {
+	    double value = library.evaluate(j, args);
+	    Gold::bench::do_not_optimize(value);
+	}
+    }
+    state.set_items_processed(library.size());
+}
+
+GOLD_BENCHMARK(Library, TreeEvaluate, 10000) {
+    // The per process trees the library replaces
+    state.pause_timing();
+    std::vector<Gold::math::expression> catalog;
+    for (long i = 0; i < state.arg(); i++) {
+	catalog.emplace_back(source(i));
+    }
+    state.resume_timing();
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	for (const Gold::math::expression& expr : catalog) {
+	    double value = expr.evaluate(args);
+	    Gold::bench::do_not_optimize(value);
+	}
+    }
+    state.set_items_processed(catalog.size());
+}
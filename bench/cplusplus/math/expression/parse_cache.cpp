@@ -0,0 +1,34 @@
+#include "bench.hpp"
+#include "Gold/math/parse_cache.hpp"
+
+namespace {
+    std::vector<std::string> make_sources(std::size_t distinct) {
+	std::vector<std::string> sources;
+	for (std::size_t i = 0; i < distinct; i++) {
+	    sources.push_back("a*Sin[x^2 - " + std::to_string(i) + "] / (1 + Exp[-k*t]) + c*(y - 1.5)^3");
+	}
+	return sources;
+    }
+}
+
+GOLD_BENCHMARK(ParseCache, Uncached, 1000) {
+    std::vector<std::string> sources = make_sources(state.arg());
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::expression expr(sources[i % sources.size()]);
+	Gold::bench::do_not_optimize(expr);
+    }
+    state.set_items_processed(1);
+}
+
+GOLD_BENCHMARK(ParseCache, Hits, 1000) {
+    std::vector<std::string> sources = make_sources(state.arg());
+    Gold::math::parse_cache cache;
+    for (const std::string& source : sources) {
+	cache.get(source);
+    }
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::parse_cache::handle expr = cache.get(sources[i % sources.size()]);
+	Gold::bench::do_not_optimize(expr);
+    }
+    state.set_items_processed(1);
+}
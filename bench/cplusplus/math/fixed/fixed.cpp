@@ -0,0 +1,63 @@
+#include "bench.hpp"
+#include "Gold/math/fixed.hpp"
+#include "Gold/math/expression.hpp"
+
+namespace {
+    constexpr Gold::math::fixed::variable<0> x;
+    constexpr Gold::math::fixed::variable<1> y;
+    constexpr Gold::math::fixed::variable<2> z;
+
+    // ((x*0.5+y)*x-z)*y+2.5*x*z
+    const auto formula = ((x * 0.5 + y) * x - z) * y + 2.5 * x * z;
+    const char* const source = "((x*0.5+y)*x-z)*y+2.5*x*z";
+}
+
+GOLD_BENCHMARK(Fixed, Evaluate, 0) {
+    double values[] = { 0.5, 1.5, -0.25 };
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::bench::do_not_optimize(values);
+	double value = Gold::math::fixed::evaluate(formula, values);
+	Gold::bench::do_not_optimize(value);
+    }
+    state.set_items_processed(1);
+}
+
+GOLD_BENCHMARK(Fixed, Program, 0) {
+    Gold::math::program compiled = Gold::math::expression(source).compile().bind({"x", "y", "z"});
+    double values[] = { 0.5, 1.5, -0.25 };
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::bench::do_not_optimize(values);
+	double value = compiled.evaluate(values);
+	Gold::bench::do_not_optimize(value);
+    }
+    state.set_items_processed(1);
+}
+
+GOLD_BENCHMARK(Fixed, Rows, 0) {
+    std::size_t rows = 1 << 16;
+    std::vector<double> xs(rows), ys(rows), zs(rows), out(rows);
+    for (std::size_t i = 0; i < rows; i++) {
+	xs[i] = double(i) / rows;
+	ys[i] = 2 - xs[i];
+	zs[i] = xs[i] * 3;
+    }
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	for (std::size_t row = 0; row < rows; row++) {
+	    double values[] = { xs[row], ys[row], zs[row] };
+	    out[row] = Gold::math::fixed::evaluate(formula, values);
+	}
+	Gold::bench::do_not_optimize(out);
+    }
+    state.set_items_processed(rows);
+}
+
+GOLD_BENCHMARK(Fixed, Derivative, 0) {
+    double values[] = { 0.5, 1.5, -0.25 };
+    auto prime = Gold::math::fixed::derivative<0>(formula);
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::bench::do_not_optimize(values);
+	double value = Gold::math::fixed::evaluate(prime, values);
+	Gold::bench::do_not_optimize(value);
+    }
+    state.set_items_processed(1);
+}
@@ -0,0 +1,68 @@
+#include "bench.hpp"
+#include "Gold/math/node.hpp"
+
+namespace {
+    const char* const functions[] = {
+	"Sin", "Cos", "Tan", "Csc", "Sec", "Cot", "ArcSin", "ArcCos", "ArcTan", "Sinh", "Cosh",
+	"Tanh", "Csch", "Sech", "Coth", "ArcSinh", "ArcCosh", "ArcTanh", "Exp", "Ln", "Log"
+    };
+
+    // Every built in derivative rule, applied to an argument the chain rule has to descend into
+    Gold::math::node::base_node::ptr make_sum(long terms) {
+	std::string formula;
+	for (long i = 0; i < terms; i++) {
+	    if (i != 0) {
+		formula.append("+");
+	    }
+	    formula.append(functions[i % 21]).append("[x^2+").append(std::to_string(i)).append("*y]");
+	}
+	return Gold::math::node::make_tree(formula);
+    }
+}
+
+GOLD_BENCHMARK(Node, Derivative, 21, 210) {
+    Gold::math::node::base_node::ptr tree = make_sum(state.arg());
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::node::base_node::ptr derivative = tree->derivative("x");
+	Gold::bench::do_not_optimize(derivative);
+    }
+    state.set_items_processed(state.arg());
+}
+
+GOLD_BENCHMARK(Node, EvaluateFunctions, 21, 210) {
+    // Evaluating every built in function, each on a short argument, so the calls dominate
+    std::string formula;
+    for (long i = 0; i < state.arg(); i++) {
+	if (i != 0) {
+	    formula.append("+");
+	}
+	formula.append(functions[i % 21]).append("[0.25*x]");
+    }
+    Gold::math::node::base_node::ptr tree = Gold::math::node::make_tree(formula);
+    const std::map<std::string, double> args = { {"x", 0.5} };
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	double value = tree->evaluate(args);
+	Gold::bench::do_not_optimize(value);
+    }
+    state.set_items_processed(state.arg());
+}
+
+GOLD_BENCHMARK(Node, EvaluatePowers, 20, 200) {
+    // Checked and evaluated as expression::evaluate does, so the power predicates are measured too
+    std::string formula;
+    for (long i = 0; i < state.arg(); i++) {
+	if (i != 0) {
+	    formula.append("+");
+	}
+	formula.append("(x+").append(std::to_string(i)).append(")^y/(x^2+1)");
+    }
+    Gold::math::node::base_node::ptr tree = Gold::math::node::make_tree(formula);
+    const std::map<std::string, double> args = { {"x", 0.5}, {"y", 1.5} };
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	bool undefined = tree->is_undefined();
+	double value = tree->evaluate(args);
+	Gold::bench::do_not_optimize(undefined);
+	Gold::bench::do_not_optimize(value);
+    }
+    state.set_items_processed(state.arg());
+}
@@ -0,0 +1,76 @@
+#include "bench.hpp"
+#include "Gold/math/node.hpp"
+
+// Run with GOLD_NODE_POOL=0 in the environment to compare against nodes allocated one by one with new
+
+namespace {
+    std::string make_formula(long terms) {
+	std::string formula;
+	for (long i = 0; i < terms; i++) {
+	    if (i != 0) {
+		formula.append("+");
+	    }
+	    formula.append("a").append(std::to_string(i % 7)).append("*(x+").append(std::to_string(i)).append(")^2*Sin[y]");
+	}
+	return formula;
+    }
+}
+
+GOLD_BENCHMARK(NodePool, Construct, 100, 10000) {
+    std::string formula = make_formula(state.arg());
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::node::base_node::ptr tree = Gold::math::node::make_tree(formula);
+	Gold::bench::do_not_optimize(tree);
+	state.pause_timing();
+	tree.reset();
+	state.resume_timing();
+    }
+    state.set_items_processed(state.arg());
+}
+
+GOLD_BENCHMARK(NodePool, Clone, 100, 10000) {
+    Gold::math::node::base_node::ptr tree = Gold::math::node::make_tree(make_formula(state.arg()));
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::node::base_node::ptr copy(tree->clone());
+	Gold::bench::do_not_optimize(copy);
+	state.pause_timing();
+	copy.reset();
+	state.resume_timing();
+    }
+    state.set_items_processed(state.arg());
+}
+
+GOLD_BENCHMARK(NodePool, Destroy, 100, 10000) {
+    Gold::math::node::base_node::ptr tree = Gold::math::node::make_tree(make_formula(state.arg()));
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	state.pause_timing();
+	Gold::math::node::base_node::ptr copy(tree->clone());
+	state.resume_timing();
+	copy.reset();
+	Gold::bench::do_not_optimize(copy);
+    }
+    state.set_items_processed(state.arg());
+}
+
+GOLD_BENCHMARK(NodePool, Evaluate, 100, 10000) {
+    // A tree built by derivative, whose nodes were allocated among short lived temporaries
+    Gold::math::node::base_node::ptr tree = Gold::math::node::make_tree(make_formula(state.arg()))->derivative("x");
+    std::map<std::string, double> args = { {"x", 0.5}, {"y", 1.5} };
+    for (long i = 0; i < 7; i++) {
+	args["a" + std::to_string(i)] = i;
+    }
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	double value = tree->evaluate(args);
+	Gold::bench::do_not_optimize(value);
+    }
+    state.set_items_processed(state.arg());
+}
+
+GOLD_BENCHMARK(NodePool, Derivative, 100, 10000) {
+    Gold::math::node::base_node::ptr tree = Gold::math::node::make_tree(make_formula(state.arg()));
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::node::base_node::ptr derivative = tree->derivative("x");
+	Gold::bench::do_not_optimize(derivative);
+    }
+    state.set_items_processed(state.arg());
+}
@@ -0,0 +1,132 @@
+#include "bench.hpp"
+#include "Gold/math/expression.hpp"
+#include "Gold/math/exception.hpp"
+
+namespace {
+
+    std::string make_formula(long terms) {
+	std::string formula;
+	for (long i = 0; i < terms; i++) {
+	    if (i != 0) {
+		formula.append(i % 3 == 0 ? "-" : "+");
+	    }
+	    formula.append("x").append(std::to_string(i % 7)).append("*2.5^(y-")
+		.append(std::to_string(i)).append(")/Sin[z+1]");
+	}
+	return formula;
+    }
+}
+
+GOLD_BENCHMARK(Parser, Throughput, 16, 64, 256, 1024, 4096, 16384) {
+    std::string formula = make_formula(state.arg());
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::expression expr(formula);
+	Gold::bench::do_not_optimize(expr);
+    }
+    state.set_bytes_processed(formula.size());
+    state.set_items_processed(state.arg());
+}
+
+GOLD_BENCHMARK(Parser, Nesting, 16, 64, 256, 1024) {
+    std::string formula;
+    for (long i = 0; i < state.arg(); i++) {
+	formula.append("(x+");
+    }
+    formula.append("1");
+    formula.append(state.arg(), ')');
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::expression expr(formula);
+	Gold::bench::do_not_optimize(expr);
+    }
+    state.set_bytes_processed(formula.size());
+}
+
+GOLD_BENCHMARK(Parser, Slices, 1024) {
+    // Many short formulas laid out in one buffer, parsed in place
+    std::string buffer;
+    std::vector<std::pair<std::size_t, std::size_t> > slices;
+    for (long i = 0; i < state.arg(); i++) {
+	std::string formula = make_formula(1 + i % 4);
+	slices.emplace_back(buffer.size(), formula.size());
+	buffer.append(formula).append("\n");
+    }
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	for (const auto& slice : slices) {
+	    Gold::math::expression expr(buffer.data() + slice.first, slice.second);
+	    Gold::bench::do_not_optimize(expr);
+	}
+    }
+    state.set_bytes_processed(buffer.size());
+    state.set_items_processed(slices.size());
+}
+
+GOLD_BENCHMARK(Parser, InvalidThrow, 16) {
+    // A formula that only fails at its last character
+    std::string formula = make_formula(state.arg()) + "+";
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	try {
+	    Gold::math::expression expr(formula);
+	    Gold::bench::do_not_optimize(expr);
+	}
+	catch (const Gold::math::exception& e) {
+	    Gold::bench::do_not_optimize(e);
+	}
+    }
+    state.set_bytes_processed(formula.size());
+}
+
+GOLD_BENCHMARK(Parser, InvalidTry, 16) {
+    std::string formula = make_formula(state.arg()) + "+";
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::result<Gold::math::expression> expr = Gold::math::try_parse(formula);
+	Gold::bench::do_not_optimize(expr);
+    }
+    state.set_bytes_processed(formula.size());
+}
+
+GOLD_BENCHMARK(Parser, Validate, 16) {
+    std::string formula = make_formula(state.arg());
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::error_info failure = Gold::math::validate(formula);
+	Gold::bench::do_not_optimize(failure);
+    }
+    state.set_bytes_processed(formula.size());
+}
+
+namespace {
+    std::string make_literal_formula(long terms) {
+	// Generated formulas are mostly fitted coefficients
+	std::string formula;
+	for (long i = 0; i < terms; i++) {
+	    if (i != 0) {
+		formula.append("+");
+	    }
+	    formula.append(std::to_string(0.137 * (i + 1))).append("*x^").append(std::to_string(i % 5))
+		.append("*").append(std::to_string(i + 1)).append("e-").append(std::to_string(3 + i % 9));
+	}
+	return formula;
+    }
+}
+
+GOLD_BENCHMARK(Parser, Literals, 1024) {
+    std::string formula = make_literal_formula(state.arg());
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::expression expr(formula);
+	Gold::bench::do_not_optimize(expr);
+    }
+    state.set_bytes_processed(formula.size());
+    state.set_items_processed(state.arg() * 3);
+}
+
+GOLD_BENCHMARK(Printer, Literals, 1024) {
+    Gold::math::expression expr(make_literal_formula(state.arg()));
+    std::size_t length = 0;
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	// Copies print afresh, since expressions cache their string
+	Gold::math::expression copy = expr;
+	length = copy.string().size();
+	Gold::bench::do_not_optimize(length);
+    }
+    state.set_bytes_processed(length);
+    state.set_items_processed(state.arg() * 3);
+}
@@ -0,0 +1,52 @@
+#include "bench.hpp"
+#include "Gold/math/expression.hpp"
+#include "Gold/math/printer.hpp"
+#include <sstream>
+
+namespace {
+
+    // A deep, wide tree with every kind of node, as derivatives tend to produce
+    Gold::math::node::base_node::ptr make_derivative(long terms) {
+	std::string formula;
+	for (long i = 0; i < terms; i++) {
+	    if (i != 0) {
+		formula.append(i % 2 ? "+" : "-");
+	    }
+	    formula.append("Sin[x*").append(std::to_string(i % 5 + 1)).append("]^(x+y)/(x-2.5)");
+	}
+	return Gold::math::node::make_tree(formula)->derivative("x");
+    }
+}
+
+GOLD_BENCHMARK(Printer, String, 4, 16, 64) {
+    Gold::math::node::base_node::ptr tree = make_derivative(state.arg());
+    std::size_t length = 0;
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	std::string printed = tree->string();
+	length = printed.size();
+	Gold::bench::do_not_optimize(printed);
+    }
+    state.set_bytes_processed(length);
+}
+
+GOLD_BENCHMARK(Printer, Append, 4, 16, 64) {
+    Gold::math::node::base_node::ptr tree = make_derivative(state.arg());
+    std::string printed;
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	printed.clear();
+	Gold::math::node::print(*tree, printed);
+	Gold::bench::do_not_optimize(printed);
+    }
+    state.set_bytes_processed(printed.size());
+}
+
+GOLD_BENCHMARK(Printer, Stream, 4, 16, 64) {
+    Gold::math::node::base_node::ptr tree = make_derivative(state.arg());
+    std::ostringstream stream;
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	stream.seekp(0);
+	Gold::math::node::print(*tree, stream);
+	Gold::bench::do_not_optimize(stream);
+    }
+    state.set_bytes_processed(std::size_t(stream.tellp()));
+}
@@ -0,0 +1,64 @@
+#include "bench.hpp"
+#include "Gold/math/native.hpp"
+#include "Gold/math/expression.hpp"
+
+namespace {
+    const char* const formulas[] = {
+	"((x*0.5+y)*x-z)*y+2.5*x*z",
+	"x*y+z",
+	"(x^2+y^2)^0.5*Cos[x+z]"
+    };
+
+    struct columns {
+	std::size_t rows = 1 << 16;
+	std::vector<double> x, y, z;
+	columns() : x(rows), y(rows), z(rows) {
+	    for (std::size_t i = 0; i < rows; i++) {
+		x[i] = double(i) / rows;
+		y[i] = 2 - x[i];
+		z[i] = x[i] * 3;
+	    }
+	}
+    };
+}
+
+GOLD_BENCHMARK(Native, Compile, 0, 1, 2) {
+    Gold::math::program compiled = Gold::math::expression(formulas[state.arg()]).compile().bind({"x", "y", "z"});
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::native_program native(compiled);
+	Gold::bench::do_not_optimize(native);
+    }
+    state.set_items_processed(1);
+}
+
+GOLD_BENCHMARK(Native, Evaluate, 0, 1, 2) {
+    Gold::math::native_program native(Gold::math::expression(formulas[state.arg()]).compile().bind({"x", "y", "z"}));
+    double values[] = { 0.5, 1.5, -0.25 };
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	double value = native.evaluate(values);
+	Gold::bench::do_not_optimize(value);
+    }
+    state.set_items_processed(1);
+}
+
+GOLD_BENCHMARK(Native, Interpreted, 0, 1, 2) {
+    Gold::math::program compiled = Gold::math::expression(formulas[state.arg()]).compile().bind({"x", "y", "z"});
+    double values[] = { 0.5, 1.5, -0.25 };
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	double value = compiled.evaluate(values);
+	Gold::bench::do_not_optimize(value);
+    }
+    state.set_items_processed(1);
+}
+
+GOLD_BENCHMARK(Native, Batch, 0, 1, 2) {
+    columns data;
+    Gold::math::native_program native(Gold::math::expression(formulas[state.arg()]).compile().bind({"x", "y", "z"}));
+    const double* inputs[] = { data.x.data(), data.y.data(), data.z.data() };
+    std::vector<double> out(data.rows);
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	native.evaluate_batch(inputs, data.rows, out.data());
+	Gold::bench::do_not_optimize(out);
+    }
+    state.set_items_processed(data.rows);
+}
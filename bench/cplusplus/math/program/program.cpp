@@ -0,0 +1,145 @@
+#include "bench.hpp"
+#include "Gold/math/expression.hpp"
+#include "Gold/math/function.hpp"
+
+namespace {
+    const char* const formulas[] = {
+	"x*y+z",
+	"a*Sin[x^2-3]/(1+Exp[-k*t])+c*(y-1.5)^3",
+	"(x^2+y^2)^0.5*Cos[a*t+k]-Ln[1+x*x]*Tanh[y/c]+3.5*z^4-2*x*y*z"
+    };
+
+    const std::map<std::string, double> args = {
+	{"a", 1}, {"c", 3}, {"k", 2}, {"t", 0.1}, {"x", 0.5}, {"y", 2}, {"z", -1.25}
+    };
+}
+
+GOLD_BENCHMARK(Program, Tree, 0, 1, 2) {
+    Gold::math::expression expr(formulas[state.arg()]);
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	double value = expr.evaluate(args);
+	Gold::bench::do_not_optimize(value);
+    }
+    state.set_items_processed(1);
+}
+
+GOLD_BENCHMARK(Program, Compile, 0, 1, 2) {
+    Gold::math::expression expr(formulas[state.arg()]);
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	Gold::math::program compiled = expr.compile();
+	Gold::bench::do_not_optimize(compiled);
+    }
+    state.set_items_processed(1);
+}
+
+GOLD_BENCHMARK(Program, EvaluateMap, 0, 1, 2) {
+    Gold::math::program compiled = Gold::math::expression(formulas[state.arg()]).compile();
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	double value = compiled.evaluate(args);
+	Gold::bench::do_not_optimize(value);
+    }
+    state.set_items_processed(1);
+}
+
+GOLD_BENCHMARK(Program, EvaluateSlots, 0, 1, 2) {
+    Gold::math::program compiled = Gold::math::expression(formulas[state.arg()]).compile();
+    std::vector<double> values;
+    for (const std::string& name : compiled.variables()) {
+	values.push_back(args.at(name));
+    }
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	double value = compiled.evaluate(values.data());
+	Gold::bench::do_not_optimize(value);
+    }
+    state.set_items_processed(1);
+}
+
+GOLD_BENCHMARK(Program, Function, 0, 1, 2) {
+    std::vector<Gold::math::variable> variables;
+    std::vector<double> values;
+    for (const auto& arg : args) {
+	variables.emplace_back(arg.first);
+	values.push_back(arg.second);
+    }
+    Gold::math::function f(variables, Gold::math::expression(formulas[state.arg()]));
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	double value = f.evaluate(values);
+	Gold::bench::do_not_optimize(value);
+    }
+    state.set_items_processed(1);
+}
+
+namespace {
+    const char* const batch_formulas[] = {
+	"((x*0.5+y)*x-z)*y+2.5*x*z",
+	"x*y+z",
+	"(x^2+y^2)^0.5*Cos[x+z]"
+    };
+
+    struct columns {
+	std::size_t rows = 1 << 16;
+	std::vector<double> x, y, z;
+	columns() : x(rows), y(rows), z(rows) {
+	    for (std::size_t i = 0; i < rows; i++) {
+		x[i] = double(i) / rows;
+		y[i] = 2 - x[i];
+		z[i] = x[i] * 3;
+	    }
+	}
+    };
+}
+
+GOLD_BENCHMARK(Program, BatchRows, 0, 1, 2) {
+    // The scalar path: one evaluation per row
+    columns data;
+    Gold::math::program compiled = Gold::math::expression(batch_formulas[state.arg()]).compile().bind({"x", "y", "z"});
+    std::vector<double> out(data.rows);
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	for (std::size_t row = 0; row < data.rows; row++) {
+	    double values[] = { data.x[row], data.y[row], data.z[row] };
+	    out[row] = compiled.evaluate(values);
+	}
+	Gold::bench::do_not_optimize(out);
+    }
+    state.set_items_processed(data.rows);
+}
+
+GOLD_BENCHMARK(Program, Batch, 0, 1, 2) {
+    columns data;
+    Gold::math::program compiled = Gold::math::expression(batch_formulas[state.arg()]).compile().bind({"x", "y", "z"});
+    const double* inputs[] = { data.x.data(), data.y.data(), data.z.data() };
+    std::vector<double> out(data.rows);
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	compiled.evaluate_batch(inputs, data.rows, out.data());
+	Gold::bench::do_not_optimize(out);
+    }
+    state.set_items_processed(data.rows);
+}
+
+GOLD_BENCHMARK(Program, ParallelBatch, 0, 1, 2) {
+    columns data;
+    Gold::math::program compiled = Gold::math::expression(batch_formulas[state.arg()]).compile().bind({"x", "y", "z"});
+    const double* inputs[] = { data.x.data(), data.y.data(), data.z.data() };
+    std::vector<double> out(data.rows);
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	compiled.evaluate_batch(inputs, data.rows, out.data(), Gold::math::thread_pool::shared());
+	Gold::bench::do_not_optimize(out);
+    }
+    state.set_items_processed(data.rows);
+}
+
+GOLD_BENCHMARK(Program, Grid, 0, 1, 2) {
+    Gold::math::program compiled = Gold::math::expression(batch_formulas[state.arg()]).compile().bind({"x", "y", "z"});
+    std::vector<std::vector<double> > axes(3, std::vector<double>(64));
+    for (std::size_t i = 0; i < 64; i++) {
+	axes[0][i] = i / 64.0;
+	axes[1][i] = 2 - i / 32.0;
+	axes[2][i] = i * 0.75;
+    }
+    std::vector<double> out(64 * 64 * 64);
+    for (std::size_t i = 0; i < state.iterations(); i++) {
+	compiled.evaluate_grid(axes, out.data());
+	Gold::bench::do_not_optimize(out);
+    }
+    state.set_items_processed(out.size());
+}
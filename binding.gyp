@@ -18,15 +18,50 @@
 	    'include_dirs': [
                 'src/cplusplus/vendor/googletest/googletest/include',
 		'include',
+		'test/cplusplus/math',
 	    ],
 	    'sources': [ 
 		'src/cplusplus/math/node/node.cpp',
+		'src/cplusplus/math/node/node_pool.cpp',
 		'src/cplusplus/math/expression/expression.cpp',
 		'src/cplusplus/math/expression/variable.cpp',
 		'src/cplusplus/math/function/function.cpp',
 		'src/cplusplus/math/utils/utils.cpp',
+		'src/cplusplus/math/parser/parser.cpp',
+		'src/cplusplus/math/thread_pool/thread_pool.cpp',
+		'src/cplusplus/math/expression/batch.cpp',
+		'src/cplusplus/math/expression/parse_cache.cpp',
+		'src/cplusplus/math/expression/formula_reader.cpp',
+		'src/cplusplus/math/expression/disk_cache.cpp',
+		'src/cplusplus/math/mapped_file/mapped_file.cpp',
+		'src/cplusplus/math/expression/library.cpp',
+		'src/cplusplus/math/expression/editable_expression.cpp',
+		'src/cplusplus/math/expression/expression_builder.cpp',
+		'src/cplusplus/math/expression/result.cpp',
+		'src/cplusplus/math/printer/printer.cpp',
+		'src/cplusplus/math/encoding/encoding.cpp',
+		'src/cplusplus/math/program/program.cpp',
+		'src/cplusplus/math/program/kernels.cpp',
+		'src/cplusplus/math/program/parallel.cpp',
+		'src/cplusplus/math/program/native.cpp',
 		'test/cplusplus/math/utils/utils.cpp',
+		'test/cplusplus/math/parser/parser.cpp',
+		'test/cplusplus/math/thread_pool/thread_pool.cpp',
+		'test/cplusplus/math/expression/batch.cpp',
+		'test/cplusplus/math/expression/parse_cache.cpp',
+		'test/cplusplus/math/expression/formula_reader.cpp',
+		'test/cplusplus/math/expression/disk_cache.cpp',
+		'test/cplusplus/math/expression/library.cpp',
+		'test/cplusplus/math/expression/editable_expression.cpp',
+		'test/cplusplus/math/expression/expression_builder.cpp',
+		'test/cplusplus/math/printer/printer.cpp',
+		'test/cplusplus/math/encoding/encoding.cpp',
+		'test/cplusplus/math/program/program.cpp',
+		'test/cplusplus/math/program/native.cpp',
+		'test/cplusplus/math/fixed/fixed.cpp',
 		'test/cplusplus/math/node/node.cpp',
+		'test/cplusplus/math/node/allocation.cpp',
+		'test/cplusplus/math/node/node_pool.cpp',
 		'test/cplusplus/math/expression/expression.cpp',
 		'test/cplusplus/math/function/function.cpp',
 		'test/cplusplus/math/test.cxx',
@@ -40,7 +75,7 @@
 		'--coverage',
 		'-fprofile-arcs',
 		'-ftest-coverage',
-		'--std=c++14',
+		'--std=c++17',
 	    ],
 	    'cflags!': [ '-fno-exceptions' ],
 	    'cflags_cc!': [ '-fno-exceptions' ],
@@ -49,13 +84,88 @@
 		'-fprofile-arcs',
 	    ],
 	},
+	{
+	    'target_name': 'math_bench',
+	    'type': 'executable',
+	    'include_dirs': [
+		'bench/cplusplus',
+		'include',
+	    ],
+	    'sources': [
+		'src/cplusplus/math/node/node.cpp',
+		'src/cplusplus/math/node/node_pool.cpp',
+		'src/cplusplus/math/expression/expression.cpp',
+		'src/cplusplus/math/expression/variable.cpp',
+		'src/cplusplus/math/function/function.cpp',
+		'src/cplusplus/math/utils/utils.cpp',
+		'src/cplusplus/math/parser/parser.cpp',
+		'src/cplusplus/math/thread_pool/thread_pool.cpp',
+		'src/cplusplus/math/expression/batch.cpp',
+		'src/cplusplus/math/expression/parse_cache.cpp',
+		'src/cplusplus/math/expression/formula_reader.cpp',
+		'src/cplusplus/math/expression/disk_cache.cpp',
+		'src/cplusplus/math/mapped_file/mapped_file.cpp',
+		'src/cplusplus/math/expression/library.cpp',
+		'src/cplusplus/math/expression/editable_expression.cpp',
+		'src/cplusplus/math/expression/expression_builder.cpp',
+		'src/cplusplus/math/expression/result.cpp',
+		'src/cplusplus/math/printer/printer.cpp',
+		'src/cplusplus/math/encoding/encoding.cpp',
+		'src/cplusplus/math/program/program.cpp',
+		'src/cplusplus/math/program/kernels.cpp',
+		'src/cplusplus/math/program/parallel.cpp',
+		'src/cplusplus/math/program/native.cpp',
+		'bench/cplusplus/math/parser/parser.cpp',
+		'bench/cplusplus/math/node/node.cpp',
+		'bench/cplusplus/math/node/node_pool.cpp',
+		'bench/cplusplus/math/expression/batch.cpp',
+		'bench/cplusplus/math/expression/parse_cache.cpp',
+		'bench/cplusplus/math/expression/formula_reader.cpp',
+		'bench/cplusplus/math/expression/disk_cache.cpp',
+		'bench/cplusplus/math/expression/library.cpp',
+		'bench/cplusplus/math/expression/editable_expression.cpp',
+		'bench/cplusplus/math/expression/algebra.cpp',
+		'bench/cplusplus/math/expression/expression_builder.cpp',
+		'bench/cplusplus/math/printer/printer.cpp',
+		'bench/cplusplus/math/encoding/encoding.cpp',
+		'bench/cplusplus/math/program/program.cpp',
+		'bench/cplusplus/math/program/native.cpp',
+		'bench/cplusplus/math/fixed/fixed.cpp',
+		'bench/cplusplus/math/bench.cxx',
+	    ],
+	    'cflags_cc': [
+		'-Wall',
+		'-Werror',
+		'-O3',
+		'--std=c++17',
+	    ],
+	    'cflags!': [ '-fno-exceptions' ],
+	    'cflags_cc!': [ '-fno-exceptions' ],
+	    'ldflags': [
+		'-pthread',
+	    ],
+	},
 	{
 	    'target_name': 'binding',
 	    'sources': [
                 'src/cplusplus/math/utils/utils.cpp',
+                'src/cplusplus/math/parser/parser.cpp',
                 'src/cplusplus/math/node/node.cpp',
+                'src/cplusplus/math/node/node_pool.cpp',
                 'src/cplusplus/math/expression/expression.cpp',
-	    	'src/cplusplus/bindings/expression.cpp'
+                'src/cplusplus/math/expression/result.cpp',
+                'src/cplusplus/math/printer/printer.cpp',
+                'src/cplusplus/math/encoding/encoding.cpp',
+                'src/cplusplus/math/program/program.cpp',
+                'src/cplusplus/math/program/kernels.cpp',
+                'src/cplusplus/math/program/parallel.cpp',
+                'src/cplusplus/math/program/native.cpp',
+                'src/cplusplus/math/thread_pool/thread_pool.cpp',
+                'src/cplusplus/math/mapped_file/mapped_file.cpp',
+                'src/cplusplus/math/expression/library.cpp',
+	    	'src/cplusplus/bindings/expression.cpp',
+	    	'src/cplusplus/bindings/library.cpp',
+	    	'src/cplusplus/bindings/binding.cpp'
 	    ],
 	    "include_dirs" : [
 		"<!(node -e \"require('nan')\")",
@@ -66,7 +176,7 @@
 	    	'-Wall',
 		'-Werror',
                 '-O3',
-                '--std=c++14'
+                '--std=c++17'
             ],
 	    'cflags_cc!': [ '-fno-exceptions' ],
 	}
@@ -10,19 +10,22 @@ public:
 private:
     Expression() { //Intentionally empty
     }
-    explicit Expression(const std::string& str) : expression(std::make_unique<Gold::math::expression>(str)) {}
+    explicit Expression(std::string_view str) : expression(std::make_unique<Gold::math::expression>(str)) {}
     explicit Expression(int value) : expression(std::make_unique<Gold::math::expression>(value)) {}
     explicit Expression(double value) : expression(std::make_unique<Gold::math::expression>(value)) {}
     ~Expression() { //Intentionally empty
     }
 
     static std::map<std::string, Gold::math::expression> v8_object_to_map(v8::Isolate* isolate, const v8::Local<v8::Object>& object);
+    static void return_new(const Nan::FunctionCallbackInfo<v8::Value>& info, Gold::math::expression&& value);
 
     static NAN_METHOD(New);
     static NAN_METHOD(toString);
     static NAN_METHOD(defined);
     static NAN_METHOD(evaluate);
     static NAN_METHOD(call);
+    static NAN_METHOD(toAST);
+    static NAN_METHOD(fromAST);
 
     static inline Nan::Persistent<v8::Function> & constructor() {
 	static Nan::Persistent<v8::Function> my_constructor;
@@ -0,0 +1,34 @@
+#include <cstdint>
+#include <memory>
+#include <nan.h>
+#include <nan_object_wrap.h>
+#include "Gold/math/library.hpp"
+
+class ExpressionLibrary : public Nan::ObjectWrap {
+public:
+    static NAN_MODULE_INIT(Init);
+
+private:
+    ExpressionLibrary() { //Intentionally empty
+    }
+    ~ExpressionLibrary() { //Intentionally empty
+    }
+
+    static void return_new(const Nan::FunctionCallbackInfo<v8::Value>& info, std::unique_ptr<std::uint64_t[]> image,
+			   std::unique_ptr<Gold::math::expression_library> library);
+
+    static NAN_METHOD(New);
+    static NAN_METHOD(open);
+    static NAN_METHOD(fromImage);
+    static NAN_METHOD(evaluate);
+
+    static inline Nan::Persistent<v8::Function> & constructor() {
+	static Nan::Persistent<v8::Function> my_constructor;
+	return my_constructor;
+    }
+
+    // fromImage copies the image here, aligned, so later writes to the buffer cannot reach a
+    // library that has already checked it. Declared first so that it outlives the library.
+    std::unique_ptr<std::uint64_t[]> image;
+    std::unique_ptr<Gold::math::expression_library> library;
+};
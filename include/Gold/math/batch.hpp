@@ -0,0 +1,44 @@
+#ifndef GOLD_MATH_BATCH_HPP
+#define GOLD_MATH_BATCH_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Gold/math/expression.hpp"
+#include "Gold/math/thread_pool.hpp"
+
+namespace Gold {
+    namespace math {
+
+	/**********************************//**
+	* Why the formula at index could not be
+	* parsed.
+	**************************************/
+	struct parse_error {
+	    std::size_t index;
+	    std::string message;
+	};
+
+	/*****************************************************************************************//**
+	* Parse many formulas at once, spreading them over the threads of a pool. Parsing shares no
+	* mutable state between threads, so the only synchronisation is collecting the errors.
+	*
+	* formulas => The sources to parse. Each view must stay valid until the call returns.\n
+	* count    => How many formulas there are.\n
+	* errors   => Receives one entry per formula that failed, ordered by index.\n
+	* pool     => The threads to parse on.
+	*
+	* Return value: One expression per formula, in order. Formulas that failed to parse are left
+	*               as default constructed expressions, which are not defined().
+	*********************************************************************************************/
+	std::vector<expression> parse_batch(const std::string_view* formulas, std::size_t count,
+					    std::vector<parse_error>& errors,
+					    thread_pool& pool = thread_pool::shared());
+
+	std::vector<expression> parse_batch(const std::vector<std::string_view>& formulas,
+					    std::vector<parse_error>& errors,
+					    thread_pool& pool = thread_pool::shared());
+    }
+}
+
+#endif
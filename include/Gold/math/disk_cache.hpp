@@ -0,0 +1,108 @@
+#ifndef GOLD_MATH_DISK_CACHE_HPP
+#define GOLD_MATH_DISK_CACHE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Gold/math/expression.hpp"
+#include "Gold/math/mapped_file.hpp"
+
+namespace Gold {
+    namespace math {
+
+	/*****************************************************************************************//**
+	* An opt-in cache of parsed expressions that outlives the process. All entries live in one
+	* pack file in the cache directory, which is memory mapped when the cache is opened, so a
+	* warm start only decodes trees straight out of the mapping instead of parsing their source.
+	*
+	* Entries are keyed by a hash of the normalized source (see parse_cache::normalize) and
+	* store that source, so a hash collision is caught, plus a checksum, so a torn or corrupted
+	* entry is caught. Either way the source is simply parsed again and the entry replaced.
+	* New entries are kept in memory until flush, which, holding a lock file in the directory,
+	* merges them with the pack as it is on disk, writes and syncs a fresh pack next to the old
+	* one and renames it into place. Readers never see a partial file, and caches flushing the
+	* same directory, in one process or several, keep each other's entries. The pack format is
+	* versioned; a pack from another version is ignored and rewritten on the next flush.
+	*
+	* All members are safe to call from several threads at once.
+	*********************************************************************************************/
+	class disk_cache {
+	public:
+	    /**********************************//**
+	    * Counters since the cache was opened.
+	    * stale counts entries that were found
+	    * but failed verification.
+	    **************************************/
+	    struct statistics {
+		std::size_t hits;
+		std::size_t misses;
+		std::size_t stale;
+		std::size_t entries;
+	    };
+
+	    /**********************************//**
+	    * Open, or create, the cache in
+	    * directory. Throws io_error if the
+	    * directory cannot be created.
+	    **************************************/
+	    explicit disk_cache(const std::string& directory);
+	    disk_cache(const disk_cache& other) = delete;
+	    disk_cache& operator=(const disk_cache& other) = delete;
+
+	    /**********************************//**
+	    * Flushes, ignoring write errors.
+	    **************************************/
+	    ~disk_cache();
+
+	    /*****************************************************************************************//**
+	    * Load source from the cache, parsing it on a miss or a stale entry. Parse errors are
+	    * thrown exactly as the expression constructor throws them and nothing is cached.
+	    *********************************************************************************************/
+	    expression parse(std::string_view source);
+
+	    /**********************************//**
+	    * Write entries added since the last
+	    * flush to disk. Throws io_error.
+	    **************************************/
+	    void flush();
+
+	    statistics stats() const;
+
+	    /**********************************//**
+	    * The pack file inside the directory.
+	    **************************************/
+	    const std::string& path() const { return pack_path; }
+
+	private:
+	    /**********************************//**
+	    * Where an entry lives: in the mapped
+	    * pack, or in pending when it is new.
+	    **************************************/
+	    struct location {
+		bool pending;
+		std::size_t offset;
+	    };
+
+	    struct pending_entry {
+		std::string source;
+		std::string tree;
+	    };
+
+	    void open_pack();
+	    bool load(const std::shared_ptr<const mapped_file>& pack, std::size_t offset, const std::string& key, expression& out) const;
+
+	    std::string pack_path;
+	    mutable std::mutex mutex;
+	    std::shared_ptr<const mapped_file> pack;
+	    std::unordered_map<std::uint64_t, location> index;
+	    std::vector<pending_entry> pending;
+	    statistics counters;
+	};
+    }
+}
+
+#endif
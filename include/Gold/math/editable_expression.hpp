@@ -0,0 +1,60 @@
+#ifndef GOLD_MATH_EDITABLE_EXPRESSION_HPP
+#define GOLD_MATH_EDITABLE_EXPRESSION_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Gold/math/expression.hpp"
+#include "Gold/math/parser.hpp"
+
+namespace Gold {
+    namespace math {
+
+	/**********************************//**
+	* Replace removed characters at offset
+	* with inserted.
+	**************************************/
+	struct text_edit {
+	    std::size_t offset;
+	    std::size_t removed;
+	    std::string inserted;
+	};
+
+	/*****************************************************************************************//**
+	* An expression kept together with its source, for callers such as editors that change the
+	* source a little at a time. An edit re-parses only the smallest '(' or '[' group around it
+	* and swaps the new subtree into the existing tree; everything outside that group is kept as
+	* it is. When no group can be re-parsed on its own, for example because the edit turns a
+	* bracketed product into a sum that now has to be flattened into its surroundings, the whole
+	* source is parsed again. Either way the result is the same as expression(source()).
+	*********************************************************************************************/
+	class editable_expression {
+	public:
+	    explicit editable_expression(std::string source);
+	    editable_expression(const editable_expression& other) = delete;
+	    editable_expression& operator=(const editable_expression& other) = delete;
+
+	    /*****************************************************************************************//**
+	    * Apply an edit to the source and update the expression to match. If the new source does
+	    * not parse, the same exception as expression(source) is thrown and nothing changes.
+	    *
+	    * Return value: true if only part of the source was parsed again.
+	    *********************************************************************************************/
+	    bool edit(const text_edit& change);
+
+	    const expression& value() const { return expr; }
+	    const std::string& source() const { return text; }
+
+	private:
+	    void parse_all(std::string&& new_text);
+	    node::base_node::ptr* find_slot(const node::base_node* target);
+
+	    std::string text;
+	    expression expr;
+	    std::vector<parser::token> tokens;
+	    std::vector<node::base_node*> groups;
+	};
+    }
+}
+
+#endif
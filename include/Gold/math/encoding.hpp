@@ -0,0 +1,48 @@
+#ifndef GOLD_MATH_ENCODING_HPP
+#define GOLD_MATH_ENCODING_HPP
+
+#include <string>
+#include <string_view>
+#include "Gold/math/expression.hpp"
+#include "Gold/math/node.hpp"
+
+namespace Gold {
+    namespace math {
+	namespace node {
+
+	    /*****************************************************************************************//**
+	    * Append a compact binary encoding of tree to out. The encoding starts with a magic number
+	    * and a format version, then a table of every distinct variable and function name, then
+	    * the nodes in pre-order: a tag for the node's class, its arity, an index into the name
+	    * table where it has a name, and literals as raw little endian int32 or IEEE double.
+	    * Counts and indices are LEB128 varints.
+	    *********************************************************************************************/
+	    void encode(const base_node& tree, std::string& out);
+
+	    /*****************************************************************************************//**
+	    * Rebuild a tree from the output of encode. data is only read, so it may point into a
+	    * mapped file. Decoding is one pass over data with no text parsing, allocating each node
+	    * once and each operation's child list once, at its final size. Returns null for an empty
+	    * tree. Throws invalid_encoding if data is truncated, from another version, nested more
+	    * than 10000 operations deep, or otherwise malformed.
+	    *********************************************************************************************/
+	    base_node::ptr decode(std::string_view data);
+	}
+
+	/**********************************//**
+	* Encode the tree of expr. An undefined
+	* expression encodes as an empty tree.
+	**************************************/
+	void encode(const expression& expr, std::string& out);
+
+	std::string encode(const expression& expr);
+
+	/**********************************//**
+	* Decode the output of encode into an
+	* expression. Throws invalid_encoding.
+	**************************************/
+	expression decode(std::string_view data);
+    }
+}
+
+#endif
@@ -33,6 +33,10 @@ namespace Gold {
 	EXTEND_EXCEPTION(variable_not_found, exception);
 
 	EXTEND_EXCEPTION(invalid_node, exception);
+
+	EXTEND_EXCEPTION(io_error, exception);
+
+	EXTEND_EXCEPTION(invalid_encoding, exception);
    }
 }
 
@@ -1,24 +1,35 @@
 #ifndef EXPRESSION_HP
 #define EXPRESSION_HP
 
+#include <ostream>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <map>
 #include <functional>
 #include <vector>
 #include <exception>
 #include "Gold/math/node.hpp"
+#include "Gold/math/program.hpp"
+#include "Gold/math/result.hpp"
 #include "Gold/math/utils.hpp"
 
 namespace Gold {
     namespace math {
 
+	/*****************************************************************************************//**
+	* Const members other than string() may be called from several threads at once. string()
+	* fills a cache on first use, so an expression shared between threads must have string()
+	* called once before it is shared, or be printed with operator<<, which leaves the cache
+	* alone. For heavy concurrent evaluation, compile() once and share the program instead.
+	*********************************************************************************************/
 	class expression {
 	public:
 	    expression();
-	    explicit expression(const std::string& expr);
-	    explicit expression(int value) : expression(std::to_string(value)) { }
-	    explicit expression(double value) : expression(std::to_string(value)) { }
+	    explicit expression(std::string_view expr);
+	    expression(const char* expr, std::size_t length) : expression(std::string_view(expr, length)) { }
+	    explicit expression(int value);
+	    explicit expression(double value);
 	    expression(const expression& other);
 	    expression(expression&& other);
 	    virtual ~expression() { //Intentionally empty
@@ -27,6 +38,19 @@ namespace Gold {
 	    expression& operator=(expression&& other);
 
 	    virtual double evaluate(const std::map<std::string, double>& args = {}) const;
+
+	    /**********************************//**
+	    * Like evaluate, but returns an error
+	    * instead of throwing.
+	    **************************************/
+	    result<double> try_evaluate(const std::map<std::string, double>& args = {}) const;
+
+	    /**********************************//**
+	    * Compile for fast repeated evaluation.
+	    * Throws what evaluate would throw for
+	    * any arguments.
+	    **************************************/
+	    program compile() const;
 	    virtual expression operator()(const std::map<std::string, expression>& args = {}) const; 
 	    virtual bool defined() const;
 	    virtual std::string string() const { 
@@ -36,19 +60,56 @@ namespace Gold {
 		return string_value; 
 	    }
 
-	    friend expression operator+(const expression& lhs, const expression& rhs);
-	    friend expression operator-(const expression& expr);
-	    friend expression operator-(const expression& lfs, const expression& rhs);
-	    friend expression operator*(const expression& lhs, const expression& rhs);
-	    friend expression operator/(const expression& lhs, const expression& rhs);
-	    friend expression pow(const expression& lhs, const expression& rhs);
+	    /*****************************************************************************************//**
+	    * The algebra operators take their operands by value and build the result from their
+	    * nodes, so a temporary operand, such as the products in a*b + c*d, is moved into the
+	    * result instead of copied. Only operands that are still named get copied.
+	    *********************************************************************************************/
+	    friend expression operator+(expression lhs, expression rhs);
+	    friend expression operator-(expression expr);
+	    friend expression operator-(expression lhs, expression rhs);
+	    friend expression operator*(expression lhs, expression rhs);
+	    friend expression operator/(expression lhs, expression rhs);
+	    friend expression pow(expression lhs, expression rhs);
 	    friend expression derivative(const expression& expr,const std::string& var);
+	    friend std::ostream& operator<<(std::ostream& out, const expression& expr);
+	    friend result<expression> try_parse(std::string_view expr);
+	    friend void encode(const expression& expr, std::string& out);
+	    friend expression decode(std::string_view data);
+	    friend class parse_cache;
+	    friend class editable_expression;
+	    friend class expression_builder;
+	    friend class library_builder;
+	    friend class expression_library;
 	private:
-	    static expression commutative_operator(const expression& lhs, const expression& rhs, const std::string& operation);
+	    static expression commutative_operator(expression lhs, expression rhs, node::node_kind operation);
 
 	    node::base_node::ptr root;
 	    mutable std::string string_value;
 	};
+
+	/**********************************//**
+	* Write expr as string() would return it,
+	* without building the string. Writes
+	* nothing for an undefined expression.
+	**************************************/
+	std::ostream& operator<<(std::ostream& out, const expression& expr);
+
+	/*****************************************************************************************//**
+	* Parse an expression without throwing. The input is checked before any node is allocated,
+	* so invalid input costs no more than a scan of its tokens.
+	*
+	* Return value: The expression, or the error expression(expr) would have thrown and the
+	*               offset in expr where it was found.
+	*********************************************************************************************/
+	result<expression> try_parse(std::string_view expr);
+
+	/**********************************//**
+	* Check the syntax of expr without
+	* building a tree. The code is none when
+	* try_parse would succeed.
+	**************************************/
+	error_info validate(std::string_view expr);
 	
     }
 }
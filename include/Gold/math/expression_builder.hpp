@@ -0,0 +1,65 @@
+#ifndef GOLD_MATH_EXPRESSION_BUILDER_HPP
+#define GOLD_MATH_EXPRESSION_BUILDER_HPP
+
+#include <cstddef>
+#include "Gold/math/expression.hpp"
+
+namespace Gold {
+    namespace math {
+
+	/*****************************************************************************************//**
+	* Builds a sum or a product of many terms in time linear in the number of terms. Terms are
+	* moved into a single list of children as they are appended, and finish() hands that list
+	* to one add or multiply node, so no term is copied and no node is rebuilt along the way.
+	* Terms that are themselves sums, for a sum builder, or products, for a product builder,
+	* are flattened into the list, as operator+ and operator* would.
+	*
+	* Meant for generated formulas with thousands to millions of terms, where acc = acc + term
+	* would copy the accumulated node at every step.
+	*********************************************************************************************/
+	class expression_builder {
+	public:
+	    /**********************************//**
+	    * operation => node_kind::add or
+	    *              node_kind::multiply. Throws
+	    *              invalid_argument for any
+	    *              other kind.
+	    **************************************/
+	    explicit expression_builder(node::node_kind operation);
+
+	    static expression_builder sum() { return expression_builder(node::node_kind::add); }
+	    static expression_builder product() { return expression_builder(node::node_kind::multiply); }
+
+	    /**********************************//**
+	    * Make room for this many terms in all.
+	    **************************************/
+	    void reserve(std::size_t terms) { children.reserve(terms); }
+
+	    /**********************************//**
+	    * Append term, taking its nodes. Throws
+	    * invalid_argument if term is empty.
+	    **************************************/
+	    expression_builder& append(expression term);
+
+	    /**********************************//**
+	    * Number of children so far, counting
+	    * those of flattened terms.
+	    **************************************/
+	    std::size_t size() const { return children.size(); }
+
+	    /*****************************************************************************************//**
+	    * The sum or product of the terms appended so far: the only term itself if there is one,
+	    * and 0 or 1 if there are none. The builder is left empty, ready for another expression.
+	    *********************************************************************************************/
+	    expression finish();
+
+	    node::node_kind kind() const { return operation; }
+
+	private:
+	    node::node_kind operation;
+	    node::base_node::vec children;
+	};
+    }
+}
+
+#endif
@@ -0,0 +1,629 @@
+#ifndef GOLD_MATH_FIXED_HPP
+#define GOLD_MATH_FIXED_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Gold/math/node.hpp"
+
+namespace Gold {
+    namespace math {
+
+	/*****************************************************************************************//**
+	* Expression templates for formulas known at build time. A formula is written in C++ over
+	* variable<I> placeholders,
+	*
+	*     constexpr fixed::variable<0> x;
+	*     constexpr fixed::variable<1> y;
+	*     auto f = x * fixed::Sin(y) + fixed::literal<2>;
+	*     double value = fixed::evaluate(f, 0.5, 1.25);
+	*
+	* and its type is its tree, so evaluation is ordinary inline code: no nodes, no allocation,
+	* no virtual calls, with every constant where the compiler can fold it. Nodes evaluate as
+	* their node:: counterparts do, in the same order, so results are bit for bit those of the
+	* same tree built at run time.
+	*
+	* derivative<I>(f) differentiates by variable I at compile time, with the rules of
+	* add::derivative, multiply::derivative, power::derivative and function::derivative, and
+	* gives the same tree they would. Those rules drop factors and terms that are known to be
+	* zero or one, which here is decided from the types, so exact integers should be written as
+	* literal<N>. Other numbers become a number, which is never taken to be zero or one.
+	*
+	* tree() builds the equivalent node tree, for printing or handing to the rest of the
+	* library.
+	*********************************************************************************************/
+	namespace fixed {
+
+	    template <long long N> struct integer;
+	    struct number;
+	    template <std::size_t I> struct variable;
+	    template <class... Terms> struct add;
+	    template <class... Factors> struct multiply;
+	    template <class Base, class Exponent> struct power;
+	    template <class Function, class Argument> struct call;
+	    struct ln_function;
+
+	    template <class T> struct is_multiply : std::false_type {};
+	    template <class... Factors> struct is_multiply<multiply<Factors...> > : std::true_type {};
+
+	    template <class T> struct is_add : std::false_type {};
+	    template <class... Terms> struct is_add<add<Terms...> > : std::true_type {};
+
+	    /**********************************//**
+	    * Build a node from the elements of a
+	    * tuple, as is, without flattening.
+	    **************************************/
+	    template <class... Terms>
+	    constexpr add<Terms...> make_add(const std::tuple<Terms...>& terms) {
+		return add<Terms...> { terms };
+	    }
+
+	    template <class... Factors>
+	    constexpr multiply<Factors...> make_multiply(const std::tuple<Factors...>& factors) {
+		return multiply<Factors...> { factors };
+	    }
+
+	    template <long long N>
+	    struct integer {
+		static constexpr bool is_zero = N == 0;
+		static constexpr bool is_one = N == 1;
+		static constexpr bool is_minus_one = N == -1;
+
+		constexpr double evaluate(const double*) const { return double(N); }
+
+		template <std::size_t I>
+		constexpr integer<0> derivative() const { return {}; }
+
+		node::base_node::ptr tree(const std::vector<std::string>&) const {
+		    return std::make_unique<node::integer>(int(N));
+		}
+	    };
+
+	    struct number {
+		static constexpr bool is_zero = false;
+		static constexpr bool is_one = false;
+		static constexpr bool is_minus_one = false;
+
+		double value;
+
+		constexpr double evaluate(const double*) const { return value; }
+
+		template <std::size_t I>
+		constexpr integer<0> derivative() const { return {}; }
+
+		node::base_node::ptr tree(const std::vector<std::string>&) const {
+		    return std::make_unique<node::number>(value);
+		}
+	    };
+
+	    template <std::size_t I>
+	    struct variable {
+		static constexpr bool is_zero = false;
+		static constexpr bool is_one = false;
+		static constexpr bool is_minus_one = false;
+
+		constexpr double evaluate(const double* values) const { return values[I]; }
+
+		template <std::size_t J>
+		constexpr integer<I == J ? 1 : 0> derivative() const { return {}; }
+
+		node::base_node::ptr tree(const std::vector<std::string>& names) const {
+		    return std::make_unique<node::variable>(names.at(I));
+		}
+	    };
+
+	    template <class... Terms>
+	    struct add {
+		static constexpr bool is_zero = false;
+		static constexpr bool is_one = false;
+		static constexpr bool is_minus_one = false;
+
+		std::tuple<Terms...> terms;
+
+		constexpr double evaluate(const double* values) const {
+		    return std::apply([values](const Terms&... term) {
+			    double sum = 0;
+			    ((sum += term.evaluate(values)), ...);
+			    return sum;
+			}, terms);
+		}
+
+		// The derivatives of the terms, leaving out those that are zero
+		template <std::size_t I>
+		constexpr auto derivative() const {
+		    return std::apply([](const Terms&... term) {
+			    return make_add(std::tuple_cat(nonzero(term.template derivative<I>())...));
+			}, terms);
+		}
+
+		node::base_node::ptr tree(const std::vector<std::string>& names) const {
+		    auto node = std::make_unique<node::add>();
+		    std::apply([&](const Terms&... term) { (node->append(term.tree(names)), ...); }, terms);
+		    return node;
+		}
+
+	    private:
+		template <class T>
+		static constexpr auto nonzero(const T& term) {
+		    if constexpr (T::is_zero) {
+			return std::tuple<>();
+		    }
+		    else {
+			return std::make_tuple(term);
+		    }
+		}
+	    };
+
+	    template <class... Factors>
+	    struct multiply {
+	    private:
+		static constexpr int minus_ones = (0 + ... + int(Factors::is_minus_one));
+		static constexpr bool ones = ((Factors::is_one || Factors::is_minus_one) && ...);
+	    public:
+		static constexpr bool is_zero = (false || ... || Factors::is_zero);
+		static constexpr bool is_one = ones && minus_ones % 2 == 0;
+		static constexpr bool is_minus_one = ones && minus_ones % 2 == 1;
+
+		std::tuple<Factors...> factors;
+
+		constexpr double evaluate(const double* values) const {
+		    return std::apply([values](const Factors&... factor) {
+			    double product = 1;
+			    ((product *= factor.evaluate(values)), ...);
+			    return product;
+			}, factors);
+		}
+
+		/**********************************//**
+		* A sum with one product per factor of
+		* nonzero derivative, with that factor
+		* replaced by its derivative and ones
+		* left out.
+		**************************************/
+		template <std::size_t I>
+		constexpr auto derivative() const {
+		    if constexpr (is_zero || is_one || is_minus_one) {
+			return integer<0>();
+		    }
+		    else {
+			return sum_of_products<I>(std::index_sequence_for<Factors...>());
+		    }
+		}
+
+		node::base_node::ptr tree(const std::vector<std::string>& names) const {
+		    auto node = std::make_unique<node::multiply>();
+		    std::apply([&](const Factors&... factor) { (node->append(factor.tree(names)), ...); }, factors);
+		    return node;
+		}
+
+	    private:
+		template <std::size_t I, std::size_t... K>
+		constexpr auto sum_of_products(std::index_sequence<K...> indices) const {
+		    return make_add(std::tuple_cat(product<I, K>(indices)...));
+		}
+
+		template <std::size_t I, std::size_t K, std::size_t... J>
+		constexpr auto product(std::index_sequence<J...>) const {
+		    typedef decltype(std::get<K>(factors).template derivative<I>()) prime;
+		    if constexpr (prime::is_zero) {
+			return std::tuple<>();
+		    }
+		    else {
+			return std::make_tuple(make_multiply(std::tuple_cat(factor<I, K, J>()...)));
+		    }
+		}
+
+		template <std::size_t I, std::size_t K, std::size_t J>
+		constexpr auto factor() const {
+		    if constexpr (J == K) {
+			auto prime = std::get<J>(factors).template derivative<I>();
+			if constexpr (decltype(prime)::is_one) {
+			    return std::tuple<>();
+			}
+			else {
+			    return std::make_tuple(prime);
+			}
+		    }
+		    else if constexpr (std::tuple_element_t<J, std::tuple<Factors...> >::is_one) {
+			return std::tuple<>();
+		    }
+		    else {
+			return std::make_tuple(std::get<J>(factors));
+		    }
+		}
+	    };
+
+	    template <class Base, class Exponent>
+	    struct power {
+		static constexpr bool is_zero = Base::is_zero;
+		static constexpr bool is_one = (Exponent::is_zero && !Base::is_zero) || Base::is_one;
+		static constexpr bool is_minus_one = Base::is_minus_one && (Exponent::is_one || Exponent::is_minus_one);
+
+		Base base;
+		Exponent exponent;
+
+		double evaluate(const double* values) const {
+		    return std::pow(base.evaluate(values), exponent.evaluate(values));
+		}
+
+		template <std::size_t I>
+		constexpr auto derivative() const {
+		    typedef decltype(base.template derivative<I>()) base_prime;
+		    typedef decltype(exponent.template derivative<I>()) exponent_prime;
+		    if constexpr (is_zero || is_one || is_minus_one || (base_prime::is_zero && exponent_prime::is_zero)) {
+			return integer<0>();
+		    }
+		    else if constexpr (exponent_prime::is_zero) {
+			// base^(exponent+-1)*exponent*base'
+			typedef power<Base, add<Exponent, integer<-1> > > lowered;
+			return multiply<lowered, Exponent, base_prime> {
+			    { lowered { base, { { exponent, {} } } }, exponent, base.template derivative<I>() }
+			};
+		    }
+		    else if constexpr (base_prime::is_zero) {
+			// base^exponent*Ln[base]*exponent'
+			return multiply<power, call<ln_function, Base>, exponent_prime> {
+			    { *this, { base }, exponent.template derivative<I>() }
+			};
+		    }
+		    else {
+			// base^exponent*(exponent*base'*base^-1+Ln[base]*exponent')
+			typedef multiply<Exponent, base_prime, power<Base, integer<-1> > > lhs;
+			typedef multiply<call<ln_function, Base>, exponent_prime> rhs;
+			return multiply<power, add<lhs, rhs> > {
+			    { *this, { { lhs { { exponent, base.template derivative<I>(), { base, {} } } },
+					 rhs { { { base }, exponent.template derivative<I>() } } } } }
+			};
+		    }
+		}
+
+		node::base_node::ptr tree(const std::vector<std::string>& names) const {
+		    auto node = std::make_unique<node::power>();
+		    node->append(base.tree(names));
+		    node->append(exponent.tree(names));
+		    return node;
+		}
+	    };
+
+	    /**********************************//**
+	    * Reports a function with no known
+	    * derivative, as function::derivative
+	    * throws for one.
+	    **************************************/
+	    template <class Function, class Argument>
+	    void derivative_rule(Function, const Argument&) {
+		static_assert(sizeof(Function) == 0, "Derivative not implemented for this function");
+	    }
+
+	    template <class Function, class Argument>
+	    struct call {
+		static constexpr bool is_zero = false;
+		static constexpr bool is_one = false;
+		static constexpr bool is_minus_one = false;
+
+		Argument argument;
+
+		double evaluate(const double* values) const {
+		    return Function::apply(argument.evaluate(values));
+		}
+
+		// The chain rule, merging products as function::derivative does
+		template <std::size_t I>
+		constexpr auto derivative() const {
+		    auto outer = derivative_rule(Function(), argument);
+		    auto inner = argument.template derivative<I>();
+		    typedef decltype(outer) outer_type;
+		    typedef decltype(inner) inner_type;
+		    if constexpr (inner_type::is_zero || outer_type::is_zero) {
+			return integer<0>();
+		    }
+		    else if constexpr (inner_type::is_one) {
+			return outer;
+		    }
+		    else if constexpr (outer_type::is_one) {
+			return inner;
+		    }
+		    else if constexpr (is_multiply<outer_type>::value && is_multiply<inner_type>::value) {
+			return make_multiply(std::tuple_cat(outer.factors, inner.factors));
+		    }
+		    else if constexpr (is_multiply<outer_type>::value) {
+			return make_multiply(std::tuple_cat(outer.factors, std::make_tuple(inner)));
+		    }
+		    else if constexpr (is_multiply<inner_type>::value) {
+			return make_multiply(std::tuple_cat(std::make_tuple(outer), inner.factors));
+		    }
+		    else {
+			return multiply<outer_type, inner_type> { { outer, inner } };
+		    }
+		}
+
+		node::base_node::ptr tree(const std::vector<std::string>& names) const {
+		    auto node = std::make_unique<node::function>(Function::name);
+		    node->append(argument.tree(names));
+		    return node;
+		}
+	    };
+
+	    template <class T> struct is_node : std::false_type {};
+	    template <long long N> struct is_node<integer<N> > : std::true_type {};
+	    template <> struct is_node<number> : std::true_type {};
+	    template <std::size_t I> struct is_node<variable<I> > : std::true_type {};
+	    template <class... Terms> struct is_node<add<Terms...> > : std::true_type {};
+	    template <class... Factors> struct is_node<multiply<Factors...> > : std::true_type {};
+	    template <class Base, class Exponent> struct is_node<power<Base, Exponent> > : std::true_type {};
+	    template <class Function, class Argument> struct is_node<call<Function, Argument> > : std::true_type {};
+
+	    /**********************************//**
+	    * The integer N, known to derivative<I>
+	    * to be zero or one where it is.
+	    **************************************/
+	    template <long long N>
+	    constexpr integer<N> literal {};
+
+	    /*****************************************************************************************//**
+	    * Operators, for any mix of nodes and plain numbers with at least one node. They build the
+	    * trees the parser builds for the same formula: sums and products are flattened, -a is
+	    * -1*a, a-b is a+-1*b, a/b is a*b^-1 and a^b is pow(a, b). Plain numbers become a number.
+	    *********************************************************************************************/
+	    template <class T>
+	    constexpr auto operand(const T& value) {
+		if constexpr (is_node<T>::value) {
+		    return value;
+		}
+		else {
+		    static_assert(std::is_arithmetic_v<T>, "Operands must be nodes or numbers");
+		    return number { double(value) };
+		}
+	    }
+
+	    template <class T>
+	    constexpr auto terms_of(const T& value) {
+		if constexpr (is_add<T>::value) {
+		    return value.terms;
+		}
+		else {
+		    return std::make_tuple(value);
+		}
+	    }
+
+	    template <class T>
+	    constexpr auto factors_of(const T& value) {
+		if constexpr (is_multiply<T>::value) {
+		    return value.factors;
+		}
+		else {
+		    return std::make_tuple(value);
+		}
+	    }
+
+	    template <class L, class R>
+	    using enable_operator = std::enable_if_t<is_node<L>::value || is_node<R>::value>;
+
+	    template <class L, class R, class = enable_operator<L, R> >
+	    constexpr auto operator+(const L& lhs, const R& rhs) {
+		return make_add(std::tuple_cat(terms_of(operand(lhs)), terms_of(operand(rhs))));
+	    }
+
+	    template <class L, class R, class = enable_operator<L, R> >
+	    constexpr auto operator*(const L& lhs, const R& rhs) {
+		return make_multiply(std::tuple_cat(factors_of(operand(lhs)), factors_of(operand(rhs))));
+	    }
+
+	    template <class T, class = std::enable_if_t<is_node<T>::value> >
+	    constexpr auto operator-(const T& value) {
+		return make_multiply(std::tuple_cat(std::make_tuple(literal<-1>), factors_of(value)));
+	    }
+
+	    template <class L, class R, class = enable_operator<L, R> >
+	    constexpr auto operator-(const L& lhs, const R& rhs) {
+		return operand(lhs) + -operand(rhs);
+	    }
+
+	    template <class L, class R, class = enable_operator<L, R> >
+	    constexpr auto pow(const L& base, const R& exponent) {
+		typedef decltype(operand(base)) base_type;
+		typedef decltype(operand(exponent)) exponent_type;
+		return power<base_type, exponent_type> { operand(base), operand(exponent) };
+	    }
+
+	    template <class L, class R, class = enable_operator<L, R> >
+	    constexpr auto operator/(const L& lhs, const R& rhs) {
+		return operand(lhs) * pow(operand(rhs), literal<-1>);
+	    }
+
+	    /**********************************//**
+	    * Evaluate with values[I] as variable I.
+	    **************************************/
+	    template <class T, class = std::enable_if_t<is_node<T>::value> >
+	    constexpr double evaluate(const T& formula, const double* values) {
+		return formula.evaluate(values);
+	    }
+
+	    template <class T, class... Values,
+		      class = std::enable_if_t<is_node<T>::value && (std::is_arithmetic_v<Values> && ...)> >
+	    constexpr double evaluate(const T& formula, Values... values) {
+		const double array[] = { double(values)..., 0.0 };
+		return formula.evaluate(array);
+	    }
+
+	    /**********************************//**
+	    * The derivative by variable I.
+	    **************************************/
+	    template <std::size_t I, class T, class = std::enable_if_t<is_node<T>::value> >
+	    constexpr auto derivative(const T& formula) {
+		return formula.template derivative<I>();
+	    }
+
+	    /*****************************************************************************************//**
+	    * The built in functions, each computing exactly what find_built_in's function of the same
+	    * name does, and with the derivative rule built_in_derivative has for it.
+	    *********************************************************************************************/
+#define GOLD_FIXED_FUNCTION(function_name, tag, expression)		\
+	    struct tag {						\
+		static constexpr const char* name = #function_name;	\
+		static double apply(double x) { return expression; }	\
+	    };								\
+	    template <class T, class = std::enable_if_t<is_node<T>::value> > \
+	    constexpr call<tag, T> function_name(const T& argument) {	\
+		return { argument };					\
+	    }
+
+	    GOLD_FIXED_FUNCTION(Sin, sin_function, std::sin(x))
+	    GOLD_FIXED_FUNCTION(Cos, cos_function, std::cos(x))
+	    GOLD_FIXED_FUNCTION(Tan, tan_function, std::tan(x))
+	    GOLD_FIXED_FUNCTION(Csc, csc_function, 1.0 / std::sin(x))
+	    GOLD_FIXED_FUNCTION(Sec, sec_function, 1.0 / std::cos(x))
+	    GOLD_FIXED_FUNCTION(Cot, cot_function, std::cos(x) / std::sin(x))
+	    GOLD_FIXED_FUNCTION(Arcsin, arcsin_function, std::asin(x))
+	    GOLD_FIXED_FUNCTION(Arccos, arccos_function, std::acos(x))
+	    GOLD_FIXED_FUNCTION(Arctan, arctan_function, std::atan(x))
+	    GOLD_FIXED_FUNCTION(Sinh, sinh_function, std::sinh(x))
+	    GOLD_FIXED_FUNCTION(Cosh, cosh_function, std::cosh(x))
+	    GOLD_FIXED_FUNCTION(Tanh, tanh_function, std::tanh(x))
+	    GOLD_FIXED_FUNCTION(Csch, csch_function, 1.0 / std::sinh(x))
+	    GOLD_FIXED_FUNCTION(Sech, sech_function, 1.0 / std::cosh(x))
+	    GOLD_FIXED_FUNCTION(Coth, coth_function, std::cosh(x) / std::sinh(x))
+	    GOLD_FIXED_FUNCTION(Arcsinh, arcsinh_function, std::asinh(x))
+	    GOLD_FIXED_FUNCTION(Arccosh, arccosh_function, std::acosh(x))
+	    GOLD_FIXED_FUNCTION(Arctanh, arctanh_function, std::atanh(x))
+	    GOLD_FIXED_FUNCTION(Exp, exp_function, std::exp(x))
+	    GOLD_FIXED_FUNCTION(Ln, ln_function, std::log(x))
+	    GOLD_FIXED_FUNCTION(Log, log_function, std::log10(x))
+	    GOLD_FIXED_FUNCTION(Abs, abs_function, std::fabs(x))
+	    GOLD_FIXED_FUNCTION(H, heaviside_function, (x < 0) ? 0.0 : 1.0)
+
+#undef GOLD_FIXED_FUNCTION
+
+	    // -1*1*factors..., which is how the parser reads a leading minus on a product
+	    template <class... Factors>
+	    constexpr multiply<integer<-1>, integer<1>, Factors...> negative_product(const Factors&... factors) {
+		return { { {}, {}, factors... } };
+	    }
+
+	    template <class T>
+	    constexpr power<T, integer<2> > squared(const T& value) {
+		return { value, {} };
+	    }
+
+	    template <class T>
+	    constexpr power<T, integer<-1> > reciprocal(const T& value) {
+		return { value, {} };
+	    }
+
+	    // x^(1/2), which parses as x^(2^(-1))
+	    template <class T>
+	    constexpr power<T, power<integer<2>, integer<-1> > > square_root(const T& value) {
+		return { value, {} };
+	    }
+
+	    template <class T>
+	    constexpr multiply<integer<-1>, T> negate(const T& value) {
+		return make_multiply(std::make_tuple(literal<-1>, value));
+	    }
+
+	    // argument+term, splicing in the terms of argument
+	    template <class T, class Term>
+	    constexpr auto sum(const T& argument, const Term& term) {
+		return make_add(std::tuple_cat(terms_of(argument), std::make_tuple(term)));
+	    }
+
+	    // 1-u^2
+	    template <class T>
+	    constexpr add<integer<1>, multiply<integer<-1>, power<T, integer<2> > > > one_minus_square(const T& u) {
+		return make_add(std::make_tuple(literal<1>, negate(squared(u))));
+	    }
+
+	    // 1+u^2
+	    template <class T>
+	    constexpr add<integer<1>, power<T, integer<2> > > one_plus_square(const T& u) {
+		return make_add(std::make_tuple(literal<1>, squared(u)));
+	    }
+
+	    template <class T>
+	    constexpr auto derivative_rule(sin_function, const T& u) { return Cos(u); }
+
+	    template <class T>
+	    constexpr auto derivative_rule(cos_function, const T& u) { return negative_product(Sin(u)); }
+
+	    template <class T>
+	    constexpr auto derivative_rule(tan_function, const T& u) { return squared(Sec(u)); }
+
+	    template <class T>
+	    constexpr auto derivative_rule(csc_function, const T& u) { return negative_product(Cot(u), Csc(u)); }
+
+	    template <class T>
+	    constexpr auto derivative_rule(sec_function, const T& u) {
+		return multiply<call<sec_function, T>, call<tan_function, T> > { { Sec(u), Tan(u) } };
+	    }
+
+	    template <class T>
+	    constexpr auto derivative_rule(cot_function, const T& u) { return negative_product(squared(Csc(u))); }
+
+	    // 1/(1-u^2)^(1/2)
+	    template <class T>
+	    constexpr auto derivative_rule(arcsin_function, const T& u) { return reciprocal(square_root(one_minus_square(u))); }
+
+	    // -1/(1-u^2)^(1/2)
+	    template <class T>
+	    constexpr auto derivative_rule(arccos_function, const T& u) {
+		return negative_product(reciprocal(square_root(one_minus_square(u))));
+	    }
+
+	    // 1/(1+u^2)
+	    template <class T>
+	    constexpr auto derivative_rule(arctan_function, const T& u) { return reciprocal(one_plus_square(u)); }
+
+	    template <class T>
+	    constexpr auto derivative_rule(sinh_function, const T& u) { return Cosh(u); }
+
+	    template <class T>
+	    constexpr auto derivative_rule(cosh_function, const T& u) { return Sinh(u); }
+
+	    template <class T>
+	    constexpr auto derivative_rule(tanh_function, const T& u) { return squared(Sech(u)); }
+
+	    template <class T>
+	    constexpr auto derivative_rule(csch_function, const T& u) { return negative_product(Coth(u), Csch(u)); }
+
+	    template <class T>
+	    constexpr auto derivative_rule(sech_function, const T& u) { return negative_product(Sech(u), Tanh(u)); }
+
+	    template <class T>
+	    constexpr auto derivative_rule(coth_function, const T& u) { return negative_product(squared(Csch(u))); }
+
+	    // 1/(1+u^2)^(1/2)
+	    template <class T>
+	    constexpr auto derivative_rule(arcsinh_function, const T& u) { return reciprocal(square_root(one_plus_square(u))); }
+
+	    // 1/((u-1)^(1/2)*(u+1)^(1/2))
+	    template <class T>
+	    constexpr auto derivative_rule(arccosh_function, const T& u) {
+		return make_multiply(std::make_tuple(literal<1>, reciprocal(square_root(sum(u, negate(literal<1>)))),
+						     reciprocal(square_root(sum(u, literal<1>)))));
+	    }
+
+	    // 1/(1-u^2)
+	    template <class T>
+	    constexpr auto derivative_rule(arctanh_function, const T& u) { return reciprocal(one_minus_square(u)); }
+
+	    template <class T>
+	    constexpr auto derivative_rule(exp_function, const T& u) { return Exp(u); }
+
+	    template <class T>
+	    constexpr auto derivative_rule(ln_function, const T& u) { return power<T, integer<-1> > { u, {} }; }
+
+	    // 1/(u*Ln[10])
+	    template <class T>
+	    constexpr auto derivative_rule(log_function, const T& u) {
+		typedef power<call<ln_function, integer<10> >, integer<-1> > ln_10;
+		return multiply<integer<1>, power<T, integer<-1> >, ln_10> { { {}, { u, {} }, { { {} }, {} } } };
+	    }
+	}
+    }
+}
+
+#endif
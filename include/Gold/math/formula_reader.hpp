@@ -0,0 +1,117 @@
+#ifndef GOLD_MATH_FORMULA_READER_HPP
+#define GOLD_MATH_FORMULA_READER_HPP
+
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Gold/math/expression.hpp"
+
+namespace Gold {
+    namespace math {
+
+	/*****************************************************************************************//**
+	* Reads a file holding one formula per line and parses each line as it goes. The file is
+	* read in fixed size chunks, so memory use depends on the chunk size and the longest line,
+	* not on the size of the file. Lines holding only whitespace are skipped; "\r\n" line endings
+	* are accepted.
+	*
+	* When pipelined, a background thread reads and parses the next chunk while the caller works
+	* through the current one. At most one parsed chunk waits ahead of the caller.
+	*********************************************************************************************/
+	class formula_reader {
+	public:
+	    /**********************************//**
+	    * One line of the file. When error is
+	    * not empty the line failed to parse
+	    * and value is undefined.
+	    *
+	    * line => 1 based line number.
+	    **************************************/
+	    struct record {
+		std::size_t line;
+		expression value;
+		std::string error;
+		bool ok() const { return error.empty(); }
+	    };
+
+	    class iterator {
+	    public:
+		typedef std::input_iterator_tag iterator_category;
+		typedef record value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef record* pointer;
+		typedef record& reference;
+
+		iterator() : reader(nullptr) { }
+		explicit iterator(formula_reader* _reader) : reader(_reader) { ++(*this); }
+		record& operator*() { return current; }
+		record* operator->() { return &current; }
+		iterator& operator++() {
+		    if (reader && !reader->next(current)) {
+			reader = nullptr;
+		    }
+		    return *this;
+		}
+		bool operator==(const iterator& other) const { return reader == other.reader; }
+		bool operator!=(const iterator& other) const { return reader != other.reader; }
+	    private:
+		formula_reader* reader;
+		record current;
+	    };
+
+	    /*****************************************************************************************//**
+	    * Open a formula file. Throws io_error if it cannot be opened.
+	    *
+	    * path       => The file to read.\n
+	    * chunk_size => How many bytes to read at a time.\n
+	    * pipelined  => Whether to read and parse ahead on a background thread.
+	    *********************************************************************************************/
+	    explicit formula_reader(const std::string& path, std::size_t chunk_size = std::size_t(1) << 16,
+				    bool pipelined = true);
+	    formula_reader(const formula_reader& other) = delete;
+	    formula_reader& operator=(const formula_reader& other) = delete;
+	    ~formula_reader();
+
+	    /**********************************//**
+	    * Move the next line into out. Returns
+	    * false once the file is exhausted.
+	    * Throws io_error if reading fails.
+	    **************************************/
+	    bool next(record& out);
+
+	    iterator begin() { return iterator(this); }
+	    iterator end() { return iterator(); }
+
+	private:
+	    bool fill(std::vector<record>& batch);
+	    void produce();
+
+	    std::FILE* file;
+	    std::vector<char> buffer;
+	    std::size_t chunk_size;
+	    std::size_t carried;
+	    std::size_t line_number;
+	    bool exhausted;
+
+	    std::vector<record> current;
+	    std::size_t position;
+
+	    bool pipelined;
+	    std::thread producer;
+	    std::mutex mutex;
+	    std::condition_variable changed;
+	    std::vector<record> pending;
+	    bool pending_ready;
+	    bool pending_last;
+	    bool stopping;
+	    std::exception_ptr error;
+	};
+    }
+}
+
+#endif
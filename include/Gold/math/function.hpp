@@ -1,6 +1,7 @@
 #ifndef GOLD_MATH_FUNCTION
 #define GOLD_MATH_FUNCTION
 
+#include <optional>
 #include "Gold/math/expression.hpp"
 #include "Gold/math/variable.hpp"
 
@@ -11,14 +12,18 @@ namespace Gold {
 	private:
 	    std::vector<variable> variables;
 	    expression rule;
+	    // rule compiled with its slots in the order of variables, on first evaluation
+	    std::optional<program> compiled;
 	public:
 	    function(const variable& var, const expression& expr) : variables(1,var), rule(expr) { } 
-	    function(const variable& var, expression&& expr) : variables(1,var), rule(expr) { }
-	    function(variable&& var, const expression&& expr) : variables(1,var), rule(expr) { }
-	    function(variable&& var, expression&& expr) : variables(1,var), rule(expr) { }
+	    function(const variable& var, expression&& expr) : variables(1,var), rule(std::move(expr)) { }
+	    function(variable&& var, const expression& expr) : rule(expr) { variables.push_back(std::move(var)); }
+	    function(variable&& var, expression&& expr) : rule(std::move(expr)) { variables.push_back(std::move(var)); }
 
 	    function(const std::vector<variable>& vars, const expression& expr) : variables(vars), rule(expr) { }
-	    function(const std::vector<variable>& vars, expression&& expr) : variables(vars), rule(expr) { }
+	    function(const std::vector<variable>& vars, expression&& expr) : variables(vars), rule(std::move(expr)) { }
+	    function(std::vector<variable>&& vars, const expression& expr) : variables(std::move(vars)), rule(expr) { }
+	    function(std::vector<variable>&& vars, expression&& expr) : variables(std::move(vars)), rule(std::move(expr)) { }
 
 	    virtual ~function() { //Intentially empty
 	    }
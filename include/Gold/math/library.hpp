@@ -0,0 +1,173 @@
+#ifndef GOLD_MATH_LIBRARY_HPP
+#define GOLD_MATH_LIBRARY_HPP
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "Gold/math/expression.hpp"
+#include "Gold/math/mapped_file.hpp"
+
+namespace Gold {
+    namespace math {
+
+	namespace image {
+
+	    /**********************************//**
+	    * A node of a flat tree. Children are
+	    * stored next to each other, after their
+	    * parent, and referred to by index.
+	    *
+	    * kind  => A node::node_kind.\n
+	    * arity => Number of children.\n
+	    * name  => Variables and functions: index
+	    *          into the string table.\n
+	    * first => Index of the first child.\n
+	    * slot  => Variables: slot within the
+	    *          expression. Functions: index
+	    *          into the function table.\n
+	    * value => Integers and numbers.
+	    **************************************/
+	    struct flat_node {
+		std::uint32_t kind;
+		std::uint32_t arity;
+		std::uint32_t name;
+		std::uint32_t first;
+		std::uint32_t slot;
+		std::uint32_t reserved;
+		double value;
+	    };
+
+	    /**********************************//**
+	    * An entry of the library. Its nodes are
+	    * [root, root + nodes) and its variables
+	    * are slots [first_slot, first_slot +
+	    * slot_count) of the slot table.
+	    **************************************/
+	    struct flat_expression {
+		std::uint32_t name;
+		std::uint32_t root;
+		std::uint32_t nodes;
+		std::uint32_t first_slot;
+		std::uint32_t slot_count;
+		std::uint32_t defined;
+	    };
+	}
+
+	/*****************************************************************************************//**
+	* Collects named expressions and lays them out as an expression image: a single block of
+	* memory holding flat nodes, a string table and an index sorted by name, with every
+	* reference stored as an index rather than a pointer. An image can be written to a file or
+	* shared memory once and then used in place by any number of processes, see
+	* expression_library. Images use the byte order and alignment of the machine that built
+	* them, so they are meant to be shared between processes on one host.
+	*********************************************************************************************/
+	class library_builder {
+	public:
+	    library_builder();
+
+	    /**********************************//**
+	    * Add expr under name. Throws
+	    * invalid_argument if name was added
+	    * before or expr is empty.
+	    **************************************/
+	    void add(const std::string& name, const expression& expr);
+
+	    std::size_t size() const { return expressions.size(); }
+
+	    std::string image() const;
+
+	    /**********************************//**
+	    * Write the image to path, replacing it
+	    * atomically. Throws io_error.
+	    **************************************/
+	    void write(const std::string& path) const;
+
+	private:
+	    std::uint32_t intern(const std::string& text);
+	    std::uint32_t intern_function(std::uint32_t name);
+
+	    std::vector<image::flat_node> nodes;
+	    std::vector<image::flat_expression> expressions;
+	    std::vector<std::uint32_t> slots;
+	    std::vector<std::uint32_t> functions;
+	    std::vector<std::string> strings;
+	    std::unordered_map<std::string, std::uint32_t> string_index;
+	    std::unordered_map<std::uint32_t, std::uint32_t> function_index;
+	    std::unordered_set<std::uint32_t> names;
+	};
+
+	/*****************************************************************************************//**
+	* Read only access to an expression image, evaluating straight from it. Nothing in the
+	* image is copied into per process trees; the only private state is a small table binding
+	* the image's function names to built in functions. Opening an image checks every index in
+	* it, so a damaged image is rejected up front and evaluation can trust it.
+	*
+	* Evaluation follows expression::evaluate and throws the same exceptions, except that
+	* missing variables are reported before anything is evaluated.
+	*********************************************************************************************/
+	class expression_library {
+	public:
+	    static constexpr std::size_t npos = std::size_t(-1);
+
+	    /**********************************//**
+	    * Map the image at path, shared with
+	    * every other process mapping it.
+	    **************************************/
+	    static expression_library open(const std::string& path);
+
+	    /**********************************//**
+	    * Use an image already in memory, such
+	    * as a shared memory segment. It must
+	    * be 8 byte aligned and outlive this.
+	    **************************************/
+	    static expression_library from_image(std::string_view image);
+
+	    expression_library(const expression_library& other) = delete;
+	    expression_library& operator=(const expression_library& other) = delete;
+
+	    std::size_t size() const { return count; }
+	    std::string_view name(std::size_t index) const;
+
+	    /**********************************//**
+	    * Index of the expression called name,
+	    * or npos.
+	    **************************************/
+	    std::size_t find(std::string_view name) const;
+
+	    double evaluate(std::size_t index, const std::map<std::string, double>& args = {}) const;
+
+	    /**********************************//**
+	    * Rebuild an ordinary expression, for
+	    * printing or differentiating.
+	    **************************************/
+	    expression materialize(std::size_t index) const;
+
+	private:
+	    expression_library(std::unique_ptr<mapped_file> file, std::string_view image);
+
+	    void load(std::string_view image);
+	    std::string_view string(std::uint32_t index) const;
+	    double evaluate_node(std::uint32_t index, const double* values) const;
+	    node::base_node::ptr build_node(std::uint32_t index) const;
+
+	    std::unique_ptr<mapped_file> file;
+	    const image::flat_node* nodes;
+	    const image::flat_expression* expressions;
+	    const std::uint32_t* slots;
+	    const std::uint32_t* functions;
+	    const std::uint32_t* string_offsets;
+	    const char* characters;
+	    std::size_t count;
+	    std::size_t string_count;
+	    std::vector<node::built_in_function> bound_functions;
+	};
+    }
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef GOLD_MATH_MAPPED_FILE_HPP
+#define GOLD_MATH_MAPPED_FILE_HPP
+
+#include <string>
+#include <string_view>
+
+namespace Gold {
+    namespace math {
+
+	/*****************************************************************************************//**
+	* A whole file mapped read only and shared, so every process mapping the same file shares
+	* one copy of its pages. The mapping stays valid if the file is replaced or removed.
+	*********************************************************************************************/
+	class mapped_file {
+	public:
+	    /**********************************//**
+	    * Map path. If required, throws io_error
+	    * when it cannot be opened; otherwise
+	    * the mapping is just empty.
+	    **************************************/
+	    explicit mapped_file(const std::string& path, bool required = true);
+	    mapped_file(const mapped_file& other) = delete;
+	    mapped_file& operator=(const mapped_file& other) = delete;
+	    ~mapped_file();
+
+	    const unsigned char* data() const { return bytes; }
+	    std::size_t size() const { return length; }
+	    std::string_view view() const { return std::string_view(reinterpret_cast<const char*>(bytes), length); }
+
+	private:
+	    const unsigned char* bytes;
+	    std::size_t length;
+	};
+    }
+}
+
+#endif
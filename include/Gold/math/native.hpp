@@ -0,0 +1,78 @@
+#ifndef GOLD_MATH_NATIVE_HPP
+#define GOLD_MATH_NATIVE_HPP
+
+#include <cstddef>
+#include <memory>
+#include "Gold/math/program.hpp"
+
+namespace Gold {
+    namespace math {
+
+	/*****************************************************************************************//**
+	* A program translated to x86-64 machine code at run time, with no external compiler. The
+	* code is written into pages of its own, which are made executable and read only before
+	* use, and calls pow and the built in functions directly. It does exactly the floating
+	* point operations the program does, in the same order, so results are bit for bit those
+	* of the program.
+	*
+	* Where native code is not available, because the machine is not x86-64 Linux or the
+	* system refuses executable memory, function() and batch() are null and evaluation falls
+	* back to the program's interpreter.
+	*********************************************************************************************/
+	class native_program {
+	public:
+	    typedef double (*scalar_function)(const double* values);
+	    typedef void (*batch_function)(const double* const* columns, std::size_t count, double* out);
+
+	    explicit native_program(program source);
+	    /**********************************//**
+	    * Takes other's code, leaving other with
+	    * no native code.
+	    **************************************/
+	    native_program(native_program&& other) noexcept;
+	    native_program& operator=(native_program&& other) noexcept;
+
+	    /**********************************//**
+	    * Whether this build can generate code
+	    * at all.
+	    **************************************/
+	    static bool supported();
+
+	    bool native() const { return scalar != nullptr; }
+
+	    /**********************************//**
+	    * The generated code, taking values as
+	    * program::evaluate does, or null. Valid
+	    * while this object lives.
+	    **************************************/
+	    scalar_function function() const { return scalar; }
+
+	    /**********************************//**
+	    * The generated code, taking columns as
+	    * program::evaluate_batch does, or null.
+	    * It does two rows at a time with packed
+	    * SSE2 arithmetic.
+	    **************************************/
+	    batch_function batch() const { return rows; }
+
+	    double evaluate(const double* values) const { return scalar ? scalar(values) : source.evaluate(values); }
+	    void evaluate_batch(const double* const* columns, std::size_t count, double* out) const;
+
+	    const program& compiled() const { return source; }
+
+	private:
+	    struct pages {
+		void* address;
+		std::size_t size;
+		~pages();
+	    };
+
+	    program source;
+	    std::unique_ptr<pages> code;
+	    scalar_function scalar;
+	    batch_function rows;
+	};
+    }
+}
+
+#endif
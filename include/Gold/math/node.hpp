@@ -3,12 +3,15 @@
 
 #include <algorithm>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <vector>
 #include <functional>
 #include <cmath>
 #include <map>
 #include <iostream>
+#include "Gold/math/node_pool.hpp"
+#include "Gold/math/result.hpp"
 
 namespace Gold {
     namespace math {
@@ -25,18 +28,45 @@ namespace Gold {
 	    class integer;
 	    class number;
 	    class variable;
+
+	    typedef double (*built_in_function)(double);
+
+	    /**********************************//**
+	    * The built in function called name, or
+	    * null if there is none.
+	    **************************************/
+	    built_in_function find_built_in(std::string_view name);
 	    
+	    /**********************************//**
+	    * The concrete shape of a node. Derived
+	    * nodes such as quotient report the kind
+	    * they are built on.
+	    **************************************/
+	    enum class node_kind {
+		add,
+		multiply,
+		power,
+		function,
+		integer,
+		number,
+		variable
+	    };
+
 	    class base_node {
 	    public:
 		typedef std::unique_ptr<base_node> ptr;
-		typedef std::vector<ptr> vec;
+		typedef std::vector<ptr, pool::allocator<ptr> > vec;
 		base_node() { //Intentionally empty
 		}
 		virtual base_node* clone() const=0;
 		virtual ~base_node() { //Intentionally empty
 		}
+		// The destructor is virtual, so size is that of the most derived node
+		static void* operator new(std::size_t size) { return pool::allocate(size); }
+		static void operator delete(void* memory, std::size_t size) noexcept { pool::deallocate(memory, size); }
 		virtual uint size() const { return 0; }
 		virtual std::string get_token() const=0;
+		virtual node_kind kind() const=0;
 		virtual bool is_zero() const { return false; }
 		virtual bool is_one() const { return false; }
 		virtual bool is_minus_one() const { return false; }
@@ -44,11 +74,22 @@ namespace Gold {
 		virtual bool is_leaf() const { return true; }
 		
 		virtual double evaluate(const std::map<std::string, double>& args = { }) const=0;
+
+		/**********************************//**
+		* Like evaluate, but reports failures
+		* as an error code instead of throwing.
+		**************************************/
+		virtual error_code try_evaluate(const std::map<std::string, double>& args, double& value) const=0;
 		
-		virtual ptr numerator() const;
-		virtual ptr denominator() const;
-		virtual ptr base() const;
-		virtual ptr exponent() const;
+		/**********************************//**
+		* Views of the parts of this node, which
+		* live as long as it does. Clone them
+		* where ownership is needed.
+		**************************************/
+		virtual const base_node& numerator() const;
+		virtual const base_node& denominator() const;
+		virtual const base_node& base() const;
+		virtual const base_node& exponent() const;
 		virtual std::string string() const=0;
 		virtual ptr derivative(const std::string& var) const=0;
 		virtual ptr change_variables(const std::map<std::string, ptr>& changes) const=0;
@@ -107,16 +148,18 @@ namespace Gold {
 		add() { //Intentionally empty
 		}
 		explicit add(const base_node::vec& _children) : operation(_children) { }
-		explicit add(base_node::vec&& _children) : operation(_children) { }
+		explicit add(base_node::vec&& _children) : operation(std::move(_children)) { }
 		explicit add(const add& other) : operation(other) { }
-		explicit add(add&& other) : operation(other) { }
+		explicit add(add&& other) : operation(std::move(other)) { }
 		add& operator=(const add& other) { operation::operator=(other); return *this;}
-		add& operator=(add&& other) { operation::operator=(other); return *this;}
+		add& operator=(add&& other) { operation::operator=(std::move(other)); return *this;}
 		virtual add* clone() const { return new add(*this); }
 		virtual ~add() { //Intentionally empty
 		}
 		virtual std::string get_token() const { return "+"; }
+		virtual node_kind kind() const { return node_kind::add; }
 		virtual double evaluate(const std::map<std::string, double>& args = { }) const;
+		virtual error_code try_evaluate(const std::map<std::string, double>& args, double& value) const;
 		virtual std::string string() const;
 		virtual base_node::ptr derivative(const std::string& var) const;
 		virtual base_node::ptr change_variables(const std::map<std::string, base_node::ptr>& changes) const;
@@ -128,11 +171,11 @@ namespace Gold {
 		multiply() { //Intentionally empty
 		}
 		explicit multiply(const base_node::vec& _children) : operation(_children) { }
-		explicit multiply(base_node::vec&& _children) : operation(_children) { }
+		explicit multiply(base_node::vec&& _children) : operation(std::move(_children)) { }
 		explicit multiply(const multiply& other) : operation(other) { }
-		explicit multiply(multiply&& other) : operation(other) { }
+		explicit multiply(multiply&& other) : operation(std::move(other)) { }
 		multiply& operator=(const multiply& other) { operation::operator=(other); return *this;}
-		multiply& operator=(multiply&& other) { operation::operator=(other); return *this;}
+		multiply& operator=(multiply&& other) { operation::operator=(std::move(other)); return *this;}
 		virtual multiply* clone() const { return new multiply(*this); }
 		virtual ~multiply() { //Intentionally empty
 		}
@@ -166,7 +209,9 @@ namespace Gold {
 		    return (negative_one_count & 1) == 1;
 		}    
 		virtual std::string get_token() const { return "*"; }
+		virtual node_kind kind() const { return node_kind::multiply; }
 		virtual double evaluate(const std::map<std::string, double>& args = { }) const;
+		virtual error_code try_evaluate(const std::map<std::string, double>& args, double& value) const;
 		virtual std::string string() const;
 		virtual base_node::ptr derivative(const std::string& var) const;
 		virtual base_node::ptr change_variables(const std::map<std::string, base_node::ptr>& changes) const;
@@ -178,63 +223,85 @@ namespace Gold {
 		power() { //Intentionally empty
 		}
 		explicit power(const base_node& base, const base_node& exponent);
+		explicit power(base_node::ptr base, base_node::ptr exponent);
 		explicit power(const power& other) : operation(other) { }
-		explicit power(power&& other) : operation(other) { }
+		explicit power(power&& other) : operation(std::move(other)) { }
 		power& operator=(const power& other) { operation::operator=(other); return *this;}
-		power& operator=(power&& other) { operation::operator=(other); return *this;}
+		power& operator=(power&& other) { operation::operator=(std::move(other)); return *this;}
 		virtual power* clone() const { return new power(*this); }
 		virtual ~power() { //Intentionally empty
 		}
-		virtual bool is_zero() const { return this->base()->is_zero(); }
+		virtual bool is_zero() const { return this->base().is_zero(); }
 		virtual bool is_one() const { 
-		    auto base = this->base();
-		    auto expo = this->exponent();
-		    return (expo->is_zero() && !base->is_zero()) || base->is_one();
+		    const base_node& base = this->base();
+		    const base_node& expo = this->exponent();
+		    return (expo.is_zero() && !base.is_zero()) || base.is_one();
 		}
 		virtual bool is_minus_one() const {
-		    auto exponent = this->exponent();
-		    return this->base()->is_minus_one() && ( exponent->is_one() || exponent->is_minus_one() );
+		    const base_node& exponent = this->exponent();
+		    return this->base().is_minus_one() && ( exponent.is_one() || exponent.is_minus_one() );
 		}
 		virtual bool is_undefined() const { 
-		    auto exponent = this->exponent();
+		    const base_node& exponent = this->exponent();
 		    return operation::is_undefined() || 
-			( this->base()->is_zero() && (exponent->is_zero() || exponent->is_minus_one())) ;
+			( this->base().is_zero() && (exponent.is_zero() || exponent.is_minus_one())) ;
 		}
 		virtual std::string get_token() const { return "^"; }
-		virtual base_node::ptr base() const;
-		virtual base_node::ptr exponent() const; 
+		virtual node_kind kind() const { return node_kind::power; }
+		virtual const base_node& base() const;
+		virtual const base_node& exponent() const; 
 		virtual double evaluate(const std::map<std::string, double>& args = { }) const;
+		virtual error_code try_evaluate(const std::map<std::string, double>& args, double& value) const;
 		virtual std::string string() const;
 		virtual base_node::ptr derivative(const std::string& var) const;
 		virtual base_node::ptr change_variables(const std::map<std::string, base_node::ptr>& changes) const;
 	    };
 	    
+	    /*****************************************************************************************//**
+	    * A call. The built in function is looked up once, when the name is set, so evaluation
+	    * does no string work. Nodes may be built with names that are not built in, for printing
+	    * and rewriting, but evaluating them throws. The parser rejects such names outright.
+	    *********************************************************************************************/
 	    class function : public operation {
 	    private:
 		std::string token;
+		built_in_function kernel = nullptr;
 	    public:
 		typedef std::unique_ptr<function> ptr;
 		function() { //Intentionally empty
 		}
-		function(const std::string& _token, const base_node::vec& _children={}) : operation(_children), token(_token) { }
-		function(const std::string& _token, base_node::vec&& _children) : operation(_children), token(_token) { }
-		function(const function& other) : operation(other) {token = other.token; }
-		function(function&& other) : operation(other) { token = other.token; }
+		function(std::string _token, const base_node::vec& _children={}) :
+		    operation(_children), token(std::move(_token)), kernel(find_built_in(token)) { }
+		function(std::string _token, base_node::vec&& _children) :
+		    operation(std::move(_children)), token(std::move(_token)), kernel(find_built_in(token)) { }
+		function(const function& other) : operation(other), token(other.token), kernel(other.kernel) { }
+		function(function&& other) : operation(std::move(other)), token(std::move(other.token)), kernel(other.kernel) { }
 		function& operator=(const function& other) { 
 		    operation::operator=(other);
 		    token = other.token;
+		    kernel = other.kernel;
 		    return *this;
 		}
 		function& operator=(function&& other) { 
-		    operation::operator=(other); 
-		    token = other.token;
+		    operation::operator=(std::move(other)); 
+		    token = std::move(other.token);
+		    kernel = other.kernel;
 		    return *this;
 		}
 		virtual function* clone() const { return new function(*this); }
 		virtual ~function() { //Intentionally empty
 		}
 		virtual std::string get_token() const { return token; }
+		virtual node_kind kind() const { return node_kind::function; }
+		const std::string& name() const { return token; }
+
+		/**********************************//**
+		* The built in function called name(),
+		* or null.
+		**************************************/
+		built_in_function implementation() const { return kernel; }
 		virtual double evaluate(const std::map<std::string, double>& args = { }) const;
+		virtual error_code try_evaluate(const std::map<std::string, double>& args, double& value) const;
 		virtual std::string string() const;
 		virtual base_node::ptr derivative(const std::string& var) const;
 		virtual base_node::ptr change_variables(const std::map<std::string, base_node::ptr>& changes) const;
@@ -255,7 +322,13 @@ namespace Gold {
 		virtual bool is_minus_one() const { return token == -1; }
 		virtual bool is_undefined() const { return false; }
 		virtual std::string get_token() const { return std::to_string(token); }
+		virtual node_kind kind() const { return node_kind::integer; }
+		int value() const { return token; }
 		virtual double evaluate(const std::map<std::string, double>& /*args*/ = { }) const;
+		virtual error_code try_evaluate(const std::map<std::string, double>& /*args*/, double& value) const {
+		    value = token;
+		    return error_code::none;
+		}
 		virtual std::string string() const { return this->get_token(); }
 		virtual base_node::ptr derivative(const std::string& var) const { return std::make_unique<integer>(0); }
 		virtual base_node::ptr change_variables(const std::map<std::string, base_node::ptr>& changes) const { 
@@ -270,15 +343,21 @@ namespace Gold {
 		typedef std::unique_ptr<number> ptr;
 		number() { //Intentionally empty
 		}
-		explicit number(const std::string& _token) : token(std::stof(_token)) { }
+		explicit number(const std::string& _token);
 		explicit number(double _token = 0) : token(_token) { }
 		virtual number* clone() const { return new number(*this); }
 		virtual bool is_zero() const { return token == 0; }
 		virtual bool is_one() const { return token == 1; }
 		virtual bool is_minus_one() const { return token == -1; }
 		virtual bool is_undefined() const { return false; }
-		virtual std::string get_token() const { return std::to_string(token); }
+		virtual std::string get_token() const;
+		virtual node_kind kind() const { return node_kind::number; }
+		double value() const { return token; }
 		virtual double evaluate(const std::map<std::string, double>& /*args*/ = { }) const;
+		virtual error_code try_evaluate(const std::map<std::string, double>& /*args*/, double& value) const {
+		    value = token;
+		    return error_code::none;
+		}
 		virtual std::string string() const { return this->get_token(); }
 		virtual base_node::ptr derivative(const std::string& var) const { return std::make_unique<integer>(0); }
 		virtual base_node::ptr change_variables(const std::map<std::string, base_node::ptr>& changes) const { 
@@ -293,11 +372,14 @@ namespace Gold {
 		typedef std::unique_ptr<variable> ptr;
 		variable() { //Intentionally empty
 		}
-		explicit variable(const std::string& _token) : token(_token) { }
+		explicit variable(std::string _token) : token(std::move(_token)) { }
 		virtual variable* clone() const { return new variable(*this); }
 		virtual bool is_undefined() const { return false; }
 		virtual std::string get_token() const { return token; }
+		virtual node_kind kind() const { return node_kind::variable; }
+		const std::string& name() const { return token; }
 		virtual double evaluate(const std::map<std::string, double>& args = { }) const;
+		virtual error_code try_evaluate(const std::map<std::string, double>& args, double& value) const;
 		virtual std::string string() const { return this->get_token(); }
 		virtual base_node::ptr derivative(const std::string& var) const { 
 		    if (get_token() == var) { 
@@ -316,25 +398,26 @@ namespace Gold {
 		inverse() { //Intentionally empty
 		}
 		inverse(const inverse& other) : power(other) { }
-		inverse(inverse&& other) : power(other) { }
+		inverse(inverse&& other) : power(std::move(other)) { }
 		inverse& operator=(const inverse& other) { 
 		    power::operator=(other);
 		    return *this;
 		}
 		inverse& operator=(inverse&& other) { 
-		    power::operator=(other); 
+		    power::operator=(std::move(other)); 
 		    return *this;
 		}
 		virtual inverse* clone() const { return new inverse(*this); }
 		virtual ~inverse() { //Intentionally empty
 		}
-		virtual bool is_one() const { return this->denominator()->is_one(); }
+		virtual bool is_one() const { return this->denominator().is_one(); }
 		virtual bool is_zero() const { return false; }
-		virtual bool is_minus_one() const { return this->denominator()->is_minus_one(); }
-		virtual bool is_undefined() const { return this->denominator()->is_zero(); }
-		virtual base_node::ptr numerator() const { return std::make_unique<integer>(1); }
-		virtual base_node::ptr denominator() const;
+		virtual bool is_minus_one() const { return this->denominator().is_minus_one(); }
+		virtual bool is_undefined() const { return this->denominator().is_zero(); }
+		virtual const base_node& numerator() const;
+		virtual const base_node& denominator() const;
 		static ptr make_inverse(const base_node& other);
+		static ptr make_inverse(base_node::ptr other);
 	    };
 
 	    class quotient : public multiply {
@@ -343,14 +426,15 @@ namespace Gold {
 		quotient() { //Intentionally empty
 		}
 		quotient(const base_node& numerator, const base_node& denominator);
+		quotient(base_node::ptr numerator, base_node::ptr denominator);
 		quotient(const quotient& other) : multiply(other) { }
-		quotient(quotient&& other) : multiply(other) { }
+		quotient(quotient&& other) : multiply(std::move(other)) { }
 		quotient& operator=(const quotient& other) { 
 		    multiply::operator=(other);
 		    return *this;
 		}
 		quotient& operator=(quotient&& other) { 
-		    multiply::operator=(other); 
+		    multiply::operator=(std::move(other)); 
 		    return *this;
 		}
 		virtual quotient* clone() const { return new quotient(*this); }
@@ -358,20 +442,20 @@ namespace Gold {
 		}
 		
 		virtual bool is_one() {
-		    auto numerator = this->numerator();
-		    auto denominator = this->denominator();
-		    return (denominator->is_one() && numerator->is_one()) || (denominator->is_minus_one() && numerator->is_minus_one());
+		    const base_node& numerator = this->numerator();
+		    const base_node& denominator = this->denominator();
+		    return (denominator.is_one() && numerator.is_one()) || (denominator.is_minus_one() && numerator.is_minus_one());
 		}
 		
 		virtual bool is_minus_one() { 
-		    auto numerator = this->numerator();
-		    auto denominator = this->denominator();
-		    return (denominator->is_one() && numerator->is_minus_one()) || (denominator->is_minus_one() && numerator->is_one());
+		    const base_node& numerator = this->numerator();
+		    const base_node& denominator = this->denominator();
+		    return (denominator.is_one() && numerator.is_minus_one()) || (denominator.is_minus_one() && numerator.is_one());
 		}
 
-		virtual bool is_undefined() { return this->denominator()->is_zero(); }
-		virtual base_node::ptr numerator() const;
-		virtual base_node::ptr denominator() const;
+		virtual bool is_undefined() { return this->denominator().is_zero(); }
+		virtual const base_node& numerator() const;
+		virtual const base_node& denominator() const;
 	    };
 
 	    class rational : public quotient {
@@ -382,7 +466,7 @@ namespace Gold {
 		rational(const integer& numerator, const integer& denominator) : quotient(numerator, denominator) { }
 		rational(int numerator, int denominator);
 		rational(const rational& other) : quotient(other) { }
-		rational(rational&& other) : quotient(other) { }
+		rational(rational&& other) : quotient(std::move(other)) { }
 		virtual ~rational() { //Intentionally empty
 		}
 		rational& operator=(const rational& other) { 
@@ -390,7 +474,7 @@ namespace Gold {
 		    return *this;
 		}
 		rational& operator=(rational&& other) { 
-		    quotient::operator=(other); 
+		    quotient::operator=(std::move(other)); 
 		    return *this;
 		}
 		virtual rational* clone() const { return new rational(*this); }
@@ -399,35 +483,15 @@ namespace Gold {
 
 	    base_node::ptr make_leaf_node(const std::string& str);
 	    base_node::ptr make_function_node(const std::string& str);
-	    base_node::ptr make_tree(std::string str);
+	    base_node::ptr make_tree(std::string_view str);
 
-	    const std::map<std::string, std::function<double(double)> > built_in_functions = {
-		{"Sin", sin},
-		{"Cos", cos},
-		{"Tan", tan},
-		{"Csc", [](double x) { return 1.0/sin(x); }},
-		{"Sec", [](double x) { return 1.0/cos(x); }},
-		{"Cot", [](double x) { return cos(x)/sin(x); }},
-		{"Arcsin", asin},
-		{"Arccos", acos},
-		{"Arctan", atan},
-		{"Sinh", sinh},
-		{"Cosh", cosh},
-		{"Tanh", tanh},
-		{"Csch", [](double x) { return 1.0/sin(x); }},
-		{"Sech", [](double x) { return 1.0/cos(x); }},
-		{"Coth", [](double x) { return cosh(x)/sinh(x); }},
-		{"Arcsinh", asinh},
-		{"Arccosh", acosh},
-		{"Arctanh", atanh},
-		{"Exp", exp},
-		{"Ln", log},
-		{"Log", log10},
-		{"Abs", abs},
-		{"H", [](double x) { return (x < 0) ? 0.0 : 1.0; }}
-	    };
-	    
-	    extern const std::map<std::string, base_node::ptr> built_in_derivatives;	
+	    /**********************************//**
+	    * The derivative of the built in function
+	    * name at argument, built directly around
+	    * a copy of argument. Null when name has
+	    * no known derivative.
+	    **************************************/
+	    base_node::ptr built_in_derivative(std::string_view name, const base_node& argument);
 
 	}
     }
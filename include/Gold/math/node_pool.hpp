@@ -0,0 +1,80 @@
+#ifndef GOLD_MATH_NODE_POOL_HPP
+#define GOLD_MATH_NODE_POOL_HPP
+
+#include <cstddef>
+
+namespace Gold {
+    namespace math {
+	namespace node {
+
+	    /*****************************************************************************************//**
+	    * Memory for nodes and child arrays. Blocks of each size are carved one after another out
+	    * of 64 KiB chunks, so a tree built in one go lies in a few contiguous runs of memory, and
+	    * freed blocks go back onto their chunk's free list, to be reused by the next node of that
+	    * size without locking or calling malloc. This suits the short lived temporaries that
+	    * derivative and change_variables build and throw away.
+	    *
+	    * Each chunk belongs to the thread that carved it. A block freed on another thread, as the
+	    * trees parse_batch builds on a pool usually are, is handed back to the owning thread,
+	    * which reuses it on its next allocation of that size. Chunks whose blocks are all free are
+	    * kept for blocks of any size, up to 8 MiB per thread, and beyond that are returned to the
+	    * system. A thread that exits passes the chunks still in use on to the next thread to
+	    * start. Blocks larger than max_block come from operator new.
+	    *
+	    * The pool is off unless a program turns it on with set_mode before it builds its first
+	    * node; until then, and in the Node addon, nodes come from plain operator new.
+	    *********************************************************************************************/
+	    namespace pool {
+		constexpr std::size_t max_block = 256;
+
+		enum class mode {
+		    system,
+		    pooled
+		};
+
+		/**********************************//**
+		* Chooses where nodes come from. The
+		* mode is settled by the first node
+		* allocated, or the first call to this
+		* or current_mode, and cannot change
+		* after. Returns whether requested is
+		* the mode in force.
+		**************************************/
+		bool set_mode(mode requested);
+		mode current_mode();
+
+		void* allocate(std::size_t size);
+		void deallocate(void* memory, std::size_t size) noexcept;
+
+		/**********************************//**
+		* Bytes held in chunks by all threads,
+		* whether in use or not.
+		**************************************/
+		std::size_t reserved();
+
+		/**********************************//**
+		* Allocator for containers of nodes, such
+		* as the child arrays of operations.
+		**************************************/
+		template <typename T>
+		struct allocator {
+		    typedef T value_type;
+
+		    allocator() noexcept { }
+		    template <typename U>
+		    allocator(const allocator<U>&) noexcept { }
+
+		    T* allocate(std::size_t count) { return static_cast<T*>(pool::allocate(count * sizeof(T))); }
+		    void deallocate(T* memory, std::size_t count) noexcept { pool::deallocate(memory, count * sizeof(T)); }
+
+		    template <typename U>
+		    bool operator==(const allocator<U>&) const noexcept { return true; }
+		    template <typename U>
+		    bool operator!=(const allocator<U>&) const noexcept { return false; }
+		};
+	    }
+	}
+    }
+}
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef GOLD_MATH_PARSE_CACHE_HPP
+#define GOLD_MATH_PARSE_CACHE_HPP
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "Gold/math/expression.hpp"
+
+namespace Gold {
+    namespace math {
+
+	/*****************************************************************************************//**
+	* An opt-in cache from source text to parsed expressions. Sources are normalized by dropping
+	* whitespace that does not separate two tokens, so "x + 1" and "x+1" share an entry. Entries
+	* are immutable and handed out as shared handles; once the cache grows past its capacity the
+	* least recently used entries are dropped. Handles keep their expression alive after it is
+	* evicted. All members are safe to call from several threads at once.
+	*********************************************************************************************/
+	class parse_cache {
+	public:
+	    typedef std::shared_ptr<const expression> handle;
+
+	    /**********************************//**
+	    * Counters since construction or the
+	    * last clear. bytes is an estimate of
+	    * the memory held by the entries.
+	    **************************************/
+	    struct statistics {
+		std::size_t hits;
+		std::size_t misses;
+		std::size_t evictions;
+		std::size_t entries;
+		std::size_t bytes;
+	    };
+
+	    explicit parse_cache(std::size_t capacity = std::size_t(64) << 20);
+	    parse_cache(const parse_cache& other) = delete;
+	    parse_cache& operator=(const parse_cache& other) = delete;
+
+	    /*****************************************************************************************//**
+	    * Look up source, parsing it on a miss. Parse errors are thrown exactly as the expression
+	    * constructor throws them and nothing is cached for the source.
+	    *
+	    * Return value: A handle to the parsed expression. It is shared with other callers, so it
+	    *               is only ever const; copy it to get an expression of your own.
+	    *********************************************************************************************/
+	    handle get(std::string_view source);
+
+	    /**********************************//**
+	    * Same as get, but returns a private
+	    * copy of the expression.
+	    **************************************/
+	    expression parse(std::string_view source) { return *get(source); }
+
+	    statistics stats() const;
+	    std::size_t capacity() const;
+
+	    /**********************************//**
+	    * Change the memory cap, evicting
+	    * entries if it shrank.
+	    **************************************/
+	    void set_capacity(std::size_t capacity);
+
+	    void clear();
+
+	    /**********************************//**
+	    * The key a source is cached under.
+	    **************************************/
+	    static std::string normalize(std::string_view source);
+
+	private:
+	    struct entry {
+		std::string key;
+		handle value;
+		std::size_t bytes;
+	    };
+
+	    void evict();
+
+	    mutable std::mutex mutex;
+	    std::list<entry> entries;
+	    std::unordered_map<std::string_view, std::list<entry>::iterator> index;
+	    std::size_t max_bytes;
+	    statistics counters;
+	};
+    }
+}
+
+#endif
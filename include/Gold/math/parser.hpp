@@ -0,0 +1,147 @@
+#ifndef GOLD_MATH_PARSER_HPP
+#define GOLD_MATH_PARSER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Gold/math/node.hpp"
+#include "Gold/math/result.hpp"
+
+namespace Gold {
+    namespace math {
+	namespace parser {
+
+	    enum class token_type {
+		number,
+		identifier,
+		plus,
+		minus,
+		times,
+		divide,
+		caret,
+		open_paren,
+		close_paren,
+		open_bracket,
+		close_bracket,
+		comma,
+		end
+	    };
+
+	    /**********************************//**
+	    * A single lexeme of an expression. Tokens
+	    * refer back into the source string instead
+	    * of owning a copy of their text.
+	    *
+	    * match          => For brackets, the index of the matching bracket token.\n
+	    * additive       => For '(', whether the group has a binary + or - outside any nested group.\n
+	    * multiplicative => For '(', whether the group has a * or / outside any nested group.
+	    **************************************/
+	    struct token {
+		token_type type;
+		std::size_t begin;
+		std::size_t length;
+		std::size_t match;
+		bool additive;
+		bool multiplicative;
+	    };
+
+	    /*****************************************************************************************//**
+	    * Split an expression into tokens in a single pass. Whitespace is skipped and brackets are
+	    * matched as they are read, so the parser never needs to rescan the string.
+	    *
+	    * str    => The expression to tokenize. It does not need to be null terminated.\n
+	    * tokens => Where to store the tokens. It is cleared first, so its capacity can be reused.
+	    *
+	    * The tokens are always terminated by a token of type end. Throws invalid_expression on
+	    * mismatched brackets or unknown characters.
+	    *********************************************************************************************/
+	    void tokenize(std::string_view str, std::vector<token>& tokens);
+
+	    /**********************************//**
+	    * Same as tokenize, but reports errors
+	    * in failure and returns false instead
+	    * of throwing.
+	    **************************************/
+	    bool tokenize(std::string_view str, std::vector<token>& tokens, error_info& failure);
+
+	    std::vector<token> tokenize(std::string_view str);
+
+	    /*****************************************************************************************//**
+	    * Precedence climbing parser over the output of tokenize. Sums and products are gathered
+	    * into flat add and multiply nodes, subtraction and division are folded into their operands
+	    * the same way utils::break_string does, and ^ is right associative. Every token is visited
+	    * once, so parsing is linear in the length of the input.
+	    *********************************************************************************************/
+	    class tree_parser {
+	    public:
+		explicit tree_parser(std::string_view str);
+		tree_parser(std::string_view str, std::vector<token>& buffer);
+
+		/**********************************//**
+		* Does not throw. If str cannot be
+		* tokenized the error is stored in
+		* failure and check will fail.
+		**************************************/
+		tree_parser(std::string_view str, std::vector<token>& buffer, error_info& failure);
+		tree_parser(const tree_parser& other) = delete;
+		tree_parser& operator=(const tree_parser& other) = delete;
+		node::base_node::ptr parse();
+
+		/**********************************//**
+		* Parse, also storing in groups, at the
+		* index of each '(' or '[' token, the node
+		* built from exactly that group, or null
+		* when the group was spliced into its
+		* surroundings.
+		**************************************/
+		node::base_node::ptr parse(std::vector<node::base_node*>& groups);
+
+		/*****************************************************************************************//**
+		* Walk the tokens following exactly the same rules as parse, without building any nodes or
+		* throwing. If this returns true, parse will not throw except for running out of memory.
+		* Otherwise failure holds the first error parse would have thrown.
+		*********************************************************************************************/
+		bool check(error_info& failure);
+
+	    private:
+		node::base_node::ptr parse_expression();
+		void parse_sum(node::base_node::vec& terms, bool negate);
+		void parse_sum_operand(node::base_node::vec& terms, bool negate);
+		bool parse_product(node::base_node::vec& factors, bool invert);
+		void parse_product_operand(node::base_node::vec& factors, bool invert);
+		node::base_node::ptr parse_factor();
+		node::base_node::ptr parse_exponent();
+		node::base_node::ptr parse_primary();
+		node::base_node::ptr parse_function();
+		node::base_node::ptr make_literal(const token& tok, bool negative) const;
+
+		bool check_sum();
+		bool check_sum_operand();
+		bool check_product();
+		bool check_product_operand();
+		bool check_factor();
+		bool check_exponent();
+		bool check_primary();
+		bool check_function();
+		bool check_literal(const token& tok, bool negative);
+		bool check_expect(token_type type);
+		bool fail_unexpected();
+
+		bool is_negative_literal(bool (*boundary)(token_type)) const;
+		const token& peek(std::size_t offset = 0) const { return tokens[position + offset]; }
+		const token& advance() { return tokens[position++]; }
+		void expect(token_type type);
+		[[noreturn]] void unexpected() const;
+
+		std::string_view source;
+		std::vector<token> owned_tokens;
+		std::vector<token>& tokens;
+		std::size_t position;
+		std::vector<node::base_node*>* groups;
+		error_info failure;
+	    };
+	}
+    }
+}
+
+#endif
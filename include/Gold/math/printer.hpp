@@ -0,0 +1,26 @@
+#ifndef GOLD_MATH_PRINTER_HPP
+#define GOLD_MATH_PRINTER_HPP
+
+#include <ostream>
+#include <string>
+#include "Gold/math/node.hpp"
+
+namespace Gold {
+    namespace math {
+	namespace node {
+
+	    /*****************************************************************************************//**
+	    * Print a tree in the same form as base_node::string, appending to out. Where parentheses
+	    * go is worked out from the kind of each node and the operators its printed form would
+	    * contain at the top level, which one pass over the tree finds for every node before
+	    * anything is written. Printing is linear in the size of the output and writes straight
+	    * into out without building any intermediate strings.
+	    *********************************************************************************************/
+	    void print(const base_node& tree, std::string& out);
+
+	    void print(const base_node& tree, std::ostream& out);
+	}
+    }
+}
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef GOLD_MATH_PROGRAM_HPP
+#define GOLD_MATH_PROGRAM_HPP
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "Gold/math/node.hpp"
+#include "Gold/math/thread_pool.hpp"
+
+namespace Gold {
+    namespace math {
+
+	/*****************************************************************************************//**
+	* A node tree compiled for fast repeated evaluation. Nodes become instructions for a small
+	* stack machine, in post-order, so evaluation is a single loop with no recursion, virtual
+	* calls or allocation. Literals are pooled into a constant table, variables are resolved to
+	* slots and functions to their built in implementations, all at compile time.
+	*
+	* Every operation is done in the same order as node evaluation does it, so a program gives
+	* bit for bit the same result as evaluating the tree it was compiled from.
+	*
+	* Programs are immutable once built. Every const member may be called from any number of
+	* threads at once, with no locking, which is what the parallel overloads below rely on.
+	*********************************************************************************************/
+	class program {
+	public:
+	    enum class opcode : std::uint8_t {
+		constant,
+		variable,
+		add_zero,
+		add,
+		add_constant,
+		add_variable,
+		multiply,
+		multiply_constant,
+		multiply_variable,
+		power,
+		power_constant,
+		call
+	    };
+
+	    /**********************************//**
+	    * operand => Index into the constant,
+	    *            slot or function table,
+	    *            depending on the opcode.
+	    **************************************/
+	    struct instruction {
+		opcode op;
+		std::uint32_t operand;
+	    };
+
+	    /*****************************************************************************************//**
+	    * Compile root. Throws the exceptions evaluating root would throw whatever the arguments:
+	    * undefined_expression if it is undefined, invalid_node for malformed nodes and
+	    * invalid_argument for functions that are not built in.
+	    *********************************************************************************************/
+	    explicit program(const node::base_node& root);
+
+	    /**********************************//**
+	    * Evaluate with variables looked up by
+	    * name, once each. Throws
+	    * invalid_argument if one is missing.
+	    **************************************/
+	    double evaluate(const std::map<std::string, double>& args = {}) const;
+
+	    /**********************************//**
+	    * Evaluate with values[i] as the value
+	    * of variables()[i].
+	    **************************************/
+	    double evaluate(const double* values) const;
+
+	    /**********************************//**
+	    * Same, but throws length_error unless
+	    * count is variables().size().
+	    **************************************/
+	    double evaluate(const double* values, std::size_t count) const;
+	    double evaluate(const std::vector<double>& values) const { return evaluate(values.data(), values.size()); }
+
+	    /*****************************************************************************************//**
+	    * Evaluate over many rows at once, one column per variable. Rows are processed in tiles
+	    * small enough to stay in L1, each instruction running over a whole tile, so the cost of
+	    * decoding instructions is shared by the tile and the arithmetic runs in vector kernels
+	    * chosen for the CPU at load time. Results are bit for bit those of evaluate.
+	    *
+	    * columns => columns[i] points at count values of variables()[i]. Columns of variables
+	    *            the program does not read may be null.\n
+	    * count   => The number of rows.\n
+	    * out     => Receives count results.
+	    *********************************************************************************************/
+	    void evaluate_batch(const double* const* columns, std::size_t count, double* out) const;
+
+	    /*****************************************************************************************//**
+	    * Same, with the rows split into chunks of about chunk rows evaluated on the threads of
+	    * pool, each writing straight into its part of out. Every row is computed exactly as
+	    * evaluate would, so results do not depend on the pool or the chunk size. A chunk of 0
+	    * picks one from count and the size of the pool.
+	    *********************************************************************************************/
+	    void evaluate_batch(const double* const* columns, std::size_t count, double* out,
+				thread_pool& pool, std::size_t chunk = 0) const;
+
+	    /*****************************************************************************************//**
+	    * Evaluate at every point of a grid, in parallel as evaluate_batch does.
+	    *
+	    * axes => axes[i] holds the sample points of variables()[i]. Throws length_error unless
+	    *         there is one axis per variable.\n
+	    * out  => Receives the product of the axis sizes results, in row major order: the last
+	    *         variable varies fastest.
+	    *********************************************************************************************/
+	    void evaluate_grid(const std::vector<std::vector<double> >& axes, double* out,
+			       thread_pool& pool = thread_pool::shared(), std::size_t chunk = 0) const;
+
+	    /*****************************************************************************************//**
+	    * A copy of this program reading its variables from the caller's layout instead, so that
+	    * values[i] is the value of names[i]. Names the program does not read are allowed, and
+	    * repeated names refer to their first position. Resolving the names is done here, once,
+	    * leaving no string work at all for evaluation. Throws invalid_argument if the program
+	    * reads a variable missing from names.
+	    *********************************************************************************************/
+	    program bind(const std::vector<std::string>& names) const;
+
+	    /**********************************//**
+	    * The slot layout evaluate expects. It
+	    * is sorted by name, unless the program
+	    * was bound to another.
+	    **************************************/
+	    const std::vector<std::string>& variables() const { return slots; }
+
+	    const std::vector<instruction>& code() const { return instructions; }
+	    const std::vector<double>& constants() const { return constant_pool; }
+	    std::size_t stack_depth() const { return depth; }
+
+	    friend class native_program;
+	private:
+	    void compile(const node::base_node& node);
+	    void emit(opcode op, std::uint32_t operand = 0);
+	    std::uint32_t intern_constant(double value);
+	    std::uint32_t intern_function(node::built_in_function implementation);
+	    double run(const double* values, double* stack) const;
+
+	    std::vector<instruction> instructions;
+	    std::vector<double> constant_pool;
+	    std::vector<std::string> slots;
+	    std::vector<std::uint32_t> read_slots;
+	    std::vector<node::built_in_function> functions;
+	    std::size_t depth;
+	    std::size_t height;
+	};
+    }
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef GOLD_MATH_RESULT_HPP
+#define GOLD_MATH_RESULT_HPP
+
+#include <cstddef>
+#include <utility>
+
+namespace Gold {
+    namespace math {
+
+	enum class error_code {
+	    none,
+	    empty_expression,
+	    unexpected_character,
+	    unexpected_token,
+	    unexpected_end,
+	    mismatched_brackets,
+	    literal_out_of_range,
+	    undefined_expression,
+	    variable_not_found,
+	    function_not_found,
+	    wrong_argument_count,
+	    invalid_node
+	};
+
+	/**********************************//**
+	* A short, static description of code.
+	**************************************/
+	const char* describe(error_code code);
+
+	/**********************************//**
+	* What went wrong and where. position is
+	* an offset into the parsed source, and 0
+	* for evaluation errors.
+	**************************************/
+	struct error_info {
+	    error_code code;
+	    std::size_t position;
+	};
+
+	/*****************************************************************************************//**
+	* Either a value or the error that prevented computing it, returned by the try_ functions
+	* instead of throwing.
+	*********************************************************************************************/
+	template <class T>
+	class result {
+	public:
+	    result(T&& _value) : stored(std::move(_value)), failure { error_code::none, 0 } { }
+	    result(const error_info& _failure) : stored(), failure(_failure) { }
+
+	    bool ok() const { return failure.code == error_code::none; }
+	    explicit operator bool() const { return ok(); }
+
+	    const T& value() const & { return stored; }
+	    T& value() & { return stored; }
+	    T&& value() && { return std::move(stored); }
+	    const error_info& error() const { return failure; }
+
+	private:
+	    T stored;
+	    error_info failure;
+	};
+    }
+}
+
+#endif
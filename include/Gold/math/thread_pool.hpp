@@ -0,0 +1,69 @@
+#ifndef GOLD_MATH_THREAD_POOL_HPP
+#define GOLD_MATH_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Gold {
+    namespace math {
+
+	/*****************************************************************************************//**
+	* A fixed set of worker threads that split index ranges between themselves. The thread that
+	* calls parallel_for works on the range too, so a pool of size n runs n chunks at once and a
+	* pool of size 1 has no workers at all.
+	*
+	* One range is processed at a time; concurrent calls to parallel_for queue up behind each
+	* other. Calling parallel_for from inside a task runs the inner range on the calling thread.
+	*********************************************************************************************/
+	class thread_pool {
+	public:
+	    typedef std::function<void(std::size_t, std::size_t)> task;
+
+	    explicit thread_pool(unsigned threads = std::thread::hardware_concurrency());
+	    thread_pool(const thread_pool& other) = delete;
+	    thread_pool& operator=(const thread_pool& other) = delete;
+	    ~thread_pool();
+
+	    unsigned size() const { return unsigned(workers.size()) + 1; }
+
+	    /*****************************************************************************************//**
+	    * Call body on consecutive chunks [begin, end) covering [0, count), each at most grain
+	    * long, and wait for all of them. If any chunk throws, the remaining chunks are skipped and
+	    * the first exception is rethrown here.
+	    *********************************************************************************************/
+	    void parallel_for(std::size_t count, std::size_t grain, const task& body);
+
+	    /**********************************//**
+	    * A process wide pool sized to the
+	    * hardware, created on first use.
+	    **************************************/
+	    static thread_pool& shared();
+
+	private:
+	    void work();
+	    void run_chunks();
+
+	    std::vector<std::thread> workers;
+	    std::mutex job_mutex;
+	    std::mutex mutex;
+	    std::condition_variable wake;
+	    std::condition_variable finished;
+
+	    const task* body;
+	    std::size_t count;
+	    std::size_t grain;
+	    std::atomic<std::size_t> next;
+	    std::size_t busy;
+	    unsigned long generation;
+	    bool stopping;
+	    std::exception_ptr error;
+	};
+    }
+}
+
+#endif
@@ -37,7 +37,8 @@ namespace Gold {
 
 	    /**********************************//**
      	    * Determines if a given string is
-	    * a number.
+	    * a number, allowing exponents as in
+	    * 1e-9.
 	    **************************************/
 	    bool is_string_num(const std::string& str);
 
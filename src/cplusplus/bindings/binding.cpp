@@ -0,0 +1,9 @@
+#include "Gold/bindings/expression.hpp"
+#include "Gold/bindings/library.hpp"
+
+NAN_MODULE_INIT(Init) {
+    Expression::Init(target);
+    ExpressionLibrary::Init(target);
+}
+
+NODE_MODULE(binding, Init);
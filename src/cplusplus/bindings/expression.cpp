@@ -1,4 +1,5 @@
 #include "Gold/bindings/expression.hpp"
+#include "Gold/math/encoding.hpp"
 #include "Gold/math/exception.hpp"
 #include "v8pp/convert.hpp"
 
@@ -19,6 +20,9 @@ std::map<std::string, Gold::math::expression> Expression::v8_object_to_map(v8::I
 	    catch (std::invalid_argument& e) {
 		Nan::ThrowError(e.what());
 	    }
+	    catch (Gold::math::exception& e) {
+		Nan::ThrowError(e.what());
+	    }
 	}
 	else if ( object->Get(v8_key)->IsInt32() ) {
 	    Nan::Maybe<int32_t> maybe_num = Nan::To<int32_t>(object->Get(v8_key));
@@ -48,6 +52,15 @@ std::map<std::string, Gold::math::expression> Expression::v8_object_to_map(v8::I
 		Nan::ThrowError(e.what());
 	    }
 	}
+	else if (object->Get(v8_key)->IsArrayBufferView()) {
+	    Nan::TypedArrayContents<char> contents(object->Get(v8_key));
+	    try {
+		value = Gold::math::decode(std::string_view(*contents, contents.length()));
+	    }
+	    catch (Gold::math::exception& e) {
+		Nan::ThrowError(e.what());
+	    }
+	}
 	else if (object->Get(v8_key)->IsObject() ){
 	    v8::Local<v8::Object> wrapped = object->Get(v8_key)->ToObject();
 	    Expression* expr = Nan::ObjectWrap::Unwrap<Expression>(wrapped);
@@ -62,6 +75,19 @@ std::map<std::string, Gold::math::expression> Expression::v8_object_to_map(v8::I
     return map;
 }
 
+void Expression::return_new(const Nan::FunctionCallbackInfo<v8::Value>& info, Gold::math::expression&& value) {
+    v8::Local<v8::Function> cons = Nan::New(constructor());
+    Nan::MaybeLocal<v8::Object> maybeInstance = Nan::NewInstance(cons);
+    v8::Local<v8::Object> instance;
+    if (maybeInstance.IsEmpty()) {
+	Nan::ThrowError("Could not create new Expression instance");
+    } else {
+	instance = maybeInstance.ToLocalChecked();
+	Expression* new_expression = ObjectWrap::Unwrap<Expression>(instance);
+	new_expression->expression = std::make_unique<Gold::math::expression>(std::move(value));
+	info.GetReturnValue().Set(instance);
+    }
+}
 
 
 NAN_MODULE_INIT(Expression::Init) {
@@ -73,6 +99,8 @@ NAN_MODULE_INIT(Expression::Init) {
     Nan::SetPrototypeMethod(tpl, "toString", toString);
     Nan::SetPrototypeMethod(tpl, "defined", defined);
     Nan::SetPrototypeMethod(tpl, "evaluate", evaluate);
+    Nan::SetPrototypeMethod(tpl, "toAST", toAST);
+    Nan::SetMethod(tpl, "fromAST", fromAST);
 
     constructor().Reset(Nan::GetFunction(tpl).ToLocalChecked());
     Nan::Set(target, Nan::New("Expression").ToLocalChecked(), Nan::GetFunction(tpl).ToLocalChecked());
@@ -86,8 +114,7 @@ NAN_METHOD(Expression::New) {
 	}
 	else if (info[0]->IsString()) {
 	    v8::String::Utf8Value param1(info[0]->ToString());
-	    std::string str = std::string(*param1);
-	    expression = new Expression(str);
+	    expression = new Expression(std::string_view(*param1, param1.length()));
 	}
 	else if (info[0]->IsInt32()) {
 	    expression = new Expression((int)info[0]->IntegerValue());
@@ -182,18 +209,31 @@ NAN_METHOD(Expression::call) {
     }
     else {
 	Nan::ThrowTypeError("Invoking Expressions takes an object of strings and Expressions");
+	return;
     }
-    v8::Local<v8::Function> cons = Nan::New(constructor());
-    Nan::MaybeLocal<v8::Object> maybeInstance = Nan::NewInstance(cons);
-    v8::Local<v8::Object> instance;
-    if (maybeInstance.IsEmpty()) {
-	Nan::ThrowError("Could not create new Expression instance");
-    } else {
-	instance = maybeInstance.ToLocalChecked();
-	Expression* new_expression = ObjectWrap::Unwrap<Expression>(instance);
-	new_expression->expression = std::make_unique<Gold::math::expression>(std::move(new_gold_expression));
-	info.GetReturnValue().Set(instance);
-    }
+    return_new(info, std::move(new_gold_expression));
 }
 
-NODE_MODULE(binding, Expression::Init);
+NAN_METHOD(Expression::toAST) {
+    Expression* expression = ObjectWrap::Unwrap<Expression>(info.Holder());
+    std::string data;
+    Gold::math::encode(expression->expression ? *expression->expression : Gold::math::expression(), data);
+    info.GetReturnValue().Set(Nan::CopyBuffer(data.data(), data.size()).ToLocalChecked());
+}
+
+NAN_METHOD(Expression::fromAST) {
+    if (info.Length() == 0 || !info[0]->IsArrayBufferView()) {
+	Nan::ThrowTypeError("Wrong arguments: Takes the Uint8Array returned by toAST");
+	return;
+    }
+    Nan::TypedArrayContents<char> contents(info[0]);
+    Gold::math::expression decoded;
+    try {
+	decoded = Gold::math::decode(std::string_view(*contents, contents.length()));
+    }
+    catch (Gold::math::exception& e) {
+	Nan::ThrowError(e.what());
+	return;
+    }
+    return_new(info, std::move(decoded));
+}
@@ -0,0 +1,137 @@
+#include "Gold/bindings/library.hpp"
+#include "Gold/math/exception.hpp"
+#include "v8pp/convert.hpp"
+#include <cstring>
+
+void ExpressionLibrary::return_new(const Nan::FunctionCallbackInfo<v8::Value>& info, std::unique_ptr<std::uint64_t[]> image,
+				   std::unique_ptr<Gold::math::expression_library> library) {
+    v8::Local<v8::Function> cons = Nan::New(constructor());
+    Nan::MaybeLocal<v8::Object> maybeInstance = Nan::NewInstance(cons);
+    v8::Local<v8::Object> instance;
+    if (maybeInstance.IsEmpty()) {
+	Nan::ThrowError("Could not create new ExpressionLibrary instance");
+    } else {
+	instance = maybeInstance.ToLocalChecked();
+	ExpressionLibrary* new_library = ObjectWrap::Unwrap<ExpressionLibrary>(instance);
+	new_library->image = std::move(image);
+	new_library->library = std::move(library);
+	info.GetReturnValue().Set(instance);
+    }
+}
+
+NAN_MODULE_INIT(ExpressionLibrary::Init) {
+    v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+    tpl->SetClassName(Nan::New("ExpressionLibrary").ToLocalChecked());
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+    Nan::SetPrototypeMethod(tpl, "evaluate", evaluate);
+    Nan::SetMethod(tpl, "open", open);
+    Nan::SetMethod(tpl, "fromImage", fromImage);
+
+    constructor().Reset(Nan::GetFunction(tpl).ToLocalChecked());
+    Nan::Set(target, Nan::New("ExpressionLibrary").ToLocalChecked(), Nan::GetFunction(tpl).ToLocalChecked());
+}
+
+// Libraries come from open and fromImage; one made here is empty until they fill it in
+NAN_METHOD(ExpressionLibrary::New) {
+    if (!info.IsConstructCall()) {
+	Nan::ThrowTypeError("Use ExpressionLibrary.open or ExpressionLibrary.fromImage");
+	return;
+    }
+    ExpressionLibrary* library = new ExpressionLibrary;
+    library->Wrap(info.This());
+    info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(ExpressionLibrary::open) {
+    if (info.Length() == 0 || !info[0]->IsString()) {
+	Nan::ThrowTypeError("Wrong arguments: Takes the path of an expression image");
+	return;
+    }
+    v8::String::Utf8Value path(info[0]->ToString());
+    std::unique_ptr<Gold::math::expression_library> library;
+    try {
+	library.reset(new Gold::math::expression_library(Gold::math::expression_library::open(std::string(*path, path.length()))));
+    }
+    catch (Gold::math::exception& e) {
+	Nan::ThrowError(e.what());
+	return;
+    }
+    return_new(info, nullptr, std::move(library));
+}
+
+NAN_METHOD(ExpressionLibrary::fromImage) {
+    if (info.Length() == 0 || !info[0]->IsArrayBufferView()) {
+	Nan::ThrowTypeError("Wrong arguments: Takes a Uint8Array holding an expression image");
+	return;
+    }
+    Nan::TypedArrayContents<char> contents(info[0]);
+    std::size_t size = contents.length();
+    std::unique_ptr<std::uint64_t[]> image(new std::uint64_t[(size + 7) / 8]);
+    if (size > 0) {
+	std::memcpy(image.get(), *contents, size);
+    }
+    std::unique_ptr<Gold::math::expression_library> library;
+    try {
+	std::string_view view(reinterpret_cast<const char*>(image.get()), size);
+	library.reset(new Gold::math::expression_library(Gold::math::expression_library::from_image(view)));
+    }
+    catch (Gold::math::exception& e) {
+	Nan::ThrowError(e.what());
+	return;
+    }
+    return_new(info, std::move(image), std::move(library));
+}
+
+NAN_METHOD(ExpressionLibrary::evaluate) {
+    v8::Isolate* isolate = info.GetIsolate();
+    ExpressionLibrary* library = ObjectWrap::Unwrap<ExpressionLibrary>(info.Holder());
+    if (!library->library) {
+	Nan::ThrowError("ExpressionLibrary has no image; use ExpressionLibrary.open or ExpressionLibrary.fromImage");
+	return;
+    }
+
+    std::size_t index;
+    if (info.Length() > 0 && info[0]->IsString()) {
+	v8::String::Utf8Value name(info[0]->ToString());
+	index = library->library->find(std::string_view(*name, name.length()));
+	if (index == Gold::math::expression_library::npos) {
+	    Nan::ThrowError(std::string("No expression called ").append(*name, name.length()).c_str());
+	    return;
+	}
+    }
+    else if (info.Length() > 0 && info[0]->IsUint32()) {
+	index = Nan::To<uint32_t>(info[0]).FromJust();
+    }
+    else {
+	Nan::ThrowTypeError("Wrong arguments: Takes the name or index of an expression, then an object");
+	return;
+    }
+
+    std::map<std::string, double> map;
+    if (info.Length() > 1) {
+	if (!info[1]->IsObject()) {
+	    Nan::ThrowTypeError("Wrong arguments: Takes the name or index of an expression, then an object");
+	    return;
+	}
+	try {
+	    map = v8pp::from_v8<std::map<std::string, double> >(isolate, info[1]->ToObject());
+	}
+	catch (std::invalid_argument& e) {
+	    Nan::ThrowTypeError(e.what());
+	    return;
+	}
+    }
+
+    double return_value;
+    try {
+	return_value = library->library->evaluate(index, map);
+    }
+    catch (std::exception& e) {
+	// Besides the library's own exceptions, missing variables are invalid_argument and a bad
+	// index out_of_range
+	Nan::ThrowError(e.what());
+	return;
+    }
+    info.GetReturnValue().Set(return_value);
+}
@@ -0,0 +1,353 @@
+#include "Gold/math/encoding.hpp"
+#include "Gold/math/exception.hpp"
+#include <cstdint>
+#include <cstring>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace Gold {
+    namespace math {
+	namespace node {
+
+	    namespace {
+
+		const char magic[4] = { 'G', 'o', 'l', 'd' };
+		const unsigned char version = 1;
+		// Deeper trees are rejected rather than decoded, since reading, copying and destroying
+		// them recurses once per level
+		const std::size_t max_depth = 10000;
+
+		// Node classes as stored. Values are part of the format, append only.
+		enum tag : unsigned char {
+		    add_tag,
+		    multiply_tag,
+		    power_tag,
+		    function_tag,
+		    integer_tag,
+		    number_tag,
+		    variable_tag,
+		    inverse_tag,
+		    quotient_tag,
+		    rational_tag
+		};
+
+		class writer {
+		public:
+		    explicit writer(std::string& _out) : out(_out) { }
+
+		    void byte(unsigned char value) { out.push_back(char(value)); }
+
+		    void varint(std::uint64_t value) {
+			while (value >= 0x80) {
+			    byte((unsigned char)(value | 0x80));
+			    value >>= 7;
+			}
+			byte((unsigned char)value);
+		    }
+
+		    void fixed(std::uint64_t value, int bytes) {
+			for (int i = 0; i < bytes; i++) {
+			    byte((unsigned char)(value >> (8 * i)));
+			}
+		    }
+
+		    void text(std::string_view value) {
+			varint(value.size());
+			out.append(value.data(), value.size());
+		    }
+
+		private:
+		    std::string& out;
+		};
+
+		class reader {
+		public:
+		    explicit reader(std::string_view data) :
+			position(reinterpret_cast<const unsigned char*>(data.data())), last(position + data.size()) { }
+
+		    std::size_t left() const { return std::size_t(last - position); }
+		    bool done() const { return position == last; }
+
+		    unsigned char byte() {
+			need(1);
+			return *position++;
+		    }
+
+		    std::uint64_t varint() {
+			std::uint64_t value = 0;
+			for (int shift = 0; shift < 64; shift += 7) {
+			    unsigned char next = byte();
+			    value |= std::uint64_t(next & 0x7f) << shift;
+			    if ((next & 0x80) == 0) {
+				return value;
+			    }
+			}
+			throw invalid_encoding("Varint too long in encoded expression");
+		    }
+
+		    std::uint64_t fixed(int bytes) {
+			need(bytes);
+			std::uint64_t value = 0;
+			for (int i = 0; i < bytes; i++) {
+			    value |= std::uint64_t(position[i]) << (8 * i);
+			}
+			position += bytes;
+			return value;
+		    }
+
+		    std::string_view text() {
+			std::uint64_t length = varint();
+			need(length);
+			std::string_view value(reinterpret_cast<const char*>(position), length);
+			position += length;
+			return value;
+		    }
+
+		private:
+		    void need(std::uint64_t bytes) const {
+			if (bytes > std::uint64_t(last - position)) {
+			    throw invalid_encoding("Truncated encoded expression");
+			}
+		    }
+
+		    const unsigned char* position;
+		    const unsigned char* last;
+		};
+
+		tag tag_of(const base_node& tree) {
+		    switch (tree.kind()) {
+		    case node_kind::add: return add_tag;
+		    case node_kind::multiply:
+			if (typeid(tree) == typeid(rational)) {
+			    return rational_tag;
+			}
+			return typeid(tree) == typeid(quotient) ? quotient_tag : multiply_tag;
+		    case node_kind::power:
+			return typeid(tree) == typeid(inverse) ? inverse_tag : power_tag;
+		    case node_kind::function: return function_tag;
+		    case node_kind::integer: return integer_tag;
+		    case node_kind::number: return number_tag;
+		    case node_kind::variable: return variable_tag;
+		    }
+		    throw invalid_node("Unknown node kind");
+		}
+
+		/**********************************//**
+		* Names seen so far, by first appearance.
+		**************************************/
+		struct name_table {
+		    std::unordered_map<std::string_view, std::size_t> index;
+		    std::vector<std::string_view> names;
+
+		    std::size_t intern(const std::string& name) {
+			auto found = index.emplace(name, names.size());
+			if (found.second) {
+			    names.push_back(name);
+			}
+			return found.first->second;
+		    }
+		};
+
+		std::size_t write_node(const base_node& tree, writer& body, name_table& table) {
+		    tag type = tag_of(tree);
+		    body.byte(type);
+		    switch (type) {
+		    case integer_tag:
+			body.fixed(std::uint32_t(static_cast<const integer&>(tree).value()), 4);
+			return 1;
+		    case number_tag: {
+			double value = static_cast<const number&>(tree).value();
+			std::uint64_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			body.fixed(bits, 8);
+			return 1;
+		    }
+		    case variable_tag:
+			body.varint(table.intern(static_cast<const variable&>(tree).name()));
+			return 1;
+		    case function_tag:
+			body.varint(table.intern(static_cast<const function&>(tree).name()));
+			break;
+		    default:
+			break;
+		    }
+		    const operation& op = static_cast<const operation&>(tree);
+		    body.varint(op.size());
+		    std::size_t count = 1;
+		    for (auto iter = op.begin(); iter != op.end(); iter++) {
+			count += write_node(**iter, body, table);
+		    }
+		    return count;
+		}
+
+		void write(const base_node* tree, std::string& out) {
+		    thread_local std::string nodes;
+		    thread_local name_table table;
+		    nodes.clear();
+		    table.index.clear();
+		    table.names.clear();
+		    writer body(nodes);
+		    std::size_t count = tree ? write_node(*tree, body, table) : 0;
+
+		    writer header(out);
+		    out.append(magic, sizeof(magic));
+		    header.byte(version);
+		    header.varint(table.names.size());
+		    for (std::string_view name : table.names) {
+			header.text(name);
+		    }
+		    header.varint(count);
+		    out.append(nodes);
+		}
+
+		template<class T>
+		base_node::ptr make_operation(std::size_t arity) {
+		    std::unique_ptr<T> result = std::make_unique<T>();
+		    result->getChildren().reserve(arity);
+		    return result;
+		}
+
+		/**********************************//**
+		* State while decoding. remaining counts
+		* the nodes not yet read, which bounds
+		* every arity and so every reservation.
+		* depth is the nesting of the node being
+		* read.
+		**************************************/
+		struct decoder {
+		    reader in;
+		    std::vector<std::string_view> names;
+		    std::uint64_t remaining;
+		    std::size_t depth;
+
+		    const std::string_view& name() {
+			std::uint64_t index = in.varint();
+			if (index >= names.size()) {
+			    throw invalid_encoding("Name index out of range in encoded expression");
+			}
+			return names[index];
+		    }
+
+		    base_node::ptr read_node() {
+			if (remaining == 0) {
+			    throw invalid_encoding("More nodes than declared in encoded expression");
+			}
+			remaining--;
+			unsigned char type = in.byte();
+			switch (type) {
+			case integer_tag:
+			    return std::make_unique<integer>(int(std::uint32_t(in.fixed(4))));
+			case number_tag: {
+			    std::uint64_t bits = in.fixed(8);
+			    double value;
+			    std::memcpy(&value, &bits, sizeof(value));
+			    return std::make_unique<number>(value);
+			}
+			case variable_tag:
+			    return std::make_unique<variable>(std::string(name()));
+			default:
+			    break;
+			}
+
+			base_node::ptr result;
+			std::string_view function_name;
+			if (type == function_tag) {
+			    function_name = name();
+			}
+			std::uint64_t arity = in.varint();
+			if (arity > remaining) {
+			    throw invalid_encoding("Arity exceeds node count in encoded expression");
+			}
+			// Powers and quotients are read through child(0) and child(1). Calls with more than
+			// one argument parse, and only fail to evaluate, so only calls with none are rejected.
+			bool binary = type == power_tag || type == inverse_tag || type == quotient_tag || type == rational_tag;
+			if ((binary && arity != 2) || (type == function_tag && arity == 0)) {
+			    throw invalid_encoding("Wrong arity for node in encoded expression");
+			}
+			switch (type) {
+			case add_tag: result = make_operation<add>(arity); break;
+			case multiply_tag: result = make_operation<multiply>(arity); break;
+			case power_tag: result = make_operation<power>(arity); break;
+			case inverse_tag: result = make_operation<inverse>(arity); break;
+			case quotient_tag: result = make_operation<quotient>(arity); break;
+			case rational_tag: result = make_operation<rational>(arity); break;
+			case function_tag: {
+			    function::ptr call = std::make_unique<function>(std::string(function_name));
+			    call->getChildren().reserve(arity);
+			    result = std::move(call);
+			    break;
+			}
+			default:
+			    throw invalid_encoding("Unknown node tag in encoded expression");
+			}
+			operation& op = static_cast<operation&>(*result);
+			if (arity > 0 && ++depth > max_depth) {
+			    throw invalid_encoding("Encoded expression is nested too deeply");
+			}
+			for (std::uint64_t i = 0; i < arity; i++) {
+			    op.append(read_node());
+			}
+			depth -= arity > 0;
+			return result;
+		    }
+		};
+
+		base_node::ptr read(std::string_view data) {
+		    if (data.size() < sizeof(magic) || std::memcmp(data.data(), magic, sizeof(magic)) != 0) {
+			throw invalid_encoding("Not an encoded expression");
+		    }
+		    thread_local std::vector<std::string_view> names;
+		    decoder state { reader(data.substr(sizeof(magic))), std::move(names), 0, 0 };
+		    state.names.clear();
+		    if (state.in.byte() != version) {
+			throw invalid_encoding("Unsupported encoded expression version");
+		    }
+		    std::uint64_t name_count = state.in.varint();
+		    if (name_count > state.in.left()) {
+			throw invalid_encoding("Truncated encoded expression");
+		    }
+		    state.names.reserve(name_count);
+		    for (std::uint64_t i = 0; i < name_count; i++) {
+			state.names.push_back(state.in.text());
+		    }
+		    // Every node takes at least two bytes, so this also bounds what arities can reserve
+		    state.remaining = state.in.varint();
+		    if (state.remaining > state.in.left() / 2) {
+			throw invalid_encoding("Truncated encoded expression");
+		    }
+		    base_node::ptr tree = state.remaining ? state.read_node() : nullptr;
+		    if (state.remaining != 0 || !state.in.done()) {
+			throw invalid_encoding("Node count does not match encoded expression");
+		    }
+		    names = std::move(state.names);
+		    return tree;
+		}
+	    }
+
+	    void encode(const base_node& tree, std::string& out) {
+		write(&tree, out);
+	    }
+
+	    base_node::ptr decode(std::string_view data) {
+		return read(data);
+	    }
+	}
+
+	void encode(const expression& expr, std::string& out) {
+	    node::write(expr.root.get(), out);
+	}
+
+	std::string encode(const expression& expr) {
+	    std::string out;
+	    encode(expr, out);
+	    return out;
+	}
+
+	expression decode(std::string_view data) {
+	    expression result;
+	    result.root = node::read(data);
+	    return result;
+	}
+    }
+}
@@ -0,0 +1,44 @@
+#include "Gold/math/batch.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace Gold {
+    namespace math {
+
+	std::vector<expression> parse_batch(const std::string_view* formulas, std::size_t count,
+					    std::vector<parse_error>& errors, thread_pool& pool) {
+	    std::vector<expression> results(count);
+	    std::mutex error_mutex;
+	    errors.clear();
+
+	    // Several chunks per thread keeps the threads busy when formula lengths vary
+	    std::size_t grain = std::max<std::size_t>(16, count / (pool.size() * 8));
+	    pool.parallel_for(count, grain, [&](std::size_t begin, std::size_t end) {
+		    std::vector<parse_error> chunk_errors;
+		    for (std::size_t i = begin; i < end; i++) {
+			try {
+			    results[i] = expression(formulas[i]);
+			}
+			catch (const std::exception& e) {
+			    chunk_errors.push_back(parse_error { i, e.what() });
+			}
+		    }
+		    if (!chunk_errors.empty()) {
+			std::lock_guard<std::mutex> lock(error_mutex);
+			errors.insert(errors.end(), std::make_move_iterator(chunk_errors.begin()),
+				      std::make_move_iterator(chunk_errors.end()));
+		    }
+		});
+
+	    std::sort(errors.begin(), errors.end(), [](const parse_error& lhs, const parse_error& rhs) {
+		    return lhs.index < rhs.index;
+		});
+	    return results;
+	}
+
+	std::vector<expression> parse_batch(const std::vector<std::string_view>& formulas,
+					    std::vector<parse_error>& errors, thread_pool& pool) {
+	    return parse_batch(formulas.data(), formulas.size(), errors, pool);
+	}
+    }
+}
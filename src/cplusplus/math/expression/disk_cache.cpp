@@ -0,0 +1,317 @@
+#include "Gold/math/disk_cache.hpp"
+#include "Gold/math/encoding.hpp"
+#include "Gold/math/exception.hpp"
+#include "Gold/math/mapped_file.hpp"
+#include "Gold/math/parse_cache.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <unordered_set>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Gold {
+    namespace math {
+
+	namespace {
+
+	    const char magic[8] = { 'G', 'o', 'l', 'd', 'P', 'a', 'c', 'k' };
+	    const std::uint32_t version = 1;
+	    // Magic, version and entry count
+	    const std::size_t file_header = 16;
+	    // Key, checksum, source length and tree length
+	    const std::size_t entry_header = 24;
+
+	    /**********************************//**
+	    * A fast non cryptographic hash, eight
+	    * bytes at a time, used for keys and
+	    * checksums alike.
+	    **************************************/
+	    std::uint64_t hash(const unsigned char* data, std::size_t size, std::uint64_t seed = 0) {
+		const std::uint64_t multiplier = 0x9e3779b97f4a7c15ull;
+		std::uint64_t state = seed ^ (size * multiplier);
+		while (size > 0) {
+		    std::uint64_t word = 0;
+		    std::size_t step = size < 8 ? size : 8;
+		    std::memcpy(&word, data, step);
+		    state = (state ^ word) * multiplier;
+		    state ^= state >> 32;
+		    data += step;
+		    size -= step;
+		}
+		state ^= state >> 29;
+		state *= 0xbf58476d1ce4e5b9ull;
+		return state ^ (state >> 32);
+	    }
+
+	    std::uint64_t hash(std::string_view text, std::uint64_t seed = 0) {
+		return hash(reinterpret_cast<const unsigned char*>(text.data()), text.size(), seed);
+	    }
+
+	    std::uint64_t read_le(const unsigned char* data, int bytes) {
+		std::uint64_t value = 0;
+		for (int i = 0; i < bytes; i++) {
+		    value |= std::uint64_t(data[i]) << (8 * i);
+		}
+		return value;
+	    }
+
+	    void write_le(std::string& out, std::uint64_t value, int bytes) {
+		for (int i = 0; i < bytes; i++) {
+		    out.push_back(char(value >> (8 * i)));
+		}
+	    }
+
+	    /**********************************//**
+	    * Call visit with the key, offset and
+	    * size of every entry of pack that lies
+	    * within it. Returns false if pack is
+	    * not a pack of this version.
+	    **************************************/
+	    template<typename Visit>
+	    bool for_each_entry(const mapped_file& pack, Visit visit) {
+		const unsigned char* data = pack.data();
+		std::size_t size = pack.size();
+		if (size < file_header || std::memcmp(data, magic, sizeof(magic)) != 0 ||
+		    read_le(data + 8, 4) != version) {
+		    return false;
+		}
+		// Only bounds are checked here; checksums are verified when an entry is used
+		std::uint64_t count = read_le(data + 12, 4);
+		std::size_t offset = file_header;
+		for (std::uint64_t i = 0; i < count && size - offset >= entry_header; i++) {
+		    std::uint64_t entry_size = entry_header + read_le(data + offset + 16, 4) + read_le(data + offset + 20, 4);
+		    if (entry_size > size - offset) {
+			break;
+		    }
+		    visit(read_le(data + offset, 8), offset, std::size_t(entry_size));
+		    offset += entry_size;
+		}
+		return true;
+	    }
+
+	    /**********************************//**
+	    * A file descriptor, closed when this
+	    * goes out of scope.
+	    **************************************/
+	    struct descriptor {
+		int fd;
+		explicit descriptor(int _fd) : fd(_fd) { }
+		descriptor(const descriptor& other) = delete;
+		descriptor& operator=(const descriptor& other) = delete;
+		~descriptor() {
+		    if (fd >= 0) {
+			::close(fd);
+		    }
+		}
+	    };
+
+	    bool write_all(int fd, const std::string& contents) {
+		const char* data = contents.data();
+		std::size_t left = contents.size();
+		while (left > 0) {
+		    ssize_t written = ::write(fd, data, left);
+		    if (written < 0 && errno == EINTR) {
+			continue;
+		    }
+		    if (written <= 0) {
+			return false;
+		    }
+		    data += written;
+		    left -= std::size_t(written);
+		}
+		return true;
+	    }
+
+	    void append_entry(std::string& out, std::uint64_t key, std::string_view source, std::string_view tree) {
+		write_le(out, key, 8);
+		write_le(out, hash(tree, hash(source)), 8);
+		write_le(out, source.size(), 4);
+		write_le(out, tree.size(), 4);
+		out.append(source.data(), source.size());
+		out.append(tree.data(), tree.size());
+	    }
+	}
+
+	disk_cache::disk_cache(const std::string& directory) : counters { 0, 0, 0, 0 } {
+	    std::error_code failure;
+	    std::filesystem::create_directories(directory, failure);
+	    if (failure) {
+		throw io_error("Could not create " + directory + ": " + failure.message());
+	    }
+	    pack_path = (std::filesystem::path(directory) / "expressions.gold").string();
+	    std::lock_guard<std::mutex> lock(mutex);
+	    open_pack();
+	}
+
+	disk_cache::~disk_cache() {
+	    try {
+		flush();
+	    }
+	    catch (...) {
+		// A cache that cannot be written is only a slower start next time
+	    }
+	}
+
+	void disk_cache::open_pack() {
+	    pack = std::make_shared<const mapped_file>(pack_path, false);
+	    index.clear();
+	    if (pack->size() >= file_header) {
+		index.reserve(std::min<std::uint64_t>(read_le(pack->data() + 12, 4), (pack->size() - file_header) / entry_header));
+	    }
+	    for_each_entry(*pack, [this](std::uint64_t key, std::size_t offset, std::size_t) {
+		index[key] = location { false, offset };
+	    });
+	    counters.entries = index.size();
+	}
+
+	bool disk_cache::load(const std::shared_ptr<const mapped_file>& pack, std::size_t offset, const std::string& key, expression& out) const {
+	    const unsigned char* entry = pack->data() + offset;
+	    std::size_t source_size = read_le(entry + 16, 4);
+	    std::size_t tree_size = read_le(entry + 20, 4);
+	    const unsigned char* source = entry + entry_header;
+	    const unsigned char* tree = source + source_size;
+	    if (hash(tree, tree_size, hash(source, source_size)) != read_le(entry + 8, 8) ||
+		std::string_view(reinterpret_cast<const char*>(source), source_size) != key) {
+		return false;
+	    }
+	    try {
+		out = decode(std::string_view(reinterpret_cast<const char*>(tree), tree_size));
+	    }
+	    catch (const invalid_encoding&) {
+		return false;
+	    }
+	    return true;
+	}
+
+	expression disk_cache::parse(std::string_view source) {
+	    std::string key = parse_cache::normalize(source);
+	    std::uint64_t key_hash = hash(key);
+
+	    std::shared_ptr<const mapped_file> snapshot;
+	    std::size_t offset = 0;
+	    std::string pending_source;
+	    std::string pending_tree;
+	    bool found = false;
+	    {
+		std::lock_guard<std::mutex> lock(mutex);
+		auto entry = index.find(key_hash);
+		if (entry != index.end()) {
+		    found = true;
+		    if (entry->second.pending) {
+			pending_source = pending[entry->second.offset].source;
+			pending_tree = pending[entry->second.offset].tree;
+		    }
+		    else {
+			snapshot = pack;
+			offset = entry->second.offset;
+		    }
+		}
+	    }
+
+	    // Decode outside the lock, from the snapshot, which stays mapped even if a flush
+	    // replaces the pack meanwhile
+	    expression result;
+	    bool loaded = false;
+	    if (found && snapshot) {
+		loaded = load(snapshot, offset, key, result);
+	    }
+	    else if (found && pending_source == key) {
+		result = decode(pending_tree);
+		loaded = true;
+	    }
+	    if (loaded) {
+		std::lock_guard<std::mutex> lock(mutex);
+		counters.hits++;
+		return result;
+	    }
+
+	    result = expression(source);
+	    std::string tree = encode(result);
+	    std::lock_guard<std::mutex> lock(mutex);
+	    if (found) {
+		counters.stale++;
+	    }
+	    else {
+		counters.misses++;
+	    }
+	    auto entry = index.find(key_hash);
+	    if (entry == index.end()) {
+		counters.entries++;
+	    }
+	    index[key_hash] = location { true, pending.size() };
+	    pending.push_back(pending_entry { std::move(key), std::move(tree) });
+	    return result;
+	}
+
+	void disk_cache::flush() {
+	    std::lock_guard<std::mutex> lock(mutex);
+	    if (pending.empty()) {
+		return;
+	    }
+
+	    // Other caches, in this process or another, may have flushed since the pack was opened.
+	    // Holding the lock file while merging with the pack as it is now keeps their entries.
+	    descriptor lock_file(::open((pack_path + ".lock").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644));
+	    if (lock_file.fd < 0 || ::flock(lock_file.fd, LOCK_EX) != 0) {
+		throw io_error("Could not lock " + pack_path + ": " + std::strerror(errno));
+	    }
+	    mapped_file latest(pack_path, false);
+
+	    std::string contents(magic, sizeof(magic));
+	    write_le(contents, version, 4);
+	    write_le(contents, 0, 4);
+	    std::uint64_t count = 0;
+	    std::unordered_set<std::uint64_t> added;
+	    for (const auto& entry : index) {
+		if (entry.second.pending) {
+		    const pending_entry& fresh = pending[entry.second.offset];
+		    append_entry(contents, entry.first, fresh.source, fresh.tree);
+		    added.insert(entry.first);
+		    count++;
+		}
+	    }
+	    // Entries already on disk are copied as they are, checksum and all
+	    for_each_entry(latest, [&](std::uint64_t key, std::size_t offset, std::size_t size) {
+		if (added.insert(key).second) {
+		    contents.append(reinterpret_cast<const char*>(latest.data() + offset), size);
+		    count++;
+		}
+	    });
+	    for (int i = 0; i < 4; i++) {
+		contents[12 + i] = char(count >> (8 * i));
+	    }
+
+	    std::string temporary = pack_path + ".XXXXXX";
+	    descriptor file(::mkstemp(&temporary[0]));
+	    if (file.fd < 0) {
+		throw io_error("Could not create " + temporary + ": " + std::strerror(errno));
+	    }
+	    // Synced before the rename, so a crash leaves the old pack or the whole new one
+	    bool written = ::fchmod(file.fd, 0644) == 0 && write_all(file.fd, contents) && ::fsync(file.fd) == 0;
+	    written = ::close(file.fd) == 0 && written;
+	    file.fd = -1;
+	    if (!written || std::rename(temporary.c_str(), pack_path.c_str()) != 0) {
+		std::remove(temporary.c_str());
+		throw io_error("Could not write " + pack_path);
+	    }
+	    // Then the directory, so the rename itself survives a crash
+	    std::string directory = std::filesystem::path(pack_path).parent_path().string();
+	    descriptor parent(::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+	    if (parent.fd >= 0) {
+		::fsync(parent.fd);
+	    }
+	    pending.clear();
+	    open_pack();
+	}
+
+	disk_cache::statistics disk_cache::stats() const {
+	    std::lock_guard<std::mutex> lock(mutex);
+	    return counters;
+	}
+    }
+}
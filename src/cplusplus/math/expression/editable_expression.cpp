@@ -0,0 +1,193 @@
+#include "Gold/math/editable_expression.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace Gold {
+    namespace math {
+
+	namespace {
+
+	    bool is_bracket(parser::token_type type) {
+		return type == parser::token_type::open_paren || type == parser::token_type::close_paren ||
+		    type == parser::token_type::open_bracket || type == parser::token_type::close_bracket;
+	    }
+
+	    /**********************************//**
+	    * Work out the additive and multiplicative
+	    * flags a group holding tokens would get
+	    * from the tokenizer.
+	    **************************************/
+	    void group_flags(const std::vector<parser::token>& tokens, bool& additive, bool& multiplicative) {
+		additive = false;
+		multiplicative = false;
+		parser::token_type previous = parser::token_type::end;
+		for (std::size_t i = 0; i < tokens.size(); i++) {
+		    switch (tokens[i].type) {
+		    case parser::token_type::open_paren:
+		    case parser::token_type::open_bracket:
+			i = tokens[i].match;
+			break;
+		    case parser::token_type::plus:
+		    case parser::token_type::minus:
+			additive = additive || previous == parser::token_type::number ||
+			    previous == parser::token_type::identifier ||
+			    previous == parser::token_type::close_paren ||
+			    previous == parser::token_type::close_bracket;
+			break;
+		    case parser::token_type::times:
+		    case parser::token_type::divide:
+			multiplicative = true;
+			break;
+		    default:
+			break;
+		    }
+		    previous = tokens[i].type;
+		}
+	    }
+	}
+
+	editable_expression::editable_expression(std::string source) {
+	    parse_all(std::move(source));
+	}
+
+	bool editable_expression::edit(const text_edit& change) {
+	    if (change.offset > text.size() || change.removed > text.size() - change.offset) {
+		throw std::out_of_range("Edit is outside of the source");
+	    }
+	    std::string new_text = text;
+	    new_text.replace(change.offset, change.removed, change.inserted);
+	    std::ptrdiff_t delta = std::ptrdiff_t(change.inserted.size()) - std::ptrdiff_t(change.removed);
+	    std::size_t edit_end = change.offset + change.removed;
+
+	    // Groups holding the edit, from the outermost in, since tokens are ordered by position
+	    std::vector<std::size_t> around;
+	    for (std::size_t i = 0; i < tokens.size(); i++) {
+		const parser::token& tok = tokens[i];
+		if ((tok.type == parser::token_type::open_paren || tok.type == parser::token_type::open_bracket) &&
+		    tok.begin < change.offset && tokens[tok.match].begin >= edit_end) {
+		    around.push_back(i);
+		}
+	    }
+
+	    for (auto iter = around.rbegin(); iter != around.rend(); iter++) {
+		std::size_t open = *iter;
+		if (!groups[open]) {
+		    continue;
+		}
+
+		// Functions are parsed again from their name, since their arguments are not one node
+		bool function = tokens[open].type == parser::token_type::open_bracket;
+		std::size_t close = tokens[open].match;
+		std::size_t first = function ? open - 1 : open + 1;
+		std::size_t last = function ? close : close - 1;
+		std::size_t begin = function ? tokens[first].begin : tokens[open].begin + 1;
+		std::size_t end = std::size_t(std::ptrdiff_t(tokens[close].begin) + delta) + (function ? 1 : 0);
+
+		std::vector<parser::token> region;
+		std::vector<node::base_node*> region_groups;
+		node::base_node::ptr subtree;
+		try {
+		    parser::tree_parser parser(std::string_view(new_text).substr(begin, end - begin), region);
+		    subtree = parser.parse(region_groups);
+		}
+		catch (const std::exception&) {
+		    break;
+		}
+		region.pop_back();
+		region_groups.pop_back();
+
+		bool additive = false;
+		bool multiplicative = false;
+		if (!function) {
+		    // Whether a bracketed group is spliced into its surroundings depends on this flag
+		    group_flags(region, additive, multiplicative);
+		    if (additive != tokens[open].additive) {
+			continue;
+		    }
+		}
+		node::base_node::ptr* slot = find_slot(groups[open]);
+		if (!slot) {
+		    break;
+		}
+
+		std::ptrdiff_t shift = std::ptrdiff_t(region.size()) - std::ptrdiff_t(last - first + 1);
+		for (parser::token& tok : region) {
+		    tok.begin += begin;
+		    if (is_bracket(tok.type)) {
+			tok.match += first;
+		    }
+		}
+		for (std::size_t i = 0; i < tokens.size(); i++) {
+		    if (i >= first && i <= last) {
+			continue;
+		    }
+		    if (i > last) {
+			tokens[i].begin = std::size_t(std::ptrdiff_t(tokens[i].begin) + delta);
+		    }
+		    if (is_bracket(tokens[i].type) && tokens[i].match > last) {
+			tokens[i].match = std::size_t(std::ptrdiff_t(tokens[i].match) + shift);
+		    }
+		}
+		if (!function) {
+		    tokens[open].multiplicative = multiplicative;
+		    groups[open] = subtree.get();
+		}
+		if (shift == 0) {
+		    std::copy(region.begin(), region.end(), tokens.begin() + first);
+		    std::copy(region_groups.begin(), region_groups.end(), groups.begin() + first);
+		}
+		else {
+		    tokens.erase(tokens.begin() + first, tokens.begin() + last + 1);
+		    tokens.insert(tokens.begin() + first, region.begin(), region.end());
+		    groups.erase(groups.begin() + first, groups.begin() + last + 1);
+		    groups.insert(groups.begin() + first, region_groups.begin(), region_groups.end());
+		}
+
+		*slot = std::move(subtree);
+		expr.string_value.clear();
+		text = std::move(new_text);
+		return true;
+	    }
+
+	    parse_all(std::move(new_text));
+	    return false;
+	}
+
+	void editable_expression::parse_all(std::string&& new_text) {
+	    std::vector<parser::token> new_tokens;
+	    std::vector<node::base_node*> new_groups;
+	    parser::tree_parser parser(new_text, new_tokens);
+	    node::base_node::ptr root = parser.parse(new_groups);
+
+	    text = std::move(new_text);
+	    tokens.swap(new_tokens);
+	    groups.swap(new_groups);
+	    expr.root = std::move(root);
+	    expr.string_value.clear();
+	}
+
+	node::base_node::ptr* editable_expression::find_slot(const node::base_node* target) {
+	    if (expr.root.get() == target) {
+		return &expr.root;
+	    }
+	    if (expr.root->is_leaf()) {
+		return nullptr;
+	    }
+	    // Every node with children is an operation, so is_leaf saves a dynamic_cast per node
+	    std::vector<node::base_node*> pending { expr.root.get() };
+	    while (!pending.empty()) {
+		node::operation* current = static_cast<node::operation*>(pending.back());
+		pending.pop_back();
+		for (node::base_node::ptr& child : *current) {
+		    if (child.get() == target) {
+			return &child;
+		    }
+		    if (!child->is_leaf()) {
+			pending.push_back(child.get());
+		    }
+		}
+	    }
+	    return nullptr;
+	}
+    }
+}
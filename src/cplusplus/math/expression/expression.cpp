@@ -1,5 +1,7 @@
 #include "Gold/math/expression.hpp"
 #include "Gold/math/exception.hpp"
+#include "Gold/math/parser.hpp"
+#include "Gold/math/printer.hpp"
 #include <stdexcept>
 
 namespace Gold {
@@ -9,20 +11,21 @@ namespace Gold {
 	    //Intentionally empty
 	}
 	
-	expression::expression(const std::string& expr) {
-	    std::string str = expr;
-	    str.erase(remove_if(str.begin(), str.end(), isspace), str.end());
-	    str = utils::remove_enclosing_parens(str);
-	    if ( !utils::are_parens_matched(str) ) {
-		str = expr;
-		throw invalid_expression(str.append(" has mismatched parentheses"));
-	    }
-	    root = node::make_tree(str);
+	expression::expression(std::string_view expr) {
+	    root = node::make_tree(expr);
 	}
 	
+	expression::expression(int value) : root(std::make_unique<node::integer>(value)) {
+	    //Intentionally empty
+	}
+
+	expression::expression(double value) : root(std::make_unique<node::number>(value)) {
+	    //Intentionally empty
+	}
+
 	expression::expression(const expression& other) {
 	    if (&other != this) {
-		root = node::base_node::ptr(other.root->clone());
+		root = other.root ? node::base_node::ptr(other.root->clone()) : nullptr;
 		string_value = "";
 	    }
 	}
@@ -36,7 +39,7 @@ namespace Gold {
 	
 	expression& expression::operator=(const expression& other) {
 	    if (&other != this) {
-		root = node::base_node::ptr(other.root->clone());
+		root = other.root ? node::base_node::ptr(other.root->clone()) : nullptr;
 		string_value = "";
 	    }
 	    return *this;
@@ -57,6 +60,25 @@ namespace Gold {
 	    return root->evaluate(args);
 	}
 	
+	result<double> expression::try_evaluate(const std::map<std::string, double>& args) const {
+	    if (!defined()) {
+		return error_info { error_code::undefined_expression, 0 };
+	    }
+	    double value;
+	    error_code code = root->try_evaluate(args, value);
+	    if (code != error_code::none) {
+		return error_info { code, 0 };
+	    }
+	    return std::move(value);
+	}
+
+	program expression::compile() const {
+	    if (!defined()) {
+		throw undefined_expression("Undefined evaluation");
+	    }
+	    return program(*root);
+	}
+
 	bool expression::defined() const {
 	    return bool(root && !root->is_undefined());
 	}
@@ -91,12 +113,12 @@ namespace Gold {
 	    return result;
 	}
 
-	expression expression::commutative_operator(const expression& lhs, const expression& rhs, const std::string& operation) {
-	    node::base_node::ptr left_handle = node::base_node::ptr(lhs.root->clone());
-	    node::base_node::ptr right_handle = node::base_node::ptr(rhs.root->clone());
+	expression expression::commutative_operator(expression lhs, expression rhs, node::node_kind operation) {
+	    node::base_node::ptr left_handle = std::move(lhs.root);
+	    node::base_node::ptr right_handle = std::move(rhs.root);
 	    expression result;
 
-	    if (left_handle->get_token() == operation && right_handle->get_token() == operation) {
+	    if (left_handle->kind() == operation && right_handle->kind() == operation) {
 		node::operation* left = static_cast<node::operation*>(left_handle.get());
 		node::operation* right = static_cast<node::operation*>(right_handle.get());
 		for (auto iter = right->begin(); iter != right->end(); iter++) {
@@ -104,12 +126,12 @@ namespace Gold {
 		}
 		result.root = std::move(left_handle);
 	    }
-	    else if (left_handle->get_token() == operation) {
+	    else if (left_handle->kind() == operation) {
 		node::operation* left = static_cast<node::operation*>(left_handle.get());
 		left->append(std::move(right_handle));
 		result.root = std::move(left_handle);
 	    }
-	    else if (right_handle->get_token() == operation) {
+	    else if (right_handle->kind() == operation) {
 		node::operation* right = static_cast<node::operation*>(right_handle.get());
 		auto iter = right->begin();
 		right->getChildren().insert(iter, std::move(left_handle));
@@ -120,19 +142,23 @@ namespace Gold {
 		vector.reserve(2);
 		vector.push_back(std::move(left_handle));
 		vector.push_back(std::move(right_handle));
-		node::add::ptr newRoot = std::make_unique<node::add>(vector);
-		result.root = std::move(newRoot);
+		if (operation == node::node_kind::add) {
+		    result.root = std::make_unique<node::add>(std::move(vector));
+		}
+		else {
+		    result.root = std::make_unique<node::multiply>(std::move(vector));
+		}
 	    }
 	    return result;
 	}
 
-	expression operator+(const expression& lhs, const expression& rhs) {
-	    return expression::commutative_operator(lhs, rhs, "+");
+	expression operator+(expression lhs, expression rhs) {
+	    return expression::commutative_operator(std::move(lhs), std::move(rhs), node::node_kind::add);
 	}
 
-	expression operator-(const expression& expr) {
-	    node::base_node::ptr right = node::base_node::ptr(expr.root->clone());
-	    if (right->get_token() == "*") {
+	expression operator-(expression expr) {
+	    node::base_node::ptr right = std::move(expr.root);
+	    if (right->kind() == node::node_kind::multiply) {
 		node::multiply* right_ptr = static_cast<node::multiply*>(right.get());
 		right_ptr->getChildren().insert(right_ptr->getChildren().begin(), std::make_unique<node::integer>(-1));
 	    }
@@ -141,7 +167,7 @@ namespace Gold {
 		vector.reserve(2);
 		vector.push_back(std::make_unique<node::integer>(-1));
 		vector.push_back(std::move(right));
-		right = std::make_unique<node::multiply>(vector);
+		right = std::make_unique<node::multiply>(std::move(vector));
 	    }
 	    
 	    expression result;
@@ -150,29 +176,23 @@ namespace Gold {
 	}
 
 	
-	expression operator-(const expression& lhs, const expression& rhs) {
-	    return lhs + (-rhs);
+	expression operator-(expression lhs, expression rhs) {
+	    return std::move(lhs) + (-std::move(rhs));
 	}
 
-	expression operator*(const expression& lhs, const expression& rhs) {
-	    return expression::commutative_operator(lhs, rhs, "*");
+	expression operator*(expression lhs, expression rhs) {
+	    return expression::commutative_operator(std::move(lhs), std::move(rhs), node::node_kind::multiply);
 	}
 	
-	expression operator/(const expression& lhs, const expression& rhs) {
-	    node::base_node::ptr left = node::base_node::ptr(lhs.root->clone());
-	    node::base_node::ptr right = node::base_node::ptr(rhs.root->clone());
-	    node::quotient::ptr result_node = std::make_unique<node::quotient>(*left, *right);
+	expression operator/(expression lhs, expression rhs) {
 	    expression result;
-	    result.root = std::move(result_node);
+	    result.root = std::make_unique<node::quotient>(std::move(lhs.root), std::move(rhs.root));
 	    return result;
 	}
 
-	expression pow(const expression& lhs, const expression& rhs) {
-	    node::base_node::ptr left = node::base_node::ptr(lhs.root->clone());
-	    node::base_node::ptr right = node::base_node::ptr(rhs.root->clone());
-	    node::power::ptr result_node = std::make_unique<node::power>(*left, *right);
+	expression pow(expression lhs, expression rhs) {
 	    expression result;
-	    result.root = std::move(result_node);
+	    result.root = std::make_unique<node::power>(std::move(lhs.root), std::move(rhs.root));
 	    return result;
 	}
 
@@ -183,5 +203,35 @@ namespace Gold {
 	    return result;
 	}
 	
+	std::ostream& operator<<(std::ostream& out, const expression& expr) {
+	    if (!expr.string_value.empty()) {
+		out << expr.string_value;
+	    }
+	    else if (expr.root) {
+		node::print(*expr.root, out);
+	    }
+	    return out;
+	}
+
+	result<expression> try_parse(std::string_view expr) {
+	    thread_local std::vector<parser::token> tokens;
+	    error_info failure { error_code::none, 0 };
+	    parser::tree_parser reader(expr, tokens, failure);
+	    if (!reader.check(failure)) {
+		return failure;
+	    }
+	    expression parsed;
+	    parsed.root = reader.parse();
+	    return std::move(parsed);
+	}
+
+	error_info validate(std::string_view expr) {
+	    thread_local std::vector<parser::token> tokens;
+	    error_info failure { error_code::none, 0 };
+	    parser::tree_parser reader(expr, tokens, failure);
+	    reader.check(failure);
+	    return failure;
+	}
+
     }
 }
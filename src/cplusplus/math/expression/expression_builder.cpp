@@ -0,0 +1,47 @@
+#include "Gold/math/expression_builder.hpp"
+#include <stdexcept>
+
+namespace Gold {
+    namespace math {
+
+	expression_builder::expression_builder(node::node_kind _operation) : operation(_operation) {
+	    if (operation != node::node_kind::add && operation != node::node_kind::multiply) {
+		throw std::invalid_argument("Expressions can only be built as sums or products");
+	    }
+	}
+
+	expression_builder& expression_builder::append(expression term) {
+	    if (!term.root) {
+		throw std::invalid_argument("Cannot build from an empty expression");
+	    }
+	    if (term.root->kind() == operation) {
+		node::operation& nested = static_cast<node::operation&>(*term.root);
+		for (auto iter = nested.begin(); iter != nested.end(); iter++) {
+		    children.push_back(std::move(*iter));
+		}
+	    }
+	    else {
+		children.push_back(std::move(term.root));
+	    }
+	    return *this;
+	}
+
+	expression expression_builder::finish() {
+	    expression result;
+	    if (children.empty()) {
+		result.root = std::make_unique<node::integer>(operation == node::node_kind::add ? 0 : 1);
+	    }
+	    else if (children.size() == 1) {
+		result.root = std::move(children.front());
+	    }
+	    else if (operation == node::node_kind::add) {
+		result.root = std::make_unique<node::add>(std::move(children));
+	    }
+	    else {
+		result.root = std::make_unique<node::multiply>(std::move(children));
+	    }
+	    children = node::base_node::vec();
+	    return result;
+	}
+    }
+}
@@ -0,0 +1,160 @@
+#include "Gold/math/formula_reader.hpp"
+#include "Gold/math/exception.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+
+namespace Gold {
+    namespace math {
+
+	namespace {
+
+	    bool is_blank(std::string_view line) {
+		return std::all_of(line.begin(), line.end(), [](char ch) {
+			return std::isspace(static_cast<unsigned char>(ch));
+		    });
+	    }
+	}
+
+	formula_reader::formula_reader(const std::string& path, std::size_t _chunk_size, bool _pipelined) :
+	    file(std::fopen(path.c_str(), "rb")), chunk_size(std::max<std::size_t>(_chunk_size, 1)),
+	    carried(0), line_number(0), exhausted(false), position(0), pipelined(_pipelined),
+	    pending_ready(false), pending_last(false), stopping(false) {
+	    if (!file) {
+		throw io_error("Could not open " + path + ": " + std::strerror(errno));
+	    }
+	    buffer.resize(chunk_size);
+	    if (pipelined) {
+		producer = std::thread([this]() { produce(); });
+	    }
+	}
+
+	formula_reader::~formula_reader() {
+	    if (producer.joinable()) {
+		{
+		    std::lock_guard<std::mutex> lock(mutex);
+		    stopping = true;
+		}
+		changed.notify_all();
+		producer.join();
+	    }
+	    std::fclose(file);
+	}
+
+	bool formula_reader::next(record& out) {
+	    while (position == current.size()) {
+		current.clear();
+		position = 0;
+		if (!pipelined) {
+		    if (!fill(current)) {
+			return false;
+		    }
+		    continue;
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		changed.wait(lock, [this]() { return pending_ready || pending_last; });
+		if (!pending_ready) {
+		    if (error) {
+			std::exception_ptr thrown = error;
+			error = nullptr;
+			std::rethrow_exception(thrown);
+		    }
+		    return false;
+		}
+		std::swap(current, pending);
+		pending_ready = false;
+		lock.unlock();
+		changed.notify_all();
+	    }
+	    out = std::move(current[position++]);
+	    return true;
+	}
+
+	bool formula_reader::fill(std::vector<record>& batch) {
+	    while (batch.empty()) {
+		if (exhausted) {
+		    return false;
+		}
+		if (carried == buffer.size()) {
+		    // A line longer than the buffer; grow to fit it
+		    buffer.resize(buffer.size() + chunk_size);
+		}
+		std::size_t read = std::fread(buffer.data() + carried, 1, buffer.size() - carried, file);
+		if (read < buffer.size() - carried) {
+		    if (std::ferror(file)) {
+			throw io_error("Could not read formula file");
+		    }
+		    exhausted = true;
+		}
+		std::size_t size = carried + read;
+
+		std::size_t begin = 0;
+		while (begin < size) {
+		    const char* newline = static_cast<const char*>(std::memchr(buffer.data() + begin, '\n', size - begin));
+		    if (!newline && !exhausted) {
+			break;
+		    }
+		    std::size_t end = newline ? std::size_t(newline - buffer.data()) : size;
+		    std::string_view line(buffer.data() + begin, end - begin);
+		    if (!line.empty() && line.back() == '\r') {
+			line.remove_suffix(1);
+		    }
+		    line_number++;
+		    if (!is_blank(line)) {
+			batch.push_back(record { line_number, expression(), "" });
+			try {
+			    batch.back().value = expression(line);
+			}
+			catch (const std::exception& e) {
+			    batch.back().error = e.what();
+			}
+		    }
+		    begin = end + 1;
+		}
+
+		// Keep the unfinished line at the front of the buffer for the next read
+		carried = begin < size ? size - begin : 0;
+		std::memmove(buffer.data(), buffer.data() + size - carried, carried);
+		if (carried < chunk_size && buffer.size() > chunk_size) {
+		    buffer.resize(chunk_size);
+		    buffer.shrink_to_fit();
+		}
+	    }
+	    return true;
+	}
+
+	void formula_reader::produce() {
+	    std::vector<record> batch;
+	    while (true) {
+		bool more;
+		try {
+		    more = fill(batch);
+		}
+		catch (...) {
+		    std::lock_guard<std::mutex> lock(mutex);
+		    error = std::current_exception();
+		    more = false;
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		if (!more) {
+		    pending_last = true;
+		    lock.unlock();
+		    changed.notify_all();
+		    return;
+		}
+		changed.wait(lock, [this]() { return !pending_ready || stopping; });
+		if (stopping) {
+		    return;
+		}
+		std::swap(pending, batch);
+		pending_ready = true;
+		lock.unlock();
+		changed.notify_all();
+		batch.clear();
+	    }
+	}
+    }
+}
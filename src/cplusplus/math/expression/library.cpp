@@ -0,0 +1,456 @@
+#include "Gold/math/library.hpp"
+#include "Gold/math/exception.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace Gold {
+    namespace math {
+
+	namespace {
+
+	    const char magic[8] = { 'G', 'o', 'l', 'd', 'L', 'i', 'b', ' ' };
+	    const std::uint32_t version = 1;
+
+	    /**********************************//**
+	    * Counts at the start of an image. The
+	    * sections follow in this order, each
+	    * aligned to 8 bytes.
+	    **************************************/
+	    struct header {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t expressions;
+		std::uint32_t nodes;
+		std::uint32_t slots;
+		std::uint32_t functions;
+		std::uint32_t strings;
+		std::uint64_t characters;
+	    };
+
+	    struct layout {
+		std::uint64_t expressions;
+		std::uint64_t nodes;
+		std::uint64_t slots;
+		std::uint64_t functions;
+		std::uint64_t string_offsets;
+		std::uint64_t characters;
+		std::uint64_t size;
+	    };
+
+	    std::uint64_t align(std::uint64_t offset) {
+		return (offset + 7) & ~std::uint64_t(7);
+	    }
+
+	    layout layout_of(const header& counts) {
+		layout result;
+		result.expressions = align(sizeof(header));
+		result.nodes = align(result.expressions + std::uint64_t(counts.expressions) * sizeof(image::flat_expression));
+		result.slots = align(result.nodes + std::uint64_t(counts.nodes) * sizeof(image::flat_node));
+		result.functions = align(result.slots + std::uint64_t(counts.slots) * sizeof(std::uint32_t));
+		result.string_offsets = align(result.functions + std::uint64_t(counts.functions) * sizeof(std::uint32_t));
+		result.characters = align(result.string_offsets + (std::uint64_t(counts.strings) + 1) * sizeof(std::uint32_t));
+		result.size = result.characters + counts.characters;
+		return result;
+	    }
+
+	    template<class T>
+	    void place(std::string& out, std::uint64_t offset, const std::vector<T>& items) {
+		if (!items.empty()) {
+		    std::memcpy(&out[offset], items.data(), items.size() * sizeof(T));
+		}
+	    }
+
+	    bool is_operation(std::uint32_t kind) {
+		return kind == std::uint32_t(node::node_kind::add) || kind == std::uint32_t(node::node_kind::multiply) ||
+		    kind == std::uint32_t(node::node_kind::power) || kind == std::uint32_t(node::node_kind::function);
+	    }
+
+	    [[noreturn]] void damaged(const char* what) {
+		throw invalid_encoding(std::string("Damaged expression image: ") + what);
+	    }
+	}
+
+	library_builder::library_builder() {
+	    //Intentionally empty
+	}
+
+	std::uint32_t library_builder::intern(const std::string& text) {
+	    auto found = string_index.emplace(text, std::uint32_t(strings.size()));
+	    if (found.second) {
+		strings.push_back(text);
+	    }
+	    return found.first->second;
+	}
+
+	std::uint32_t library_builder::intern_function(std::uint32_t name) {
+	    auto found = function_index.emplace(name, std::uint32_t(functions.size()));
+	    if (found.second) {
+		functions.push_back(name);
+	    }
+	    return found.first->second;
+	}
+
+	void library_builder::add(const std::string& name, const expression& expr) {
+	    if (!expr.root) {
+		throw std::invalid_argument("Cannot add an empty expression to a library");
+	    }
+	    std::uint32_t name_index = intern(name);
+	    if (!names.insert(name_index).second) {
+		throw std::invalid_argument(name + " is already in the library");
+	    }
+
+	    // Breadth first, so that the children of each node end up next to each other
+	    image::flat_expression entry { name_index, std::uint32_t(nodes.size()), 0, std::uint32_t(slots.size()), 0,
+		    expr.defined() ? 1u : 0u };
+	    std::unordered_map<std::string, std::uint32_t> slot_of;
+	    std::vector<const node::base_node*> order { expr.root.get() };
+	    nodes.push_back(image::flat_node());
+	    for (std::size_t i = 0; i < order.size(); i++) {
+		const node::base_node& current = *order[i];
+		image::flat_node flat { std::uint32_t(current.kind()), 0, 0, 0, 0, 0, 0.0 };
+		switch (current.kind()) {
+		case node::node_kind::integer:
+		    flat.value = static_cast<const node::integer&>(current).value();
+		    break;
+		case node::node_kind::number:
+		    flat.value = static_cast<const node::number&>(current).value();
+		    break;
+		case node::node_kind::variable: {
+		    const std::string& variable = static_cast<const node::variable&>(current).name();
+		    flat.name = intern(variable);
+		    auto slot = slot_of.emplace(variable, std::uint32_t(slot_of.size()));
+		    if (slot.second) {
+			slots.push_back(flat.name);
+		    }
+		    flat.slot = slot.first->second;
+		    break;
+		}
+		case node::node_kind::function:
+		    flat.name = intern(static_cast<const node::function&>(current).name());
+		    flat.slot = intern_function(flat.name);
+		    break;
+		default:
+		    break;
+		}
+		if (is_operation(flat.kind)) {
+		    const node::operation& op = static_cast<const node::operation&>(current);
+		    flat.arity = std::uint32_t(op.end() - op.begin());
+		    flat.first = std::uint32_t(nodes.size());
+		    for (auto iter = op.begin(); iter != op.end(); iter++) {
+			order.push_back(iter->get());
+			nodes.push_back(image::flat_node());
+		    }
+		}
+		nodes[entry.root + i] = flat;
+	    }
+	    entry.nodes = std::uint32_t(order.size());
+	    entry.slot_count = std::uint32_t(slot_of.size());
+	    expressions.push_back(entry);
+	}
+
+	std::string library_builder::image() const {
+	    std::vector<std::uint32_t> offsets { 0 };
+	    for (const std::string& text : strings) {
+		offsets.push_back(offsets.back() + std::uint32_t(text.size()));
+	    }
+
+	    // Sorted by name so that expression_library::find can binary search in place
+	    std::vector<image::flat_expression> sorted = expressions;
+	    std::sort(sorted.begin(), sorted.end(), [this](const image::flat_expression& lhs, const image::flat_expression& rhs) {
+		    return strings[lhs.name] < strings[rhs.name];
+		});
+
+	    header counts;
+	    std::memcpy(counts.magic, magic, sizeof(magic));
+	    counts.version = version;
+	    counts.expressions = std::uint32_t(sorted.size());
+	    counts.nodes = std::uint32_t(nodes.size());
+	    counts.slots = std::uint32_t(slots.size());
+	    counts.functions = std::uint32_t(functions.size());
+	    counts.strings = std::uint32_t(strings.size());
+	    counts.characters = offsets.back();
+	    layout sections = layout_of(counts);
+
+	    std::string out(sections.size, '\0');
+	    std::memcpy(&out[0], &counts, sizeof(counts));
+	    place(out, sections.expressions, sorted);
+	    place(out, sections.nodes, nodes);
+	    place(out, sections.slots, slots);
+	    place(out, sections.functions, functions);
+	    place(out, sections.string_offsets, offsets);
+	    std::uint64_t offset = sections.characters;
+	    for (const std::string& text : strings) {
+		out.replace(offset, text.size(), text);
+		offset += text.size();
+	    }
+	    return out;
+	}
+
+	void library_builder::write(const std::string& path) const {
+	    std::string contents = image();
+	    std::string temporary = path + ".tmp" + std::to_string(::getpid());
+	    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+	    if (!file) {
+		throw io_error("Could not open " + temporary + ": " + std::strerror(errno));
+	    }
+	    bool written = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+	    written = (std::fclose(file) == 0) && written;
+	    if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+		std::remove(temporary.c_str());
+		throw io_error("Could not write " + path);
+	    }
+	}
+
+	expression_library expression_library::open(const std::string& path) {
+	    std::unique_ptr<mapped_file> file = std::make_unique<mapped_file>(path);
+	    std::string_view image = file->view();
+	    return expression_library(std::move(file), image);
+	}
+
+	expression_library expression_library::from_image(std::string_view image) {
+	    return expression_library(nullptr, image);
+	}
+
+	expression_library::expression_library(std::unique_ptr<mapped_file> file, std::string_view image) : file(std::move(file)) {
+	    load(image);
+	}
+
+	void expression_library::load(std::string_view image) {
+	    if (reinterpret_cast<std::uintptr_t>(image.data()) % 8 != 0) {
+		throw std::invalid_argument("Expression images must be 8 byte aligned");
+	    }
+	    if (image.size() < sizeof(header)) {
+		damaged("too short");
+	    }
+	    const header& counts = *reinterpret_cast<const header*>(image.data());
+	    if (std::memcmp(counts.magic, magic, sizeof(magic)) != 0) {
+		throw invalid_encoding("Not an expression image");
+	    }
+	    if (counts.version != version) {
+		throw invalid_encoding("Unsupported expression image version");
+	    }
+	    layout sections = layout_of(counts);
+	    // Shared memory segments are usually rounded up to whole pages, so allow trailing space
+	    if (sections.size > image.size()) {
+		damaged("too short");
+	    }
+
+	    const char* base = image.data();
+	    expressions = reinterpret_cast<const image::flat_expression*>(base + sections.expressions);
+	    nodes = reinterpret_cast<const image::flat_node*>(base + sections.nodes);
+	    slots = reinterpret_cast<const std::uint32_t*>(base + sections.slots);
+	    functions = reinterpret_cast<const std::uint32_t*>(base + sections.functions);
+	    string_offsets = reinterpret_cast<const std::uint32_t*>(base + sections.string_offsets);
+	    characters = base + sections.characters;
+	    count = counts.expressions;
+	    string_count = counts.strings;
+
+	    // Every index is checked once here, so that evaluation can follow them blindly
+	    if (string_offsets[0] != 0 || string_offsets[string_count] != counts.characters) {
+		damaged("bad string table");
+	    }
+	    for (std::size_t i = 0; i < string_count; i++) {
+		if (string_offsets[i] > string_offsets[i + 1]) {
+		    damaged("bad string table");
+		}
+	    }
+	    for (std::size_t i = 0; i < counts.slots; i++) {
+		if (slots[i] >= string_count) {
+		    damaged("bad slot");
+		}
+	    }
+	    bound_functions.resize(counts.functions);
+	    for (std::size_t i = 0; i < counts.functions; i++) {
+		if (functions[i] >= string_count) {
+		    damaged("bad function");
+		}
+		bound_functions[i] = node::find_built_in(string(functions[i]));
+	    }
+	    for (std::size_t i = 0; i < count; i++) {
+		const image::flat_expression& entry = expressions[i];
+		if (entry.name >= string_count || entry.nodes == 0 || entry.root >= counts.nodes ||
+		    entry.nodes > counts.nodes - entry.root || entry.first_slot > counts.slots ||
+		    entry.slot_count > counts.slots - entry.first_slot) {
+		    damaged("bad expression");
+		}
+		if (i > 0 && !(string(expressions[i - 1].name) < string(entry.name))) {
+		    damaged("names out of order");
+		}
+		std::uint64_t end = std::uint64_t(entry.root) + entry.nodes;
+		for (std::uint32_t j = entry.root; j < end; j++) {
+		    const image::flat_node& flat = nodes[j];
+		    if (flat.kind > std::uint32_t(node::node_kind::variable)) {
+			damaged("bad node kind");
+		    }
+		    if (is_operation(flat.kind)) {
+			// Children strictly after their parent, so walks always terminate
+			if (flat.arity != 0 && (flat.first <= j || flat.first > end || flat.arity > end - flat.first)) {
+			    damaged("bad children");
+			}
+		    }
+		    else if (flat.arity != 0) {
+			damaged("leaf with children");
+		    }
+		    if (flat.kind == std::uint32_t(node::node_kind::variable) &&
+			(flat.name >= string_count || flat.slot >= entry.slot_count)) {
+			damaged("bad variable");
+		    }
+		    if (flat.kind == std::uint32_t(node::node_kind::function) &&
+			(flat.name >= string_count || flat.slot >= counts.functions)) {
+			damaged("bad function");
+		    }
+		}
+	    }
+	}
+
+	std::string_view expression_library::string(std::uint32_t index) const {
+	    return std::string_view(characters + string_offsets[index], string_offsets[index + 1] - string_offsets[index]);
+	}
+
+	std::string_view expression_library::name(std::size_t index) const {
+	    if (index >= count) {
+		throw std::out_of_range("No expression at that index in the library");
+	    }
+	    return string(expressions[index].name);
+	}
+
+	std::size_t expression_library::find(std::string_view name) const {
+	    std::size_t low = 0;
+	    std::size_t high = count;
+	    while (low < high) {
+		std::size_t middle = low + (high - low) / 2;
+		if (string(expressions[middle].name) < name) {
+		    low = middle + 1;
+		}
+		else {
+		    high = middle;
+		}
+	    }
+	    return (low < count && string(expressions[low].name) == name) ? low : npos;
+	}
+
+	double expression_library::evaluate(std::size_t index, const std::map<std::string, double>& args) const {
+	    if (index >= count) {
+		throw std::out_of_range("No expression at that index in the library");
+	    }
+	    const image::flat_expression& entry = expressions[index];
+	    if (!entry.defined) {
+		throw undefined_expression("Undefined evaluation");
+	    }
+
+	    // Look every variable up once, rather than at each of its nodes
+	    thread_local std::string key;
+	    const std::size_t small = 16;
+	    double stack_values[small];
+	    std::vector<double> heap_values;
+	    double* values = stack_values;
+	    if (entry.slot_count > small) {
+		heap_values.resize(entry.slot_count);
+		values = heap_values.data();
+	    }
+	    for (std::uint32_t i = 0; i < entry.slot_count; i++) {
+		key.assign(string(slots[entry.first_slot + i]));
+		auto found = args.find(key);
+		if (found == args.end()) {
+		    throw std::invalid_argument("Variable not found\n");
+		}
+		values[i] = found->second;
+	    }
+	    return evaluate_node(entry.root, values);
+	}
+
+	double expression_library::evaluate_node(std::uint32_t index, const double* values) const {
+	    const image::flat_node& flat = nodes[index];
+	    switch (node::node_kind(flat.kind)) {
+	    case node::node_kind::integer:
+	    case node::node_kind::number:
+		return flat.value;
+	    case node::node_kind::variable:
+		return values[flat.slot];
+	    case node::node_kind::add: {
+		if (flat.arity == 0) {
+		    throw invalid_node("Add node not initialized with children");
+		}
+		double sum = 0;
+		for (std::uint32_t i = 0; i < flat.arity; i++) {
+		    sum += evaluate_node(flat.first + i, values);
+		}
+		return sum;
+	    }
+	    case node::node_kind::multiply: {
+		if (flat.arity == 0) {
+		    throw invalid_node("multiply node not initialized with children");
+		}
+		double product = 1;
+		for (std::uint32_t i = 0; i < flat.arity; i++) {
+		    product *= evaluate_node(flat.first + i, values);
+		}
+		return product;
+	    }
+	    case node::node_kind::power:
+		if (flat.arity != 2) {
+		    throw invalid_node("Power node initialized with more or less than two children");
+		}
+		return std::pow(evaluate_node(flat.first, values), evaluate_node(flat.first + 1, values));
+	    case node::node_kind::function: {
+		if (flat.arity == 0) {
+		    throw invalid_node("Function node not initialized with children");
+		}
+		node::built_in_function function = bound_functions[flat.slot];
+		if (!function) {
+		    throw std::invalid_argument(std::string(string(flat.name)).append(" not found in functions"));
+		}
+		if (flat.arity != 1) {
+		    throw invalid_node("Built in functions take only one argument");
+		}
+		return function(evaluate_node(flat.first, values));
+	    }
+	    }
+	    return 0;
+	}
+
+	node::base_node::ptr expression_library::build_node(std::uint32_t index) const {
+	    const image::flat_node& flat = nodes[index];
+	    node::operation::ptr op;
+	    switch (node::node_kind(flat.kind)) {
+	    case node::node_kind::integer:
+		return std::make_unique<node::integer>(int(flat.value));
+	    case node::node_kind::number:
+		return std::make_unique<node::number>(flat.value);
+	    case node::node_kind::variable:
+		return std::make_unique<node::variable>(std::string(string(flat.name)));
+	    case node::node_kind::add:
+		op = std::make_unique<node::add>();
+		break;
+	    case node::node_kind::multiply:
+		op = std::make_unique<node::multiply>();
+		break;
+	    case node::node_kind::power:
+		op = std::make_unique<node::power>();
+		break;
+	    case node::node_kind::function:
+		op = std::make_unique<node::function>(std::string(string(flat.name)));
+		break;
+	    }
+	    op->getChildren().reserve(flat.arity);
+	    for (std::uint32_t i = 0; i < flat.arity; i++) {
+		op->append(build_node(flat.first + i));
+	    }
+	    return op;
+	}
+
+	expression expression_library::materialize(std::size_t index) const {
+	    if (index >= count) {
+		throw std::out_of_range("No expression at that index in the library");
+	    }
+	    expression result;
+	    result.root = build_node(expressions[index].root);
+	    return result;
+	}
+    }
+}
@@ -0,0 +1,148 @@
+#include "Gold/math/parse_cache.hpp"
+#include <cctype>
+
+namespace Gold {
+    namespace math {
+
+	namespace {
+
+	    bool joins_token(char ch) {
+		return std::isalnum(static_cast<unsigned char>(ch)) || ch == '_' || ch == '.';
+	    }
+
+	    // Whether key ends in a number and an e, signed or not, which would read as the start of
+	    // an exponent if the whitespace after it were dropped
+	    bool ends_in_exponent(const std::string& key) {
+		std::size_t end = key.size();
+		if (end > 0 && (key[end-1] == '+' || key[end-1] == '-')) {
+		    end--;
+		}
+		if (end == 0 || (key[end-1] != 'e' && key[end-1] != 'E')) {
+		    return false;
+		}
+		std::size_t begin = end - 1;
+		while (begin > 0 && joins_token(key[begin-1])) {
+		    begin--;
+		}
+		return std::isdigit(static_cast<unsigned char>(key[begin])) || key[begin] == '.';
+	    }
+
+	    void normalize_into(std::string_view source, std::string& key) {
+		key.clear();
+		for (std::size_t i = 0; i < source.size(); i++) {
+		    if (!std::isspace(static_cast<unsigned char>(source[i]))) {
+			key.push_back(source[i]);
+			continue;
+		    }
+		    while (i + 1 < source.size() && std::isspace(static_cast<unsigned char>(source[i+1]))) {
+			i++;
+		    }
+		    // Whitespace between two tokens that would otherwise merge is significant
+		    if (!key.empty() && i + 1 < source.size() &&
+			((joins_token(key.back()) && joins_token(source[i+1])) || ends_in_exponent(key))) {
+			key.push_back(' ');
+		    }
+		}
+	    }
+
+	    std::size_t count_nodes(const node::base_node& node) {
+		std::size_t count = 1;
+		if (const node::operation* op = dynamic_cast<const node::operation*>(&node)) {
+		    for (uint i = 0; i < op->size(); i++) {
+			count += count_nodes(op->child(i));
+		    }
+		}
+		return count;
+	    }
+
+	    std::size_t estimate_bytes(const std::string& key, const expression& expr, std::size_t nodes) {
+		// Nodes are small polymorphic objects, roughly a vtable, a child vector and a unique_ptr
+		// slot in their parent, plus allocator overhead
+		const std::size_t node_bytes = 64;
+		return sizeof(std::list<std::string>::value_type) + 2 * sizeof(void*) + key.capacity() +
+		    expr.string().capacity() + nodes * node_bytes;
+	    }
+	}
+
+	parse_cache::parse_cache(std::size_t capacity) :
+	    max_bytes(capacity), counters { 0, 0, 0, 0, 0 } {
+	    //Intentionally empty
+	}
+
+	parse_cache::handle parse_cache::get(std::string_view source) {
+	    thread_local std::string key;
+	    normalize_into(source, key);
+	    {
+		std::lock_guard<std::mutex> lock(mutex);
+		auto found = index.find(key);
+		if (found != index.end()) {
+		    counters.hits++;
+		    entries.splice(entries.begin(), entries, found->second);
+		    return found->second->value;
+		}
+		counters.misses++;
+	    }
+
+	    // Parse outside the lock so one slow formula does not stall every other lookup
+	    std::shared_ptr<expression> parsed = std::make_shared<expression>(source);
+	    std::size_t nodes = parsed->defined() ? count_nodes(*parsed->root) : 1;
+	    // Fill the string cache now, since string() is not safe to race on a shared expression
+	    parsed->string();
+
+	    std::lock_guard<std::mutex> lock(mutex);
+	    auto found = index.find(key);
+	    if (found != index.end()) {
+		// Another thread parsed the same source in the meantime
+		entries.splice(entries.begin(), entries, found->second);
+		return found->second->value;
+	    }
+	    entries.push_front(entry { key, parsed, 0 });
+	    entries.front().bytes = estimate_bytes(entries.front().key, *parsed, nodes);
+	    index.emplace(entries.front().key, entries.begin());
+	    counters.entries++;
+	    counters.bytes += entries.front().bytes;
+	    evict();
+	    return parsed;
+	}
+
+	parse_cache::statistics parse_cache::stats() const {
+	    std::lock_guard<std::mutex> lock(mutex);
+	    return counters;
+	}
+
+	std::size_t parse_cache::capacity() const {
+	    std::lock_guard<std::mutex> lock(mutex);
+	    return max_bytes;
+	}
+
+	void parse_cache::set_capacity(std::size_t capacity) {
+	    std::lock_guard<std::mutex> lock(mutex);
+	    max_bytes = capacity;
+	    evict();
+	}
+
+	void parse_cache::clear() {
+	    std::lock_guard<std::mutex> lock(mutex);
+	    index.clear();
+	    entries.clear();
+	    counters = statistics { 0, 0, 0, 0, 0 };
+	}
+
+	std::string parse_cache::normalize(std::string_view source) {
+	    std::string key;
+	    normalize_into(source, key);
+	    return key;
+	}
+
+	void parse_cache::evict() {
+	    while (counters.bytes > max_bytes && !entries.empty()) {
+		const entry& oldest = entries.back();
+		counters.bytes -= oldest.bytes;
+		counters.entries--;
+		counters.evictions++;
+		index.erase(oldest.key);
+		entries.pop_back();
+	    }
+	}
+    }
+}
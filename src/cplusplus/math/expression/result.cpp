@@ -0,0 +1,24 @@
+#include "Gold/math/result.hpp"
+
+namespace Gold {
+    namespace math {
+
+	const char* describe(error_code code) {
+	    switch (code) {
+	    case error_code::none: return "No error";
+	    case error_code::empty_expression: return "Cannot parse an empty expression";
+	    case error_code::unexpected_character: return "Unexpected character";
+	    case error_code::unexpected_token: return "Unexpected token";
+	    case error_code::unexpected_end: return "Unexpected end of expression";
+	    case error_code::mismatched_brackets: return "Mismatched parentheses";
+	    case error_code::literal_out_of_range: return "Number out of range";
+	    case error_code::undefined_expression: return "Undefined evaluation";
+	    case error_code::variable_not_found: return "Variable not found";
+	    case error_code::function_not_found: return "Function not found";
+	    case error_code::wrong_argument_count: return "Built in functions take only one argument";
+	    case error_code::invalid_node: return "Node not initialized correctly";
+	    }
+	    return "Unknown error";
+	}
+    }
+}
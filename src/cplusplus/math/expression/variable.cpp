@@ -12,7 +12,7 @@ namespace Gold {
 
 	variable::variable(const variable& other) : expression(other) { }
 
-	variable::variable(variable&& other) : expression(other) { }
+	variable::variable(variable&& other) : expression(std::move(other)) { }
 
 	variable& variable::operator=(const variable& other) {
 	    if (&other != this) {
@@ -23,9 +23,8 @@ namespace Gold {
 
 	variable& variable::operator=(variable&& other) {
 	    if (&other != this) {
-		expression::operator=(other);
+		expression::operator=(std::move(other));
 	    }
-	    expression::operator=(other);
 	    return *this;
 	}
 
@@ -19,11 +19,15 @@ namespace Gold {
 	    if (values.size() != this->variables.size() ) {
 		throw std::length_error("Incorrect number of variables");
 	    }
-	    std::map<std::string, double> changes;
-	    for (std::size_t i = 0; i != values.size(); i++) {
-		changes.insert( std::pair<std::string, double>(this->variables[i].string(), values[i]) );
+	    if (!compiled) {
+		std::vector<std::string> names;
+		names.reserve(this->variables.size());
+		for (const variable& var : this->variables) {
+		    names.push_back(var.string());
+		}
+		compiled = rule.compile().bind(names);
 	    }
-	    return rule.evaluate(changes);	    
+	    return compiled->evaluate(values.data());
 	}   
     }
 }
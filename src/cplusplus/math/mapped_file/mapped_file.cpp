@@ -0,0 +1,43 @@
+#include "Gold/math/mapped_file.hpp"
+#include "Gold/math/exception.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Gold {
+    namespace math {
+
+	mapped_file::mapped_file(const std::string& path, bool required) : bytes(nullptr), length(0) {
+	    int descriptor = ::open(path.c_str(), O_RDONLY);
+	    if (descriptor < 0) {
+		if (required) {
+		    throw io_error("Could not open " + path + ": " + std::strerror(errno));
+		}
+		return;
+	    }
+	    struct stat status;
+	    if (::fstat(descriptor, &status) == 0 && status.st_size > 0) {
+		void* mapped = ::mmap(nullptr, std::size_t(status.st_size), PROT_READ, MAP_SHARED, descriptor, 0);
+		if (mapped != MAP_FAILED) {
+		    bytes = static_cast<const unsigned char*>(mapped);
+		    length = std::size_t(status.st_size);
+		}
+		else if (required) {
+		    int error = errno;
+		    ::close(descriptor);
+		    throw io_error("Could not map " + path + ": " + std::strerror(error));
+		}
+	    }
+	    ::close(descriptor);
+	}
+
+	mapped_file::~mapped_file() {
+	    if (bytes) {
+		::munmap(const_cast<unsigned char*>(bytes), length);
+	    }
+	}
+    }
+}
@@ -1,10 +1,11 @@
 #include "Gold/math/node.hpp"
+#include "Gold/math/parser.hpp"
+#include "Gold/math/printer.hpp"
 #include "Gold/math/utils.hpp"
 #include "Gold/math/exception.hpp"
-#include <boost/algorithm/string.hpp>
-#include <boost/algorithm/string/join.hpp>
-#include <boost/algorithm/string/split.hpp>
+#include <charconv>
 #include <cmath>
+#include <cctype>
 #include <iostream>
 #include <iterator>
 
@@ -51,20 +52,29 @@ namespace Gold {
 		return *this;
 	    }
 			
-	    base_node::ptr base_node::numerator() const {
-		return base_node::ptr(this->clone());
+	    namespace {
+		// Shared by the views of nodes whose numerator, denominator or exponent is implicitly 1.
+		// A local static, so that it is usable from other files' static initializers.
+		const integer& implicit_one() {
+		    static const integer one(1);
+		    return one;
+		}
+	    }
+
+	    const base_node& base_node::numerator() const {
+		return *this;
 	    }
 
-	    base_node::ptr base_node::denominator() const {
-		return std::make_unique<integer>(1);
+	    const base_node& base_node::denominator() const {
+		return implicit_one();
 	    }
 
-	    base_node::ptr base_node::base() const {
-		return base_node::ptr(this->clone());
+	    const base_node& base_node::base() const {
+		return *this;
 	    }
 
-	    base_node::ptr base_node::exponent() const {
-		return std::make_unique<integer>(1);
+	    const base_node& base_node::exponent() const {
+		return implicit_one();
 	    }
 
 	    inverse::ptr inverse::make_inverse(const base_node& denominator) {
@@ -74,11 +84,22 @@ namespace Gold {
 		return inverse_node;
 	    }
 
-	    base_node::ptr inverse::denominator() const {
+	    inverse::ptr inverse::make_inverse(base_node::ptr denominator) {
+		inverse::ptr inverse_node = std::make_unique<inverse>();
+		inverse_node->append( std::move(denominator) );
+		inverse_node->append( std::make_unique<integer>(-1) );
+		return inverse_node;
+	    }
+
+	    const base_node& inverse::numerator() const {
+		return implicit_one();
+	    }
+
+	    const base_node& inverse::denominator() const {
 		if (size() != 2) {
 		    throw invalid_node("inverse node not initialized correctly");
 		}
-		return base_node::ptr(child(0).clone());
+		return child(0);
 	    }
 	    
 	    quotient::quotient(const base_node& numerator, const base_node& denominator) {
@@ -86,19 +107,24 @@ namespace Gold {
 		append( inverse::make_inverse(denominator) );
 	    }
 
-	    base_node::ptr quotient::numerator() const { 
+	    quotient::quotient(base_node::ptr numerator, base_node::ptr denominator) {
+		append( std::move(numerator) );
+		append( inverse::make_inverse(std::move(denominator)) );
+	    }
+
+	    const base_node& quotient::numerator() const { 
 		if (size() != 2) {
 		    throw invalid_node("Quotient node not initialized correctly");
 		}
-		return base_node::ptr( child(0).clone() ); 
+		return child(0); 
 	    }
 	    
-	    base_node::ptr quotient::denominator() const { 
+	    const base_node& quotient::denominator() const { 
 		if ( size() != 2 || child(1).size() != 2) {
 		    throw invalid_node("Quotient node not initialized correctly");
 		}
-		operation& power_node = static_cast<operation&>(child(1)); 
-		return base_node::ptr( power_node.child(0).clone() );
+		const operation& power_node = static_cast<const operation&>(child(1)); 
+		return power_node.child(0);
 	    }
 	    
 	    rational::rational(int numerator, int denominator) {
@@ -138,26 +164,31 @@ namespace Gold {
 		append( std::unique_ptr<base_node>(exponent.clone()));
 	    }
 
-	    base_node::ptr power::base() const { 
+	    power::power(base_node::ptr base, base_node::ptr exponent) {
+		append( std::move(base) );
+		append( std::move(exponent) );
+	    }
+
+	    const base_node& power::base() const { 
 		if (is_leaf()) {
 		    throw invalid_node("Power node not initialized with children");
 		}
-		return base_node::ptr( child(0).clone() ); 
+		return child(0); 
 	    }
 
-	    base_node::ptr power::exponent() const {
+	    const base_node& power::exponent() const {
 		if (is_leaf()) {
 		    throw invalid_node("Power node not initialized with children");
 		}
-		return base_node::ptr( child(1).clone() ); 
+		return child(1); 
 	    }
 
 	    double power::evaluate(const std::map<std::string, double>& args) const {
 		if (size() != 2) {
 			throw invalid_node("Power node initialized with more or less than two children");
 		}
-		double base = this->base()->evaluate(args);
-		double expo = this->exponent()->evaluate(args);	
+		double base = child(0).evaluate(args);
+		double expo = child(1).evaluate(args);	
 		return std::pow(base, expo);
 	    }
 
@@ -165,94 +196,163 @@ namespace Gold {
 		if (is_leaf()) {
 			throw invalid_node("Function node not initialized with children");
 		}
-		if ( built_in_functions.find(get_token()) != built_in_functions.end()) {
-		    if (size() != 1) {
-			throw invalid_node("Built in functions take only one argument");
-		    }
-		    else {
-			double value = child(0).evaluate(args);
-			return built_in_functions.at(get_token())(value);
-		    }
+		if (!kernel) {
+		    throw std::invalid_argument(token + " not found in functions");
 		}
-		else {
-		    throw std::invalid_argument(get_token().append(" not found in functions"));
+		if (size() != 1) {
+		    throw invalid_node("Built in functions take only one argument");
 		}
-		return 0;
+		return kernel(child(0).evaluate(args));
 	    }
 
 	    double integer::evaluate(const std::map<std::string, double>& args) const {
 		return token;
 	    }
 	    
+	    number::number(const std::string& _token) {
+		// Accepts what std::stod would, but always at full precision and independent of locale
+		const char* first = _token.data();
+		const char* last = first + _token.size();
+		while (first != last && std::isspace(static_cast<unsigned char>(*first))) {
+		    first++;
+		}
+		if (first != last && *first == '+') {
+		    first++;
+		}
+		std::from_chars_result parsed = std::from_chars(first, last, token);
+		if (parsed.ec == std::errc::invalid_argument) {
+		    throw std::invalid_argument(std::string("Cannot make a number from ").append(_token));
+		}
+		if (parsed.ec == std::errc::result_out_of_range) {
+		    throw std::out_of_range(_token + " is out of range for a number");
+		}
+	    }
+
+	    std::string number::get_token() const {
+		// The shortest text that reads back as exactly the same double
+		char buffer[32];
+		std::to_chars_result printed = std::to_chars(buffer, buffer + sizeof(buffer), token);
+		return std::string(buffer, printed.ptr);
+	    }
+
 	    double number::evaluate(const std::map<std::string, double>& args) const {
 		return token;
 	    }
 	    
 	    double variable::evaluate(const std::map<std::string, double>& args) const {
 		auto iter = args.find(token);
-		if (args.find(token) == args.end() ) {
+		if (iter == args.end()) {
 		    throw std::invalid_argument("Variable not found\n");
 		}
 		return iter->second;
 	    }
 
-	    /******************************************************
-	     * Build string operations
-	     *****************************************************/
-	    std::string add::string() const {
+	    /*************************************************
+	     *
+	     * Definitions of try_evaluate
+	     *
+	     ************************************************/
+	    error_code add::try_evaluate(const std::map<std::string, double>& args, double& value) const {
 		if (is_leaf()) {
-		    return "";
+		    return error_code::invalid_node;
 		}
-		std::string token = get_token();
-		std::string first = child(0).string();
-		for (auto iter = begin()+1; iter != end(); iter++) {
-		    Gold::math::utils::append_with_parens(first, (*iter)->string(), token, true);
+		double sum = 0;
+		for (auto iter = begin(); iter != end(); iter++) {
+		    double term;
+		    error_code code = (*iter)->try_evaluate(args, term);
+		    if (code != error_code::none) {
+			return code;
+		    }
+		    sum += term;
 		}
-		return first;
+		value = sum;
+		return error_code::none;
 	    }
-	    
-	    std::string multiply::string() const {
+
+	    error_code multiply::try_evaluate(const std::map<std::string, double>& args, double& value) const {
 		if (is_leaf()) {
-		    return "";
+		    return error_code::invalid_node;
 		}
-		std::string token = get_token();
-		std::string first = child(0).string();
-		if (child(0).get_token() == "+") {
-		    first = std::string("(").append(first).append(")");
-		}
-		for (auto iter = begin()+1; iter != end(); iter++) {
-		    Gold::math::utils::append_with_parens(first, (*iter)->string(), token, true);
+		double product = 1;
+		for (auto iter = begin(); iter != end(); iter++) {
+		    double factor;
+		    error_code code = (*iter)->try_evaluate(args, factor);
+		    if (code != error_code::none) {
+			return code;
+		    }
+		    product *= factor;
 		}
-		return first;
+		value = product;
+		return error_code::none;
 	    }
 
-	    std::string power::string() const {
-		if (is_leaf()) {
-		    return "";
+	    error_code power::try_evaluate(const std::map<std::string, double>& args, double& value) const {
+		if (size() != 2) {
+		    return error_code::invalid_node;
 		}
-		std::string token = get_token();
-		std::string first = child(0).string();
-		if (child(0).get_token() == "+" || child(0).get_token() == "*" || child(0).get_token() == "^") {
-		    first = std::string("(").append(first).append(")");
+		double base;
+		double expo;
+		error_code code = child(0).try_evaluate(args, base);
+		if (code == error_code::none) {
+		    code = child(1).try_evaluate(args, expo);
 		}
-		for (auto iter = begin()+1; iter != end(); iter++) {
-		    Gold::math::utils::append_with_parens(first, (*iter)->string(), token, true);
+		if (code == error_code::none) {
+		    value = std::pow(base, expo);
 		}
-		return first;
+		return code;
 	    }
 
-	    std::string function::string() const {
+	    error_code function::try_evaluate(const std::map<std::string, double>& args, double& value) const {
 		if (is_leaf()) {
-		    return "";
+		    return error_code::invalid_node;
 		}
-		
-		std::string str = get_token().append("[");
-		std::vector<std::string> subStrings;
-		subStrings.reserve(size());
-		for (auto iter = begin(); iter != end(); iter++) {
-		    subStrings.push_back( (*iter)->string() );
+		if (!kernel) {
+		    return error_code::function_not_found;
+		}
+		if (size() != 1) {
+		    return error_code::wrong_argument_count;
 		}
-		str.append( boost::algorithm::join(subStrings, ", ") ).append("]");
+		double argument;
+		error_code code = child(0).try_evaluate(args, argument);
+		if (code == error_code::none) {
+		    value = kernel(argument);
+		}
+		return code;
+	    }
+
+	    error_code variable::try_evaluate(const std::map<std::string, double>& args, double& value) const {
+		auto iter = args.find(token);
+		if (iter == args.end()) {
+		    return error_code::variable_not_found;
+		}
+		value = iter->second;
+		return error_code::none;
+	    }
+
+	    /******************************************************
+	     * Build string operations
+	     *****************************************************/
+	    std::string add::string() const {
+		std::string str;
+		print(*this, str);
+		return str;
+	    }
+	    
+	    std::string multiply::string() const {
+		std::string str;
+		print(*this, str);
+		return str;
+	    }
+
+	    std::string power::string() const {
+		std::string str;
+		print(*this, str);
+		return str;
+	    }
+
+	    std::string function::string() const {
+		std::string str;
+		print(*this, str);
 		return str;
 	    }
 
@@ -309,29 +409,29 @@ namespace Gold {
 		    return std::make_unique<integer>(0);
 		}
 		
-		base_node::ptr base_prime = this->base()->derivative(var);
-		base_node::ptr expo_prime = this->exponent()->derivative(var);
+		base_node::ptr base_prime = this->base().derivative(var);
+		base_node::ptr expo_prime = this->exponent().derivative(var);
 		multiply::ptr derivative = std::make_unique<multiply>();
 		if (base_prime->is_zero() && expo_prime->is_zero()) {
 		    return std::make_unique<integer>(0);
 		}
 		else if (expo_prime->is_zero()) {
 		    power::ptr power_node = std::make_unique<power>();
-		    power_node->append(this->base());
+		    power_node->append_clone(this->base());
 		    add::ptr exponent_node = std::make_unique<add>();
-		    exponent_node->append(this->exponent());
+		    exponent_node->append_clone(this->exponent());
 		    exponent_node->append(std::make_unique<integer>(-1));
 		    power_node->append(std::move(exponent_node));
 		    derivative->append(std::move(power_node));
 		    
-		    derivative->append(this->exponent());
+		    derivative->append_clone(this->exponent());
 		    derivative->append(std::move(base_prime));
 		    return std::move(derivative);
 		}
 		else if (base_prime->is_zero()) {
 		    derivative->append_clone(*this);
 		    function::ptr function_node = std::make_unique<function>("Ln");
-		    function_node->append(this->base());
+		    function_node->append_clone(this->base());
 		    derivative->append(std::move(function_node));
 		    derivative->append(std::move(expo_prime));
 		    return std::move(derivative);
@@ -342,14 +442,14 @@ namespace Gold {
 		    add::ptr sub_parts = std::make_unique<add>();
 		    
 		    multiply::ptr lhs = std::make_unique<multiply>();
-		    lhs->append(this->exponent());
+		    lhs->append_clone(this->exponent());
 		    lhs->append(std::move(base_prime));
-		    lhs->append(inverse::make_inverse(*(this->base())));
+		    lhs->append(inverse::make_inverse(this->base()));
 		    sub_parts->append(std::move(lhs));
 		    
 		    multiply::ptr rhs = std::make_unique<multiply>();
 		    function::ptr logarithm = std::make_unique<function>("Ln");
-		    logarithm->append(this->base());
+		    logarithm->append_clone(this->base());
 		    rhs->append(std::move(logarithm));
 		    rhs->append(std::move(expo_prime));
 		    sub_parts->append(std::move(rhs));
@@ -367,16 +467,10 @@ namespace Gold {
 		    throw std::invalid_argument("Not implemented yet");
 		}
 		
-		if (built_in_derivatives.find(this->get_token()) == built_in_derivatives.end()) {
-		    throw std::invalid_argument(std::string("Derivative not implemented for ").append(get_token()));
+		base_node::ptr derivative = built_in_derivative(name(), child(0));
+		if (!derivative) {
+		    throw std::invalid_argument(std::string("Derivative not implemented for ").append(name()));
 		}
-
-		base_node::ptr derivative = base_node::ptr(built_in_derivatives.at(this->get_token())->clone());
-		
-		std::map<std::string, base_node::ptr> change;
-		change.insert(std::pair<std::string, base_node::ptr>("__", base_node::ptr(child(0).clone())));
-		
-		derivative = derivative->change_variables(change);
 		
 		base_node::ptr chain_derivative = child(0).derivative(var);
 		if ( chain_derivative->is_zero() || derivative->is_zero() ) {
@@ -513,126 +607,225 @@ namespace Gold {
 	    }
 
 	    base_node::ptr make_leaf_node(const std::string& str) {
-		if (utils::find_lowest_priority(str) != -1) {
+		base_node::ptr leaf = make_tree(str);
+		if (!leaf->is_leaf()) {
 		    throw std::invalid_argument(std::string("Cannot make a leaf node from given string: ").append(str));
 		}
-		node::base_node::ptr leaf;
-		if (utils::is_string_integer(str)) {
-		    leaf = std::make_unique<node::integer>(str);
-		}
-		else if (utils::is_string_num(str)) {
-		    leaf = std::make_unique<node::number>(str);
-		}
-		else {
-		    leaf = std::make_unique<node::variable>(str);
-		}
 		return leaf;
 	    }
 
 	    base_node::ptr make_function_node(const std::string& str) {
-		if (utils::find_lowest_priority(str) != -2) {
+		base_node::ptr tree = make_tree(str);
+		if (dynamic_cast<function*>(tree.get()) == nullptr) {
 		    throw std::invalid_argument(std::string("Cannot make a function node from given string: ").append(str));
 		}
-		std::string newStr( str.substr(str.find("[")+1, str.size()-2-str.find("[")) );
-		std::string funcName(str.substr(0,str.find("[")));
+		return tree;
+	    }
+
+	    base_node::ptr make_tree(std::string_view str) {
+		// Reusing the token buffer leaves the nodes as the only allocations in a parse
+		thread_local std::vector<parser::token> tokens;
+		return parser::tree_parser(str, tokens).parse();
+	    }
 
-		std::vector<std::string> subStrings;
-		boost::split(subStrings, newStr, boost::is_any_of(","));
-		base_node::vec subExpressions;
-		subExpressions.reserve(subStrings.size());
+	    namespace {
 
-		for (auto iter = subStrings.begin(); iter != subStrings.end(); iter++) {
-		    subExpressions.push_back(make_tree(*iter));
+		/*****************************************************************************************//**
+		* Helpers for the derivative rules below. Each builds exactly the nodes the parser would
+		* build for the matching piece of formula, so a rule applied to an argument gives the same
+		* tree as parsing the formula and substituting the argument in.
+		*********************************************************************************************/
+		template <class Node, class... Children>
+		base_node::ptr build(Children... children) {
+		    auto node = std::make_unique<Node>();
+		    node->getChildren().reserve(sizeof...(children));
+		    (node->append(std::move(children)), ...);
+		    return node;
 		}
-		return std::make_unique<function>(funcName, subExpressions);
-	    }
 
-	    base_node::ptr make_tree(std::string str) {
-		str = utils::remove_enclosing_parens(str);
-		if (utils::is_string_num(str)) {
-		    return make_leaf_node(str);
+		base_node::ptr copy(const base_node& argument) {
+		    return base_node::ptr(argument.clone());
 		}
-		else if (utils::is_function(str)) {
-		    return make_function_node(str);
+
+		base_node::ptr literal(int value) {
+		    return std::make_unique<integer>(value);
 		}
-		int index = utils::find_lowest_priority(str);
-		if ( index == -1) {
-		    if (str[0] == '-') {
-			str = str.substr(1, str.size()-1);
-			str = std::string("(-1)*(").append(str).append(")");
-			index = 4;
-		    }
-		    else {
-			return make_leaf_node(str);
-		    }
-		}	   
-		std::string operation(1, str[index]);		
-		base_node::ptr tree;
-		if (operation == "+" || 
-		    operation == "-" || 
-		    operation == "*" || 
-		    operation == "/") {
-		    std::vector<std::string> subStrings;
-		    utils::break_string(str, operation, subStrings);
-		    
-		    base_node::vec subTrees;
-		    if (subStrings.size() == 2 && operation == "-" && subStrings[0] == "0") {
-			subTrees.push_back(std::make_unique<integer>(-1));
-			subTrees.push_back(make_tree(subStrings[1]));
-			tree = std::make_unique<multiply>(subTrees );
-		    }
-		    else if (subStrings.size() == 2 && operation == "/" && subStrings[0] == "1") {
-			tree = make_tree(subStrings[1]);
+
+		base_node::ptr call(const char* name, base_node::ptr argument) {
+		    function::ptr node = std::make_unique<function>(name);
+		    node->append(std::move(argument));
+		    return node;
+		}
+
+		base_node::ptr call(const char* name, const base_node& argument) {
+		    return call(name, copy(argument));
+		}
+
+		base_node::ptr raise(base_node::ptr base, base_node::ptr exponent) {
+		    return build<power>(std::move(base), std::move(exponent));
+		}
+
+		// 1/x
+		base_node::ptr reciprocal(base_node::ptr node) {
+		    return raise(std::move(node), literal(-1));
+		}
+
+		// x^(1/2), which parses as x^(2^(-1))
+		base_node::ptr square_root(base_node::ptr node) {
+		    return raise(std::move(node), reciprocal(literal(2)));
+		}
+
+		// -x
+		base_node::ptr negate(base_node::ptr node) {
+		    return build<multiply>(literal(-1), std::move(node));
+		}
+
+		// -1*x*..., where the literal -1 parses as -1*1
+		template <class... Factors>
+		base_node::ptr negative_product(Factors... factors) {
+		    return build<multiply>(literal(-1), literal(1), std::move(factors)...);
+		}
+
+		// argument+term, splicing in the terms of argument the way change_variables does
+		base_node::ptr sum(const base_node& argument, base_node::ptr term) {
+		    add::ptr node = std::make_unique<add>();
+		    if (argument.kind() == node_kind::add) {
+			const add& terms = static_cast<const add&>(argument);
+			node->getChildren().reserve(terms.size() + 1);
+			for (auto iter = terms.begin(); iter != terms.end(); iter++) {
+			    node->append_clone(**iter);
+			}
 		    }
 		    else {
-			subTrees.reserve(subStrings.size());
-			for (auto iter = subStrings.begin(); iter != subStrings.end(); iter++) {
-			    subTrees.push_back(make_tree(*iter));
-			}
-			if (operation == "+" || operation == "-") {
-			    tree = std::make_unique<add>(subTrees);
-			}
-			else {
-			    tree = std::make_unique<multiply>(subTrees);
-			}
+			node->append(copy(argument));
 		    }
-		}
-		// Power node
-		else {
-		    std::string substr1(str.substr(0,index));
-		    std::string substr2(str.substr(index+1,str.size()-index));
-		    tree = std::make_unique<power>(*make_tree(substr1), *make_tree(substr2));
-		}
-		return tree;
+		    node->append(std::move(term));
+		    return node;
+		}
+
+		base_node::ptr square(const base_node& argument) {
+		    return raise(copy(argument), literal(2));
+		}
+
+		struct derivative_rule {
+		    std::string_view name;
+		    base_node::ptr (*build)(const base_node& u);
+		};
+
+		// Sorted by name
+		constexpr derivative_rule derivative_rules[] = {
+		    // -1/(1-u^2)^(1/2)
+		    {"ArcCos", [](const base_node& u) {
+			    return negative_product(reciprocal(square_root(build<add>(literal(1), negate(square(u))))));
+			}},
+		    // 1/((u-1)^(1/2)*(u+1)^(1/2))
+		    {"ArcCosh", [](const base_node& u) {
+			    return build<multiply>(literal(1),
+						   reciprocal(square_root(sum(u, build<multiply>(literal(-1), literal(1))))),
+						   reciprocal(square_root(sum(u, literal(1)))));
+			}},
+		    // 1/(1-u^2)^(1/2)
+		    {"ArcSin", [](const base_node& u) {
+			    return reciprocal(square_root(build<add>(literal(1), negate(square(u)))));
+			}},
+		    // 1/(1+u^2)^(1/2)
+		    {"ArcSinh", [](const base_node& u) {
+			    return reciprocal(square_root(build<add>(literal(1), square(u))));
+			}},
+		    // 1/(1+u^2)
+		    {"ArcTan", [](const base_node& u) {
+			    return reciprocal(build<add>(literal(1), square(u)));
+			}},
+		    // 1/(1-u^2)
+		    {"ArcTanh", [](const base_node& u) {
+			    return reciprocal(build<add>(literal(1), negate(square(u))));
+			}},
+		    // The same rules, spelled as built_in_functions spells them
+		    {"Arccos", [](const base_node& u) { return built_in_derivative("ArcCos", u); }},
+		    {"Arccosh", [](const base_node& u) { return built_in_derivative("ArcCosh", u); }},
+		    {"Arcsin", [](const base_node& u) { return built_in_derivative("ArcSin", u); }},
+		    {"Arcsinh", [](const base_node& u) { return built_in_derivative("ArcSinh", u); }},
+		    {"Arctan", [](const base_node& u) { return built_in_derivative("ArcTan", u); }},
+		    {"Arctanh", [](const base_node& u) { return built_in_derivative("ArcTanh", u); }},
+		    {"Cos", [](const base_node& u) { return negative_product(call("Sin", u)); }},
+		    {"Cosh", [](const base_node& u) { return call("Sinh", u); }},
+		    {"Cot", [](const base_node& u) { return negative_product(raise(call("Csc", u), literal(2))); }},
+		    {"Coth", [](const base_node& u) { return negative_product(raise(call("Csch", u), literal(2))); }},
+		    {"Csc", [](const base_node& u) { return negative_product(call("Cot", u), call("Csc", u)); }},
+		    {"Csch", [](const base_node& u) { return negative_product(call("Coth", u), call("Csch", u)); }},
+		    {"Exp", [](const base_node& u) { return call("Exp", u); }},
+		    {"Ln", [](const base_node& u) { return reciprocal(copy(u)); }},
+		    // 1/(u*Ln[10])
+		    {"Log", [](const base_node& u) {
+			    return build<multiply>(literal(1), reciprocal(copy(u)), reciprocal(call("Ln", literal(10))));
+			}},
+		    {"Sec", [](const base_node& u) { return build<multiply>(call("Sec", u), call("Tan", u)); }},
+		    {"Sech", [](const base_node& u) { return negative_product(call("Sech", u), call("Tanh", u)); }},
+		    {"Sin", [](const base_node& u) { return call("Cos", u); }},
+		    {"Sinh", [](const base_node& u) { return call("Cosh", u); }},
+		    {"Tan", [](const base_node& u) { return raise(call("Sec", u), literal(2)); }},
+		    {"Tanh", [](const base_node& u) { return raise(call("Sech", u), literal(2)); }}
+		};
+	    }
+
+	    namespace {
+
+		struct built_in {
+		    std::string_view name;
+		    built_in_function implementation;
+		};
+
+		// Sorted by name. Inverse functions answer to both of their spellings.
+		constexpr built_in built_ins[] = {
+		    {"Abs", [](double x) { return std::fabs(x); }},
+		    {"ArcCos", [](double x) { return std::acos(x); }},
+		    {"ArcCosh", [](double x) { return std::acosh(x); }},
+		    {"ArcSin", [](double x) { return std::asin(x); }},
+		    {"ArcSinh", [](double x) { return std::asinh(x); }},
+		    {"ArcTan", [](double x) { return std::atan(x); }},
+		    {"ArcTanh", [](double x) { return std::atanh(x); }},
+		    {"Arccos", [](double x) { return std::acos(x); }},
+		    {"Arccosh", [](double x) { return std::acosh(x); }},
+		    {"Arcsin", [](double x) { return std::asin(x); }},
+		    {"Arcsinh", [](double x) { return std::asinh(x); }},
+		    {"Arctan", [](double x) { return std::atan(x); }},
+		    {"Arctanh", [](double x) { return std::atanh(x); }},
+		    {"Cos", [](double x) { return std::cos(x); }},
+		    {"Cosh", [](double x) { return std::cosh(x); }},
+		    {"Cot", [](double x) { return std::cos(x) / std::sin(x); }},
+		    {"Coth", [](double x) { return std::cosh(x) / std::sinh(x); }},
+		    {"Csc", [](double x) { return 1.0 / std::sin(x); }},
+		    {"Csch", [](double x) { return 1.0 / std::sinh(x); }},
+		    {"Exp", [](double x) { return std::exp(x); }},
+		    {"H", [](double x) { return (x < 0) ? 0.0 : 1.0; }},
+		    {"Ln", [](double x) { return std::log(x); }},
+		    {"Log", [](double x) { return std::log10(x); }},
+		    {"Sec", [](double x) { return 1.0 / std::cos(x); }},
+		    {"Sech", [](double x) { return 1.0 / std::cosh(x); }},
+		    {"Sin", [](double x) { return std::sin(x); }},
+		    {"Sinh", [](double x) { return std::sinh(x); }},
+		    {"Tan", [](double x) { return std::tan(x); }},
+		    {"Tanh", [](double x) { return std::tanh(x); }}
+		};
+	    }
+
+	    built_in_function find_built_in(std::string_view name) {
+		auto found = std::lower_bound(std::begin(built_ins), std::end(built_ins), name,
+					      [](const built_in& lhs, std::string_view rhs) { return lhs.name < rhs; });
+		if (found == std::end(built_ins) || found->name != name) {
+		    return nullptr;
+		}
+		return found->implementation;
+	    }
+
+	    base_node::ptr built_in_derivative(std::string_view name, const base_node& argument) {
+		auto rule = std::lower_bound(std::begin(derivative_rules), std::end(derivative_rules), name,
+					     [](const derivative_rule& lhs, std::string_view rhs) { return lhs.name < rhs; });
+		if (rule == std::end(derivative_rules) || rule->name != name) {
+		    return nullptr;
+		}
+		return rule->build(argument);
 	    }
-
-	    std::map<std::string, base_node::ptr> _built_in_derivatives() {
-		std::map<std::string, base_node::ptr> map;
-		map.insert( std::pair<std::string, base_node::ptr>("Sin", std::move(make_tree("Cos[__]"))));
-		map.insert( std::pair<std::string, base_node::ptr>("Cos", std::move(make_tree("-1*Sin[__]"))));
-		map.insert( std::pair<std::string, base_node::ptr>("Tan", std::move(make_tree("Sec[__]^(2)"))));
-		map.insert( std::pair<std::string, base_node::ptr>("Csc", std::move(make_tree("-1*Cot[__]*Csc[__]"))));
-		map.insert( std::pair<std::string, base_node::ptr>("Sec", std::move(make_tree("Sec[__]*Tan[__]"))));
-		map.insert( std::pair<std::string, base_node::ptr>("Cot", std::move(make_tree("-1*Csc[__]^(2)"))));
-		map.insert( std::pair<std::string, base_node::ptr>("ArcSin", std::move(make_tree("1/((1-__^(2))^(1/2))"))));
-		map.insert( std::pair<std::string, base_node::ptr>("ArcCos", std::move(make_tree("-1/((1-__^(2))^(1/2))"))));
-		map.insert( std::pair<std::string, base_node::ptr>("ArcTan", std::move(make_tree("1/(1+__^(2))"))));
-		map.insert( std::pair<std::string, base_node::ptr>("Sinh", std::move(make_tree("Cosh[__]"))));
-		map.insert( std::pair<std::string, base_node::ptr>("Cosh", std::move(make_tree("Sinh[__]"))));
-		map.insert( std::pair<std::string, base_node::ptr>("Tanh", std::move(make_tree("Sech[__]^(2)"))));
-		map.insert( std::pair<std::string, base_node::ptr>("Csch", std::move(make_tree("-1*Coth[__]*Csch[__]"))));
-		map.insert( std::pair<std::string, base_node::ptr>("Sech", std::move(make_tree("-1*Sech[__]*Tanh[__]"))));
-		map.insert( std::pair<std::string, base_node::ptr>("Coth", std::move(make_tree("-1*Csch[__]^(2)"))));
-		map.insert( std::pair<std::string, base_node::ptr>("ArcSinh", std::move(make_tree("1/((+-__^(2))^(1/2))"))));
-		map.insert( std::pair<std::string, base_node::ptr>("ArcCosh", std::move(make_tree("1/((__-1)^(1/2)*(__+1)^(1/2))"))));
-		map.insert( std::pair<std::string, base_node::ptr>("ArcTanh", std::move(make_tree("1/(1-x^(2))"))));
-		map.insert( std::pair<std::string, base_node::ptr>("Exp", std::move(make_tree("Exp[__]"))));
-		map.insert( std::pair<std::string, base_node::ptr>("Ln", std::move(make_tree("1/__"))));
-		map.insert( std::pair<std::string, base_node::ptr>("Log", std::move(make_tree("1/(__*Ln[10])"))));
-		return map;
-	    }
-
-	    const std::map<std::string, base_node::ptr> built_in_derivatives = std::move(_built_in_derivatives());
 	}
     }
 }
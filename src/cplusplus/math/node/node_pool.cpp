@@ -0,0 +1,401 @@
+#include "Gold/math/node_pool.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+#include <sys/mman.h>
+
+namespace Gold {
+    namespace math {
+	namespace node {
+	    namespace pool {
+
+		namespace {
+		    constexpr std::size_t granularity = 16;
+		    constexpr std::size_t classes = max_block / granularity;
+		    constexpr std::size_t chunk_size = 64 * 1024;
+		    // Empty chunks a thread keeps for reuse, 8 MiB, before returning them to the system
+		    constexpr std::size_t max_idle = 128;
+
+		    struct free_block {
+			free_block* next;
+		    };
+
+		    struct cache;
+
+		    // The start of every chunk, which is aligned to its size so that a block can find it
+		    struct chunk {
+			cache* owner;
+			std::size_t index;
+			// Blocks handed out and not yet back on free
+			std::size_t live;
+			free_block* free;
+			char* cursor;
+			// Every chunk of the owner for this size
+			chunk* previous;
+			chunk* next;
+			// The chunks that have room, other than the active one
+			chunk* previous_ready;
+			chunk* next_ready;
+			bool ready;
+			// Blocks freed by threads other than the owner's, taken back by the owner
+			std::atomic<free_block*> remote;
+		    };
+
+		    constexpr std::size_t header = (sizeof(chunk) + granularity - 1) / granularity * granularity;
+
+		    std::atomic<std::size_t> chunk_count { 0 };
+		    // The mode in force, or -1 until it is settled
+		    std::atomic<int> chosen { -1 };
+
+		    // Settle on requested unless a mode was settled already, returning the one in force
+		    mode settle(mode requested) {
+			int current = chosen.load(std::memory_order_acquire);
+			if (current < 0 && chosen.compare_exchange_strong(current, int(requested), std::memory_order_acq_rel)) {
+			    return requested;
+			}
+			return mode(current);
+		    }
+
+		    std::size_t size_class(std::size_t size) {
+			return size ? (size - 1) / granularity : 0;
+		    }
+
+		    std::size_t block_size(std::size_t index) {
+			return (index + 1) * granularity;
+		    }
+
+		    chunk* chunk_of(void* memory) {
+			return reinterpret_cast<chunk*>(reinterpret_cast<std::uintptr_t>(memory) & ~std::uintptr_t(chunk_size - 1));
+		    }
+
+		    char* start(chunk* block) {
+			return reinterpret_cast<char*>(block) + header;
+		    }
+
+		    bool has_room(chunk* block) {
+			char* limit = reinterpret_cast<char*>(block) + chunk_size;
+			return block->free || std::size_t(limit - block->cursor) >= block_size(block->index);
+		    }
+
+		    void* pop(chunk* block) {
+			block->live++;
+			if (free_block* first = block->free) {
+			    block->free = first->next;
+			    return first;
+			}
+			void* memory = block->cursor;
+			block->cursor += block_size(block->index);
+			return memory;
+		    }
+
+		    // Move the blocks other threads freed onto the free list, reporting whether there were any
+		    bool take_remote(chunk* block) {
+			if (!block->remote.load(std::memory_order_relaxed)) {
+			    return false;
+			}
+			free_block* list = block->remote.exchange(nullptr, std::memory_order_acquire);
+			std::size_t count = 1;
+			free_block* last = list;
+			while (last->next) {
+			    last = last->next;
+			    count++;
+			}
+			last->next = block->free;
+			block->free = list;
+			block->live -= count;
+			return true;
+		    }
+
+		    // Chunks are mapped rather than taken from malloc, so that one let go of is returned to the
+		    // system instead of leaving a hole in the heap
+		    chunk* map_chunk() {
+			void* mapped = ::mmap(nullptr, 2 * chunk_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (mapped == MAP_FAILED) {
+			    throw std::bad_alloc();
+			}
+			// Keep the aligned chunk_size bytes within the mapping
+			char* first = static_cast<char*>(mapped);
+			char* aligned = reinterpret_cast<char*>((reinterpret_cast<std::uintptr_t>(first) + chunk_size - 1) &
+								~std::uintptr_t(chunk_size - 1));
+			if (aligned != first) {
+			    ::munmap(first, std::size_t(aligned - first));
+			}
+			::munmap(aligned + chunk_size, std::size_t(first + chunk_size - aligned));
+			chunk_count.fetch_add(1, std::memory_order_relaxed);
+			return reinterpret_cast<chunk*>(aligned);
+		    }
+
+		    void unmap_chunk(chunk* block) {
+			block->~chunk();
+			::munmap(block, chunk_size);
+			chunk_count.fetch_sub(1, std::memory_order_relaxed);
+		    }
+
+		    /*****************************************************************************************//**
+		    * The chunks of one thread, in one list per size. Only the thread using a cache touches
+		    * it, apart from pushing onto the remote lists of its chunks and raising pending. Caches
+		    * are never destroyed: that of a thread that exits is retired and handed to the next
+		    * thread to start, so the owner of a chunk stays valid while its blocks are in use.
+		    *********************************************************************************************/
+		    struct cache {
+			// The chunk each size is carved from
+			chunk* active[classes] = { };
+			chunk* chunks[classes] = { };
+			chunk* ready[classes] = { };
+			// Empty chunks, of no size yet, linked through next
+			chunk* idle = nullptr;
+			std::size_t idle_count = 0;
+			// Whether some chunk of the size has blocks freed on other threads
+			std::atomic<bool> pending[classes] = { };
+			// Set while no thread uses this cache, when it is only touched under the registry lock
+			std::atomic<bool> retired { false };
+
+			void* refill(std::size_t index) {
+			    chunk* current = active[index];
+			    if (pending[index].exchange(false, std::memory_order_acquire)) {
+				// Take back what other threads freed, letting go of chunks left empty
+				for (chunk* block = chunks[index]; block; ) {
+				    chunk* next = block->next;
+				    if (take_remote(block) && block != current) {
+					returned(block);
+				    }
+				    block = next;
+				}
+			    }
+			    if (current && (has_room(current) || take_remote(current))) {
+				return pop(current);
+			    }
+			    chunk* next = ready[index];
+			    if (next) {
+				unready(next);
+			    }
+			    else {
+				next = make_chunk(index);
+			    }
+			    active[index] = next;
+			    return pop(next);
+			}
+
+			void give_back(chunk* block, void* memory) {
+			    free_block* freed = static_cast<free_block*>(memory);
+			    freed->next = block->free;
+			    block->free = freed;
+			    block->live--;
+			    if (block != active[block->index]) {
+				returned(block);
+			    }
+			    else if (block->live == 0) {
+				// Start again from the front of the chunk, keeping new nodes together
+				block->free = nullptr;
+				block->cursor = start(block);
+			    }
+			}
+
+			// Blocks came back to a chunk other than the active one
+			void returned(chunk* block) {
+			    if (block->live == 0) {
+				release(block);
+			    }
+			    else if (!block->ready) {
+				block->ready = true;
+				block->previous_ready = nullptr;
+				block->next_ready = ready[block->index];
+				if (block->next_ready) {
+				    block->next_ready->previous_ready = block;
+				}
+				ready[block->index] = block;
+			    }
+			}
+
+			void unready(chunk* block) {
+			    if (block->previous_ready) {
+				block->previous_ready->next_ready = block->next_ready;
+			    }
+			    else {
+				ready[block->index] = block->next_ready;
+			    }
+			    if (block->next_ready) {
+				block->next_ready->previous_ready = block->previous_ready;
+			    }
+			    block->ready = false;
+			}
+
+			chunk* make_chunk(std::size_t index) {
+			    chunk* block = idle;
+			    if (block) {
+				idle = block->next;
+				idle_count--;
+				block->~chunk();
+			    }
+			    else {
+				block = map_chunk();
+			    }
+			    new (block) chunk { this, index, 0, nullptr, start(block), nullptr, chunks[index],
+						nullptr, nullptr, false, { nullptr } };
+			    if (chunks[index]) {
+				chunks[index]->previous = block;
+			    }
+			    chunks[index] = block;
+			    return block;
+			}
+
+			// Unlink an empty chunk, keeping it for any size unless enough are kept already
+			void release(chunk* block) {
+			    if (block->ready) {
+				unready(block);
+			    }
+			    if (block->previous) {
+				block->previous->next = block->next;
+			    }
+			    else {
+				chunks[block->index] = block->next;
+			    }
+			    if (block->next) {
+				block->next->previous = block->previous;
+			    }
+			    if (active[block->index] == block) {
+				active[block->index] = nullptr;
+			    }
+			    if (idle_count < max_idle && !retired.load(std::memory_order_relaxed)) {
+				block->next = idle;
+				idle = block;
+				idle_count++;
+			    }
+			    else {
+				unmap_chunk(block);
+			    }
+			}
+
+			// Called as the thread using this cache exits. Keeps only chunks with blocks in use.
+			void retire() {
+			    retired.store(true, std::memory_order_release);
+			    for (std::size_t i = 0; i < classes; i++) {
+				active[i] = nullptr;
+				for (chunk* block = chunks[i]; block; ) {
+				    chunk* next = block->next;
+				    take_remote(block);
+				    if (block->live == 0) {
+					release(block);
+				    }
+				    block = next;
+				}
+			    }
+			    while (idle) {
+				chunk* next = idle->next;
+				unmap_chunk(idle);
+				idle = next;
+			    }
+			    idle_count = 0;
+			}
+		    };
+
+		    // Retired caches, waiting for a thread. Never destroyed, since thread local caches can
+		    // be retired after static objects are destroyed.
+		    struct registry {
+			std::mutex lock;
+			std::vector<cache*> retired;
+		    };
+
+		    registry& caches() {
+			static registry* state = new registry;
+			return *state;
+		    }
+
+		    thread_local cache* local = nullptr;
+
+		    struct retire_on_exit {
+			~retire_on_exit() {
+			    registry& shared = caches();
+			    std::lock_guard<std::mutex> guard(shared.lock);
+			    local->retire();
+			    shared.retired.push_back(local);
+			    local = nullptr;
+			}
+		    };
+
+		    cache* attach() {
+			thread_local retire_on_exit retirement;
+			(void) retirement;
+			registry& shared = caches();
+			std::lock_guard<std::mutex> guard(shared.lock);
+			if (shared.retired.empty()) {
+			    local = new cache;
+			}
+			else {
+			    local = shared.retired.back();
+			    shared.retired.pop_back();
+			    local->retired.store(false, std::memory_order_relaxed);
+			}
+			return local;
+		    }
+
+		    void free_remote(chunk* block, void* memory) {
+			// Once the block is published the owner may release the chunk, so read its header first
+			cache* owner = block->owner;
+			std::size_t index = block->index;
+			if (owner->retired.load(std::memory_order_acquire)) {
+			    // No thread will take the block back, so do it here
+			    std::lock_guard<std::mutex> guard(caches().lock);
+			    if (owner->retired.load(std::memory_order_relaxed)) {
+				take_remote(block);
+				owner->give_back(block, memory);
+				return;
+			    }
+			}
+			free_block* freed = static_cast<free_block*>(memory);
+			freed->next = block->remote.load(std::memory_order_relaxed);
+			while (!block->remote.compare_exchange_weak(freed->next, freed, std::memory_order_release,
+								    std::memory_order_relaxed)) {
+			}
+			owner->pending[index].store(true, std::memory_order_release);
+		    }
+		}
+
+		bool set_mode(mode requested) {
+		    return settle(requested) == requested;
+		}
+
+		mode current_mode() {
+		    return settle(mode::system);
+		}
+
+		void* allocate(std::size_t size) {
+		    if (size > max_block || settle(mode::system) == mode::system) {
+			return ::operator new(size);
+		    }
+		    std::size_t index = size_class(size);
+		    cache* current = local ? local : attach();
+		    chunk* block = current->active[index];
+		    if (block && has_room(block)) {
+			return pop(block);
+		    }
+		    return current->refill(index);
+		}
+
+		void deallocate(void* memory, std::size_t size) noexcept {
+		    if (!memory) {
+			return;
+		    }
+		    // The mode was settled when memory was allocated
+		    if (size > max_block || mode(chosen.load(std::memory_order_relaxed)) == mode::system) {
+			::operator delete(memory);
+			return;
+		    }
+		    chunk* block = chunk_of(memory);
+		    if (block->owner == local) {
+			local->give_back(block, memory);
+		    }
+		    else {
+			free_remote(block, memory);
+		    }
+		}
+
+		std::size_t reserved() {
+		    return chunk_count.load(std::memory_order_relaxed) * chunk_size;
+		}
+	    }
+	}
+    }
+}
@@ -0,0 +1,644 @@
+#include "Gold/math/parser.hpp"
+#include "Gold/math/exception.hpp"
+#include <cctype>
+#include <charconv>
+#include <climits>
+#include <stdexcept>
+
+namespace Gold {
+    namespace math {
+	namespace parser {
+
+	    namespace {
+
+		bool is_identifier_start(char ch) {
+		    return std::isalpha(static_cast<unsigned char>(ch)) || ch == '_';
+		}
+
+		bool is_identifier_char(char ch) {
+		    return std::isalnum(static_cast<unsigned char>(ch)) || ch == '_';
+		}
+
+		bool is_digit(char ch) {
+		    return ch >= '0' && ch <= '9';
+		}
+
+		bool ends_operand(token_type type) {
+		    return type == token_type::number || type == token_type::identifier ||
+			type == token_type::close_paren || type == token_type::close_bracket;
+		}
+
+		bool ends_sum(token_type type) {
+		    return type == token_type::plus || type == token_type::minus ||
+			type == token_type::close_paren || type == token_type::close_bracket ||
+			type == token_type::comma || type == token_type::end;
+		}
+
+		bool ends_product(token_type type) {
+		    return ends_sum(type) || type == token_type::times || type == token_type::divide;
+		}
+
+		node::base_node::ptr negate(node::base_node::ptr&& operand) {
+		    node::multiply::ptr result = std::make_unique<node::multiply>();
+		    result->append(std::make_unique<node::integer>(-1));
+		    result->append(std::move(operand));
+		    return std::move(result);
+		}
+
+		node::base_node::ptr invert(node::base_node::ptr&& operand) {
+		    node::power::ptr result = std::make_unique<node::power>();
+		    result->append(std::move(operand));
+		    result->append(std::make_unique<node::integer>(-1));
+		    return std::move(result);
+		}
+
+		const std::size_t no_group = std::size_t(-1);
+
+		/**********************************//**
+		* Convert a number token. Digits alone
+		* too large for an integer, as printed
+		* for large whole numbers, are read as
+		* a number. Returns false if it does not
+		* fit in a double.
+		**************************************/
+		bool read_literal(std::string_view text, bool negative, bool& is_integer, int& integer_value,
+				  double& number_value) {
+		    is_integer = text.find_first_of(".eE") == std::string_view::npos;
+		    if (is_integer) {
+			long long value = 0;
+			for (char digit : text) {
+			    value = value * 10 + (digit - '0');
+			    if (value > (long long)INT_MAX + negative) {
+				is_integer = false;
+				break;
+			    }
+			}
+			if (is_integer) {
+			    integer_value = int(negative ? -value : value);
+			    return true;
+			}
+		    }
+
+		    std::from_chars_result parsed = std::from_chars(text.data(), text.data() + text.size(), number_value);
+		    number_value = negative ? -number_value : number_value;
+		    return parsed.ec == std::errc();
+		}
+	    }
+
+	    bool tokenize(std::string_view str, std::vector<token>& tokens, error_info& failure) {
+		tokens.clear();
+		tokens.reserve(str.size() / 2 + 2);
+		// Open groups form a stack threaded through the match field of their opening tokens
+		std::size_t group = no_group;
+		std::size_t i = 0;
+		while (i < str.size()) {
+		    char ch = str[i];
+		    if (std::isspace(static_cast<unsigned char>(ch))) {
+			i++;
+			continue;
+		    }
+		    token tok { token_type::end, i, 1, 0, false, false };
+		    if (is_digit(ch) || (ch == '.' && i + 1 < str.size() && is_digit(str[i+1]))) {
+			std::size_t end = i;
+			while (end < str.size() && is_digit(str[end])) end++;
+			if (end < str.size() && str[end] == '.') {
+			    end++;
+			    while (end < str.size() && is_digit(str[end])) end++;
+			}
+			if (end < str.size() && (str[end] == 'e' || str[end] == 'E')) {
+			    // Only an exponent if digits follow, otherwise the e starts the next token
+			    std::size_t digits = end + 1;
+			    if (digits < str.size() && (str[digits] == '+' || str[digits] == '-')) digits++;
+			    if (digits < str.size() && is_digit(str[digits])) {
+				end = digits;
+				while (end < str.size() && is_digit(str[end])) end++;
+			    }
+			}
+			tok.type = token_type::number;
+			tok.length = end - i;
+		    }
+		    else if (is_identifier_start(ch)) {
+			std::size_t end = i;
+			while (end < str.size() && is_identifier_char(str[end])) end++;
+			tok.type = token_type::identifier;
+			tok.length = end - i;
+		    }
+		    else {
+			switch (ch) {
+			case '+': tok.type = token_type::plus; break;
+			case '-': tok.type = token_type::minus; break;
+			case '*': tok.type = token_type::times; break;
+			case '/': tok.type = token_type::divide; break;
+			case '^': tok.type = token_type::caret; break;
+			case ',': tok.type = token_type::comma; break;
+			case '(': tok.type = token_type::open_paren; break;
+			case '[': tok.type = token_type::open_bracket; break;
+			case ')': tok.type = token_type::close_paren; break;
+			case ']': tok.type = token_type::close_bracket; break;
+			default:
+			    failure = error_info { error_code::unexpected_character, i };
+			    return false;
+			}
+		    }
+
+		    switch (tok.type) {
+		    case token_type::open_paren:
+		    case token_type::open_bracket:
+			tok.match = group;
+			group = tokens.size();
+			break;
+		    case token_type::close_paren:
+		    case token_type::close_bracket: {
+			token_type opener = (tok.type == token_type::close_paren) ?
+			    token_type::open_paren : token_type::open_bracket;
+			if (group == no_group || tokens[group].type != opener) {
+			    failure = error_info { error_code::mismatched_brackets, i };
+			    return false;
+			}
+			tok.match = group;
+			group = tokens[group].match;
+			tokens[tok.match].match = tokens.size();
+			break;
+		    }
+		    case token_type::plus:
+		    case token_type::minus:
+			if (group != no_group && ends_operand(tokens.back().type)) {
+			    tokens[group].additive = true;
+			}
+			break;
+		    case token_type::times:
+		    case token_type::divide:
+			if (group != no_group) {
+			    tokens[group].multiplicative = true;
+			}
+			break;
+		    default:
+			break;
+		    }
+		    tokens.push_back(tok);
+		    i += tok.length;
+		}
+		if (group != no_group) {
+		    failure = error_info { error_code::mismatched_brackets, tokens[group].begin };
+		    return false;
+		}
+		tokens.push_back(token { token_type::end, str.size(), 0, 0, false, false });
+		return true;
+	    }
+
+	    void tokenize(std::string_view str, std::vector<token>& tokens) {
+		error_info failure;
+		if (!tokenize(str, tokens, failure)) {
+		    if (failure.code == error_code::mismatched_brackets) {
+			throw invalid_expression(std::string(str).append(" has mismatched parentheses"));
+		    }
+		    throw invalid_expression(std::string("Unexpected character '").append(1, str[failure.position])
+					     .append("' at position ").append(std::to_string(failure.position))
+					     .append(" in ").append(str));
+		}
+	    }
+
+	    std::vector<token> tokenize(std::string_view str) {
+		std::vector<token> tokens;
+		tokenize(str, tokens);
+		return tokens;
+	    }
+
+	    tree_parser::tree_parser(std::string_view str) :
+		source(str), tokens(owned_tokens), position(0), groups(nullptr), failure { error_code::none, 0 } {
+		tokenize(source, tokens);
+	    }
+
+	    tree_parser::tree_parser(std::string_view str, std::vector<token>& buffer) :
+		source(str), tokens(buffer), position(0), groups(nullptr), failure { error_code::none, 0 } {
+		tokenize(source, tokens);
+	    }
+
+	    tree_parser::tree_parser(std::string_view str, std::vector<token>& buffer, error_info& _failure) :
+		source(str), tokens(buffer), position(0), groups(nullptr), failure { error_code::none, 0 } {
+		if (!tokenize(source, tokens, failure)) {
+		    _failure = failure;
+		}
+	    }
+
+	    node::base_node::ptr tree_parser::parse() {
+		if (peek().type == token_type::end) {
+		    throw invalid_expression("Cannot parse an empty expression");
+		}
+		node::base_node::ptr tree = parse_expression();
+		if (peek().type != token_type::end) {
+		    unexpected();
+		}
+		return tree;
+	    }
+
+	    node::base_node::ptr tree_parser::parse(std::vector<node::base_node*>& _groups) {
+		_groups.assign(tokens.size(), nullptr);
+		groups = &_groups;
+		node::base_node::ptr tree = parse();
+		groups = nullptr;
+		return tree;
+	    }
+
+	    node::base_node::ptr tree_parser::parse_expression() {
+		node::base_node::vec terms;
+		parse_sum(terms, false);
+		if (terms.size() == 1) {
+		    return std::move(terms.front());
+		}
+		return std::make_unique<node::add>(std::move(terms));
+	    }
+
+	    void tree_parser::parse_sum(node::base_node::vec& terms, bool negate) {
+		parse_sum_operand(terms, negate);
+		while (peek().type == token_type::plus || peek().type == token_type::minus) {
+		    bool subtract = advance().type == token_type::minus;
+		    parse_sum_operand(terms, negate != subtract);
+		}
+	    }
+
+	    void tree_parser::parse_sum_operand(node::base_node::vec& terms, bool negate) {
+		while (peek().type == token_type::plus) {
+		    advance();
+		}
+		const token& current = peek();
+		if (current.type == token_type::open_paren && ends_sum(tokens[current.match + 1].type)) {
+		    // A bracketed sum is spliced into the enclosing one
+		    advance();
+		    parse_sum(terms, negate);
+		    expect(token_type::close_paren);
+		    return;
+		}
+		if (current.type == token_type::minus) {
+		    if (is_negative_literal(ends_sum)) {
+			advance();
+			node::base_node::ptr literal = make_literal(advance(), true);
+			terms.push_back(negate ? parser::negate(std::move(literal)) : std::move(literal));
+			return;
+		    }
+		    advance();
+		    negate = !negate;
+		}
+
+		node::base_node::vec factors;
+		if (negate) {
+		    factors.push_back(std::make_unique<node::integer>(-1));
+		}
+		bool divided = parse_product(factors, false);
+		if (negate) {
+		    terms.push_back(std::make_unique<node::multiply>(std::move(factors)));
+		}
+		else if (factors.size() == 1) {
+		    terms.push_back(std::move(factors.front()));
+		}
+		else if (factors.size() == 2 && divided && factors[0]->is_leaf() && factors[0]->get_token() == "1") {
+		    terms.push_back(std::move(factors[1]));
+		}
+		else {
+		    terms.push_back(std::make_unique<node::multiply>(std::move(factors)));
+		}
+	    }
+
+	    bool tree_parser::parse_product(node::base_node::vec& factors, bool invert) {
+		bool divided = false;
+		parse_product_operand(factors, invert);
+		while (peek().type == token_type::times || peek().type == token_type::divide) {
+		    divided = advance().type == token_type::divide;
+		    parse_product_operand(factors, invert != divided);
+		}
+		return divided;
+	    }
+
+	    void tree_parser::parse_product_operand(node::base_node::vec& factors, bool invert) {
+		while (peek().type == token_type::plus) {
+		    advance();
+		}
+		const token& current = peek();
+		if (current.type == token_type::open_paren && !current.additive &&
+		    ends_product(tokens[current.match + 1].type)) {
+		    // A bracketed product is spliced into the enclosing one
+		    advance();
+		    parse_product(factors, invert);
+		    expect(token_type::close_paren);
+		    return;
+		}
+		if (current.type == token_type::minus) {
+		    if (is_negative_literal(ends_product)) {
+			advance();
+			node::base_node::ptr literal = make_literal(advance(), true);
+			factors.push_back(invert ? parser::invert(std::move(literal)) : std::move(literal));
+			return;
+		    }
+		    advance();
+		    node::base_node::vec operand;
+		    parse_product_operand(operand, false);
+		    node::base_node::ptr factor = (operand.size() == 1) ?
+			std::move(operand.front()) : std::make_unique<node::multiply>(std::move(operand));
+		    if (invert) {
+			factor = parser::invert(std::move(factor));
+		    }
+		    factors.push_back(parser::negate(std::move(factor)));
+		    return;
+		}
+		node::base_node::ptr factor = parse_factor();
+		factors.push_back(invert ? parser::invert(std::move(factor)) : std::move(factor));
+	    }
+
+	    node::base_node::ptr tree_parser::parse_factor() {
+		node::base_node::ptr base = parse_primary();
+		if (peek().type != token_type::caret) {
+		    return base;
+		}
+		advance();
+		node::power::ptr result = std::make_unique<node::power>();
+		result->append(std::move(base));
+		result->append(parse_exponent());
+		return std::move(result);
+	    }
+
+	    node::base_node::ptr tree_parser::parse_exponent() {
+		while (peek().type == token_type::plus) {
+		    advance();
+		}
+		if (peek().type != token_type::minus) {
+		    return parse_factor();
+		}
+		if (peek(1).type == token_type::number && peek(2).type != token_type::caret) {
+		    advance();
+		    return make_literal(advance(), true);
+		}
+		advance();
+		return negate(parse_exponent());
+	    }
+
+	    node::base_node::ptr tree_parser::parse_primary() {
+		const token& current = peek();
+		switch (current.type) {
+		case token_type::number:
+		    return make_literal(advance(), false);
+		case token_type::identifier:
+		    if (peek(1).type == token_type::open_bracket) {
+			return parse_function();
+		    }
+		    advance();
+		    return std::make_unique<node::variable>(std::string(source.substr(current.begin, current.length)));
+		case token_type::open_paren: {
+		    std::size_t open = position;
+		    advance();
+		    node::base_node::ptr inner = parse_expression();
+		    expect(token_type::close_paren);
+		    if (groups) {
+			(*groups)[open] = inner.get();
+		    }
+		    return inner;
+		}
+		default:
+		    unexpected();
+		}
+	    }
+
+	    node::base_node::ptr tree_parser::parse_function() {
+		const token& name = advance();
+		if (!node::find_built_in(source.substr(name.begin, name.length))) {
+		    throw invalid_expression(std::string("Unknown function '").append(source.substr(name.begin, name.length))
+					     .append("' at position ").append(std::to_string(name.begin))
+					     .append(" in ").append(source));
+		}
+		advance();
+		if (peek().type == token_type::close_bracket) {
+		    unexpected();
+		}
+		node::base_node::vec arguments;
+		arguments.push_back(parse_expression());
+		while (peek().type == token_type::comma) {
+		    advance();
+		    arguments.push_back(parse_expression());
+		}
+		std::size_t open = tokens[position].match;
+		expect(token_type::close_bracket);
+		node::base_node::ptr result = std::make_unique<node::function>(std::string(source.substr(name.begin, name.length)),
+									       std::move(arguments));
+		if (groups) {
+		    (*groups)[open] = result.get();
+		}
+		return result;
+	    }
+
+	    /*************************************************
+	     *
+	     * Syntax checks, mirroring the parse functions
+	     * above one for one
+	     *
+	     ************************************************/
+	    bool tree_parser::check(error_info& _failure) {
+		if (failure.code == error_code::none) {
+		    position = 0;
+		    if (peek().type == token_type::end) {
+			failure = error_info { error_code::empty_expression, 0 };
+		    }
+		    else if (check_sum() && peek().type != token_type::end) {
+			fail_unexpected();
+		    }
+		    position = 0;
+		}
+		_failure = failure;
+		return failure.code == error_code::none;
+	    }
+
+	    bool tree_parser::check_sum() {
+		if (!check_sum_operand()) {
+		    return false;
+		}
+		while (peek().type == token_type::plus || peek().type == token_type::minus) {
+		    advance();
+		    if (!check_sum_operand()) {
+			return false;
+		    }
+		}
+		return true;
+	    }
+
+	    bool tree_parser::check_sum_operand() {
+		while (peek().type == token_type::plus) {
+		    advance();
+		}
+		const token& current = peek();
+		if (current.type == token_type::open_paren && ends_sum(tokens[current.match + 1].type)) {
+		    advance();
+		    return check_sum() && check_expect(token_type::close_paren);
+		}
+		if (current.type == token_type::minus) {
+		    if (is_negative_literal(ends_sum)) {
+			advance();
+			return check_literal(advance(), true);
+		    }
+		    advance();
+		}
+		return check_product();
+	    }
+
+	    bool tree_parser::check_product() {
+		if (!check_product_operand()) {
+		    return false;
+		}
+		while (peek().type == token_type::times || peek().type == token_type::divide) {
+		    advance();
+		    if (!check_product_operand()) {
+			return false;
+		    }
+		}
+		return true;
+	    }
+
+	    bool tree_parser::check_product_operand() {
+		while (peek().type == token_type::plus) {
+		    advance();
+		}
+		const token& current = peek();
+		if (current.type == token_type::open_paren && !current.additive &&
+		    ends_product(tokens[current.match + 1].type)) {
+		    advance();
+		    return check_product() && check_expect(token_type::close_paren);
+		}
+		if (current.type == token_type::minus) {
+		    if (is_negative_literal(ends_product)) {
+			advance();
+			return check_literal(advance(), true);
+		    }
+		    advance();
+		    return check_product_operand();
+		}
+		return check_factor();
+	    }
+
+	    bool tree_parser::check_factor() {
+		if (!check_primary()) {
+		    return false;
+		}
+		if (peek().type != token_type::caret) {
+		    return true;
+		}
+		advance();
+		return check_exponent();
+	    }
+
+	    bool tree_parser::check_exponent() {
+		while (peek().type == token_type::plus) {
+		    advance();
+		}
+		if (peek().type != token_type::minus) {
+		    return check_factor();
+		}
+		if (peek(1).type == token_type::number && peek(2).type != token_type::caret) {
+		    advance();
+		    return check_literal(advance(), true);
+		}
+		advance();
+		return check_exponent();
+	    }
+
+	    bool tree_parser::check_primary() {
+		switch (peek().type) {
+		case token_type::number:
+		    return check_literal(advance(), false);
+		case token_type::identifier:
+		    if (peek(1).type == token_type::open_bracket) {
+			return check_function();
+		    }
+		    advance();
+		    return true;
+		case token_type::open_paren:
+		    advance();
+		    return check_sum() && check_expect(token_type::close_paren);
+		default:
+		    return fail_unexpected();
+		}
+	    }
+
+	    bool tree_parser::check_function() {
+		const token& name = advance();
+		if (!node::find_built_in(source.substr(name.begin, name.length))) {
+		    failure = error_info { error_code::function_not_found, name.begin };
+		    return false;
+		}
+		advance();
+		if (peek().type == token_type::close_bracket) {
+		    return fail_unexpected();
+		}
+		if (!check_sum()) {
+		    return false;
+		}
+		while (peek().type == token_type::comma) {
+		    advance();
+		    if (!check_sum()) {
+			return false;
+		    }
+		}
+		return check_expect(token_type::close_bracket);
+	    }
+
+	    bool tree_parser::check_literal(const token& tok, bool negative) {
+		bool is_integer;
+		int integer_value;
+		double number_value;
+		if (!read_literal(source.substr(tok.begin, tok.length), negative, is_integer, integer_value, number_value)) {
+		    failure = error_info { error_code::literal_out_of_range, tok.begin };
+		    return false;
+		}
+		return true;
+	    }
+
+	    bool tree_parser::check_expect(token_type type) {
+		if (peek().type != type) {
+		    return fail_unexpected();
+		}
+		advance();
+		return true;
+	    }
+
+	    bool tree_parser::fail_unexpected() {
+		const token& current = peek();
+		failure = error_info { current.type == token_type::end ? error_code::unexpected_end : error_code::unexpected_token,
+				       current.begin };
+		return false;
+	    }
+
+	    node::base_node::ptr tree_parser::make_literal(const token& tok, bool negative) const {
+		std::string_view text = source.substr(tok.begin, tok.length);
+		bool is_integer;
+		int integer_value;
+		double number_value;
+		if (!read_literal(text, negative, is_integer, integer_value, number_value)) {
+		    throw std::out_of_range(std::string(text).append(" is out of range for a number"));
+		}
+		if (is_integer) {
+		    return std::make_unique<node::integer>(integer_value);
+		}
+		return std::make_unique<node::number>(number_value);
+	    }
+
+	    bool tree_parser::is_negative_literal(bool (*boundary)(token_type)) const {
+		return peek().type == token_type::minus &&
+		    peek(1).type == token_type::number &&
+		    boundary(peek(2).type);
+	    }
+
+	    void tree_parser::expect(token_type type) {
+		if (peek().type != type) {
+		    unexpected();
+		}
+		advance();
+	    }
+
+	    void tree_parser::unexpected() const {
+		const token& current = peek();
+		if (current.type == token_type::end) {
+		    throw invalid_expression(std::string("Unexpected end of expression in ").append(source));
+		}
+		throw invalid_expression(std::string("Unexpected '").append(source.substr(current.begin, current.length))
+					 .append("' at position ").append(std::to_string(current.begin))
+					 .append(" in ").append(source));
+	    }
+	}
+    }
+}
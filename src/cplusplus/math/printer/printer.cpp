@@ -0,0 +1,338 @@
+#include "Gold/math/printer.hpp"
+#include "Gold/math/utils.hpp"
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <vector>
+
+namespace Gold {
+    namespace math {
+	namespace node {
+
+	    namespace {
+
+		// Operators appearing outside any bracket in the printed form of a node
+		const unsigned plus = 1;
+		const unsigned minus = 2;
+		const unsigned times = 4;
+		const unsigned divide = 8;
+		const unsigned caret = 16;
+
+		/**********************************//**
+		* What a parent needs to know about the
+		* printed form of a child to decide on
+		* parentheses.
+		*
+		* ops      => Operators outside brackets.\n
+		* function => Whether utils::is_function
+		*             holds for it.\n
+		* empty    => Whether it prints nothing.\n
+		* nodes    => Nodes in the subtree.
+		**************************************/
+		struct shape {
+		    unsigned ops;
+		    bool function;
+		    bool empty;
+		    std::size_t nodes;
+		};
+
+		unsigned scan(const char* first, const char* last) {
+		    // Same bracket counting as utils::has_uncontained_op
+		    unsigned ops = 0;
+		    int level = 0;
+		    for (; first != last; first++) {
+			switch (*first) {
+			case '(': case '[': level--; break;
+			case ')': case ']': level++; break;
+			case '+': ops |= (level >= 0) ? plus : 0; break;
+			case '-': ops |= (level >= 0) ? minus : 0; break;
+			case '*': ops |= (level >= 0) ? times : 0; break;
+			case '/': ops |= (level >= 0) ? divide : 0; break;
+			case '^': ops |= (level >= 0) ? caret : 0; break;
+			default: break;
+			}
+		    }
+		    return ops;
+		}
+
+		template<class T>
+		std::size_t format(T value, char (&buffer)[32]) {
+		    return std::size_t(std::to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer);
+		}
+
+		// Children are reached through iterators, which unlike size and child are not virtual
+		const operation* as_operation(const base_node& tree, node_kind kind) {
+		    bool leaf = kind == node_kind::integer || kind == node_kind::number || kind == node_kind::variable;
+		    return leaf ? nullptr : static_cast<const operation*>(&tree);
+		}
+
+		std::size_t size_of(const operation* op) {
+		    return op ? std::size_t(op->end() - op->begin()) : 0;
+		}
+
+		const base_node& child_of(const operation* op, std::size_t i) {
+		    return *op->begin()[i];
+		}
+
+		bool wraps_first(node_kind parent, node_kind child) {
+		    switch (parent) {
+		    case node_kind::multiply:
+			return child == node_kind::add;
+		    case node_kind::power:
+			return child == node_kind::add || child == node_kind::multiply || child == node_kind::power;
+		    default:
+			return false;
+		    }
+		}
+
+		/**********************************//**
+		* Whether a child after the first needs
+		* parentheses, as in utils::needs_parens.
+		**************************************/
+		bool wraps_rest(node_kind parent, const shape& child) {
+		    if (child.function) {
+			return false;
+		    }
+		    switch (parent) {
+		    case node_kind::multiply:
+			return (child.ops & (plus | minus)) != 0;
+		    case node_kind::power:
+			return (child.ops & (plus | minus | times | divide)) != 0;
+		    default:
+			return false;
+		    }
+		}
+
+		/*****************************************************************************************//**
+		* Append the shape of every node of tree to shapes in pre-order and return the index of
+		* the shape of tree itself. A node's shape follows from its kind and the shapes of its
+		* children, so this is a single post-order walk.
+		*********************************************************************************************/
+		std::size_t describe(const base_node& tree, std::vector<shape>& shapes) {
+		    std::size_t index = shapes.size();
+		    shapes.push_back(shape { 0, false, false, 1 });
+		    node_kind kind = tree.kind();
+		    const operation* op = as_operation(tree, kind);
+		    std::size_t count = size_of(op);
+
+		    unsigned ops = 0;
+		    bool first_wrapped = false;
+		    for (std::size_t i = 0; i < count; i++) {
+			std::size_t child = describe(child_of(op, i), shapes);
+			bool wrapped = (i == 0) ? wraps_first(kind, child_of(op, i).kind()) : wraps_rest(kind, shapes[child]);
+			first_wrapped = first_wrapped || (i == 0 && wrapped);
+			if (!wrapped) {
+			    ops |= shapes[child].ops;
+			}
+		    }
+
+		    shape result { 0, false, false, shapes.size() - index };
+		    char buffer[32];
+		    switch (kind) {
+		    case node_kind::integer:
+			result.ops = scan(buffer, buffer + format(static_cast<const integer&>(tree).value(), buffer));
+			break;
+		    case node_kind::number:
+			result.ops = scan(buffer, buffer + format(static_cast<const number&>(tree).value(), buffer));
+			break;
+		    case node_kind::variable: {
+			const std::string& name = static_cast<const variable&>(tree).name();
+			result.ops = scan(name.data(), name.data() + name.size());
+			result.function = utils::is_function(name);
+			result.empty = name.empty();
+			break;
+		    }
+		    case node_kind::function: {
+			const std::string& name = static_cast<const function&>(tree).name();
+			if (count == 0) {
+			    result.empty = true;
+			}
+			else if (name.find_first_of("()[]") != std::string::npos) {
+			    // Unusual names are rare enough to just print and check
+			    std::string printed = name + "[";
+			    for (std::size_t i = 0; i < count; i++) {
+				printed.append(i == 0 ? "" : ", ");
+				print(child_of(op, i), printed);
+			    }
+			    printed.push_back(']');
+			    result.ops = scan(printed.data(), printed.data() + printed.size());
+			    result.function = utils::is_function(printed);
+			}
+			else {
+			    // Children sit inside the brackets, so only the name can hold operators
+			    result.ops = scan(name.data(), name.data() + name.size());
+			    result.function = !name.empty() && std::isalnum(static_cast<unsigned char>(name[0])) &&
+				name.find_first_of("+-*/^") == std::string::npos &&
+				(name.size() > 1 || count > 1 || !shapes[index + 1].empty);
+			}
+			break;
+		    }
+		    case node_kind::add:
+		    case node_kind::multiply:
+		    case node_kind::power:
+			if (count == 0) {
+			    result.empty = true;
+			}
+			else if (count > 1) {
+			    result.ops = ops | (kind == node_kind::add ? plus : kind == node_kind::multiply ? times : caret);
+			}
+			else if (!first_wrapped) {
+			    result.ops = shapes[index + 1].ops;
+			    result.function = shapes[index + 1].function;
+			    result.empty = shapes[index + 1].empty;
+			}
+			break;
+		    }
+		    shapes[index] = result;
+		    return index;
+		}
+
+		class string_sink {
+		public:
+		    explicit string_sink(std::string& _out) : out(_out) { }
+		    void write(const char* text, std::size_t length) { out.append(text, length); }
+		    void put(char c) { out.push_back(c); }
+
+		private:
+		    std::string& out;
+		};
+
+		/**********************************//**
+		* Collects output in a fixed buffer so the
+		* stream is written in large pieces.
+		**************************************/
+		class stream_sink {
+		public:
+		    explicit stream_sink(std::ostream& _out) : out(_out), used(0) { }
+		    stream_sink(const stream_sink& other) = delete;
+		    stream_sink& operator=(const stream_sink& other) = delete;
+		    ~stream_sink() { flush(); }
+
+		    void write(const char* text, std::size_t length) {
+			if (used + length > sizeof(buffer)) {
+			    flush();
+			    if (length > sizeof(buffer)) {
+				out.write(text, std::streamsize(length));
+				return;
+			    }
+			}
+			std::memcpy(buffer + used, text, length);
+			used += length;
+		    }
+
+		    void put(char c) {
+			if (used == sizeof(buffer)) {
+			    flush();
+			}
+			buffer[used++] = c;
+		    }
+
+		    void flush() {
+			out.write(buffer, std::streamsize(used));
+			used = 0;
+		    }
+
+		private:
+		    std::ostream& out;
+		    char buffer[1024];
+		    std::size_t used;
+		};
+
+		template<class Sink>
+		void emit(const base_node& tree, const std::vector<shape>& shapes, std::size_t index, Sink& sink) {
+		    node_kind kind = tree.kind();
+		    const operation* op = as_operation(tree, kind);
+		    std::size_t count = size_of(op);
+		    char buffer[32];
+
+		    switch (kind) {
+		    case node_kind::integer:
+			sink.write(buffer, format(static_cast<const integer&>(tree).value(), buffer));
+			return;
+		    case node_kind::number:
+			sink.write(buffer, format(static_cast<const number&>(tree).value(), buffer));
+			return;
+		    case node_kind::variable: {
+			const std::string& name = static_cast<const variable&>(tree).name();
+			sink.write(name.data(), name.size());
+			return;
+		    }
+		    default:
+			break;
+		    }
+		    if (count == 0) {
+			return;
+		    }
+
+		    if (kind == node_kind::function) {
+			const std::string& name = static_cast<const function&>(tree).name();
+			sink.write(name.data(), name.size());
+			sink.put('[');
+		    }
+		    std::size_t child = index + 1;
+		    for (std::size_t i = 0; i < count; i++) {
+			const base_node& next = child_of(op, i);
+			bool wrapped = false;
+			if (i > 0) {
+			    switch (kind) {
+			    case node_kind::add: sink.put('+'); break;
+			    case node_kind::multiply: sink.put('*'); break;
+			    case node_kind::power: sink.put('^'); break;
+			    default: sink.write(", ", 2); break;
+			    }
+			    wrapped = wraps_rest(kind, shapes[child]);
+			}
+			else {
+			    wrapped = wraps_first(kind, next.kind());
+			}
+			if (wrapped) {
+			    sink.put('(');
+			}
+			emit(next, shapes, child, sink);
+			if (wrapped) {
+			    sink.put(')');
+			}
+			child += shapes[child].nodes;
+		    }
+		    if (kind == node_kind::function) {
+			sink.put(']');
+		    }
+		}
+
+		template<class Sink>
+		void print_to(const base_node& tree, Sink& sink) {
+		    // Reused between calls, unless describe is printing an unusual function name
+		    thread_local std::vector<shape> scratch;
+		    thread_local bool busy = false;
+		    if (busy) {
+			std::vector<shape> shapes;
+			describe(tree, shapes);
+			emit(tree, shapes, 0, sink);
+			return;
+		    }
+		    busy = true;
+		    scratch.clear();
+		    try {
+			describe(tree, scratch);
+			emit(tree, scratch, 0, sink);
+		    }
+		    catch (...) {
+			busy = false;
+			throw;
+		    }
+		    busy = false;
+		}
+	    }
+
+	    void print(const base_node& tree, std::string& out) {
+		string_sink sink(out);
+		print_to(tree, sink);
+	    }
+
+	    void print(const base_node& tree, std::ostream& out) {
+		stream_sink sink(out);
+		print_to(tree, sink);
+	    }
+	}
+    }
+}
@@ -0,0 +1,143 @@
+#include "Gold/math/program.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Each kernel is built once per instruction set and the best one for the CPU is picked when the
+// library loads. Only add and multiply are vectorised: vector versions of pow and the built in
+// functions would not round exactly like libm, so those stay scalar.
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__linux__)
+#define GOLD_VECTOR_KERNEL __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define GOLD_VECTOR_KERNEL
+#endif
+
+namespace Gold {
+    namespace math {
+
+	namespace {
+	    // Keep the stack of a tile within about half of a typical 32KB L1
+	    constexpr std::size_t tile_bytes = 16 * 1024;
+	    constexpr std::size_t min_tile = 64;
+	    constexpr std::size_t max_tile = 512;
+
+	    GOLD_VECTOR_KERNEL
+	    void fill(double* __restrict__ out, double value, std::size_t count) {
+		for (std::size_t i = 0; i < count; i++) {
+		    out[i] = value;
+		}
+	    }
+
+	    GOLD_VECTOR_KERNEL
+	    void add_zero(double* __restrict__ out, std::size_t count) {
+		for (std::size_t i = 0; i < count; i++) {
+		    out[i] = 0.0 + out[i];
+		}
+	    }
+
+	    GOLD_VECTOR_KERNEL
+	    void add(double* __restrict__ out, const double* __restrict__ rhs, std::size_t count) {
+		for (std::size_t i = 0; i < count; i++) {
+		    out[i] = out[i] + rhs[i];
+		}
+	    }
+
+	    GOLD_VECTOR_KERNEL
+	    void add_constant(double* __restrict__ out, double rhs, std::size_t count) {
+		for (std::size_t i = 0; i < count; i++) {
+		    out[i] = out[i] + rhs;
+		}
+	    }
+
+	    GOLD_VECTOR_KERNEL
+	    void multiply(double* __restrict__ out, const double* __restrict__ rhs, std::size_t count) {
+		for (std::size_t i = 0; i < count; i++) {
+		    out[i] = out[i] * rhs[i];
+		}
+	    }
+
+	    GOLD_VECTOR_KERNEL
+	    void multiply_constant(double* __restrict__ out, double rhs, std::size_t count) {
+		for (std::size_t i = 0; i < count; i++) {
+		    out[i] = out[i] * rhs;
+		}
+	    }
+
+	    void power(double* out, const double* rhs, std::size_t count) {
+		for (std::size_t i = 0; i < count; i++) {
+		    out[i] = std::pow(out[i], rhs[i]);
+		}
+	    }
+
+	    void power_constant(double* out, double rhs, std::size_t count) {
+		for (std::size_t i = 0; i < count; i++) {
+		    out[i] = std::pow(out[i], rhs);
+		}
+	    }
+
+	    void call(double* out, node::built_in_function function, std::size_t count) {
+		for (std::size_t i = 0; i < count; i++) {
+		    out[i] = function(out[i]);
+		}
+	    }
+	}
+
+	void program::evaluate_batch(const double* const* columns, std::size_t count, double* out) const {
+	    std::size_t tile = std::clamp(tile_bytes / sizeof(double) / std::max<std::size_t>(depth, 1), min_tile, max_tile);
+	    std::vector<double> stack(tile * depth);
+	    const double* constants = constant_pool.data();
+
+	    for (std::size_t row = 0; row < count; row += tile) {
+		std::size_t rows = std::min(tile, count - row);
+		// top is the tile holding the top of the stack
+		double* top = stack.data() - tile;
+		for (const instruction& ins : instructions) {
+		    switch (ins.op) {
+		    case opcode::constant:
+			top += tile;
+			fill(top, constants[ins.operand], rows);
+			break;
+		    case opcode::variable:
+			top += tile;
+			std::memcpy(top, columns[ins.operand] + row, rows * sizeof(double));
+			break;
+		    case opcode::add_zero:
+			add_zero(top, rows);
+			break;
+		    case opcode::add:
+			add(top - tile, top, rows);
+			top -= tile;
+			break;
+		    case opcode::add_constant:
+			add_constant(top, constants[ins.operand], rows);
+			break;
+		    case opcode::add_variable:
+			add(top, columns[ins.operand] + row, rows);
+			break;
+		    case opcode::multiply:
+			multiply(top - tile, top, rows);
+			top -= tile;
+			break;
+		    case opcode::multiply_constant:
+			multiply_constant(top, constants[ins.operand], rows);
+			break;
+		    case opcode::multiply_variable:
+			multiply(top, columns[ins.operand] + row, rows);
+			break;
+		    case opcode::power:
+			power(top - tile, top, rows);
+			top -= tile;
+			break;
+		    case opcode::power_constant:
+			power_constant(top, constants[ins.operand], rows);
+			break;
+		    case opcode::call:
+			call(top, functions[ins.operand], rows);
+			break;
+		    }
+		}
+		std::memcpy(out + row, top, rows * sizeof(double));
+	    }
+	}
+    }
+}
@@ -0,0 +1,402 @@
+#include "Gold/math/native.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) && defined(__linux__)
+#define GOLD_NATIVE_X86_64 1
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace Gold {
+    namespace math {
+
+#ifdef GOLD_NATIVE_X86_64
+	namespace {
+
+	    double (*const raise)(double, double) = std::pow;
+
+	    enum reg : std::uint8_t { rax = 0, rbx = 3, rsp = 4, r12 = 12 };
+
+	    // The SSE2 instructions used, as F2 0F op for one double or 66 0F op for two
+	    enum sse : std::uint8_t { load = 0x10, store = 0x11, add = 0x58, multiply = 0x59 };
+
+	    enum mode { single, row, pair };
+
+	    /*****************************************************************************************//**
+	    * Translates a program's instructions, keeping the top of the stack in xmm0 and the rest
+	    * in a frame on the machine stack, since every call may clobber all xmm registers.
+	    * rbx holds the constants, r12 the values or columns, and in the batch loops r13 is the
+	    * row, r14 the row count and r15 the output.
+	    *
+	    * Packed code evaluates two rows at once, one in each half of the registers. Arithmetic
+	    * works on both halves together, calls are made once per half.
+	    *********************************************************************************************/
+	    class assembler {
+	    public:
+		std::vector<std::uint8_t> code;
+
+		/**********************************//**
+		* pairs => Offset from rbx of the
+		*          constants, each repeated
+		*          twice, for packed code.\n
+		* depth => The program's stack depth.
+		**************************************/
+		assembler(std::uint32_t pairs, std::size_t depth) : pairs(pairs), scratch(std::uint32_t(16 * depth)) {}
+
+		// The frame holds the stack, 16 bytes per entry, and one scratch entry
+		std::uint32_t frame() const { return scratch + 16; }
+
+		void bytes(std::initializer_list<std::uint8_t> list) {
+		    code.insert(code.end(), list);
+		}
+
+		void imm32(std::uint32_t value) {
+		    for (int i = 0; i < 4; i++) {
+			code.push_back(std::uint8_t(value >> (8 * i)));
+		    }
+		}
+
+		void imm64(std::uint64_t value) {
+		    for (int i = 0; i < 8; i++) {
+			code.push_back(std::uint8_t(value >> (8 * i)));
+		    }
+		}
+
+		void prologue(const void* constants) {
+		    // push rbx, r12, r13, r14, r15, leaving rsp 16 byte aligned below the frame
+		    bytes({ 0x53, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57 });
+		    bytes({ 0x48, 0x81, 0xEC });
+		    imm32(frame());
+		    bytes({ 0x48, 0xBB });
+		    imm64(reinterpret_cast<std::uintptr_t>(constants));
+		    // mov r12, rdi
+		    bytes({ 0x49, 0x89, 0xFC });
+		}
+
+		void epilogue() {
+		    bytes({ 0x48, 0x81, 0xC4 });
+		    imm32(frame());
+		    bytes({ 0x41, 0x5F, 0x41, 0x5E, 0x41, 0x5D, 0x41, 0x5C, 0x5B, 0xC3 });
+		}
+
+		// Emits a rel32 jump with the given opcode bytes, returning where its offset goes
+		std::size_t jump(std::initializer_list<std::uint8_t> op) {
+		    bytes(op);
+		    imm32(0);
+		    return code.size() - 4;
+		}
+
+		void patch(std::size_t at, std::size_t target) {
+		    std::uint32_t offset = std::uint32_t(target - (at + 4));
+		    std::memcpy(code.data() + at, &offset, 4);
+		}
+
+		// Stores xmm0, holding the result for the current row or rows, into out
+		void result(mode kind) {
+		    // movsd or movupd [r15 + r13*8], xmm0
+		    bytes({ kind == pair ? std::uint8_t(0x66) : std::uint8_t(0xF2), 0x43, 0x0F, store, 0x04, 0xEF });
+		}
+
+		void body(const std::vector<program::instruction>& instructions,
+			  const std::vector<node::built_in_function>& functions, mode kind);
+
+	    private:
+		std::uint32_t pairs;
+		std::uint32_t scratch;
+
+		// op xmm, [base + disp32] or, for store, [base + disp32], xmm
+		void memory(std::uint8_t prefix, sse op, int xmm, reg base, std::uint32_t disp) {
+		    code.push_back(prefix);
+		    if (base >= 8) {
+			code.push_back(0x41);
+		    }
+		    bytes({ 0x0F, op, std::uint8_t(0x80 | (xmm << 3) | (base & 7)) });
+		    if ((base & 7) == rsp) {
+			code.push_back(0x24);
+		    }
+		    imm32(disp);
+		}
+
+		void scalar_memory(sse op, int xmm, reg base, std::uint32_t disp) {
+		    memory(0xF2, op, xmm, base, disp);
+		}
+
+		// Loads or combines xmm0 with a constant, a variable, or an entry of the frame
+		void operand(mode kind, sse op, reg base, std::uint32_t disp) {
+		    if (kind != pair) {
+			scalar_memory(op, 0, base, disp);
+		    }
+		    else if (op == load || op == store) {
+			memory(0x66, op, 0, base, disp);
+		    }
+		    else {
+			// Packed arithmetic requires aligned memory, so go through xmm2
+			memory(0x66, load, 2, base, disp);
+			bytes({ 0x66, 0x0F, op, 0xC2 });
+		    }
+		}
+
+		void constant(mode kind, sse op, std::uint32_t index) {
+		    operand(kind, op, rbx, kind == pair ? pairs + 16 * index : 8 * index);
+		}
+
+		void variable(mode kind, sse op, std::uint32_t slot) {
+		    if (kind == single) {
+			scalar_memory(op, 0, r12, slot * 8);
+			return;
+		    }
+		    // mov rax, [r12 + 8*slot]
+		    bytes({ 0x49, 0x8B, 0x84, 0x24 });
+		    imm32(slot * 8);
+		    if (kind == row) {
+			// op xmm0, [rax + r13*8]
+			bytes({ 0xF2, 0x42, 0x0F, op, 0x04, 0xE8 });
+		    }
+		    else if (op == load) {
+			bytes({ 0x66, 0x42, 0x0F, load, 0x04, 0xE8 });
+		    }
+		    else {
+			bytes({ 0x66, 0x42, 0x0F, load, 0x14, 0xE8, 0x66, 0x0F, op, 0xC2 });
+		    }
+		}
+
+		std::uint32_t entry(std::size_t index) const {
+		    return std::uint32_t(16 * index);
+		}
+
+		void push(mode kind, std::size_t& height) {
+		    if (height > 0) {
+			operand(kind, store, rsp, entry(height - 1));
+		    }
+		    height++;
+		}
+
+		// xmm1 = entry; xmm1 op= xmm0; xmm0 = xmm1
+		void combine(mode kind, sse op, std::uint32_t entry) {
+		    std::uint8_t prefix = kind == pair ? 0x66 : 0xF2;
+		    memory(prefix, load, 1, rsp, entry);
+		    bytes({ prefix, 0x0F, op, 0xC8, 0x66, 0x0F, 0x28, 0xC1 });
+		}
+
+		void call(const void* target) {
+		    bytes({ 0x48, 0xB8 });
+		    imm64(reinterpret_cast<std::uintptr_t>(target));
+		    bytes({ 0xFF, 0xD0 });
+		}
+
+		void call_function(node::built_in_function function) {
+		    call(reinterpret_cast<const void*>(function));
+		}
+
+		/**********************************//**
+		* Calls pow with xmm0 raised to xmm1 or,
+		* for packed code, entry raised to
+		* exponent, half by half.
+		**************************************/
+		void power(mode kind, std::uint32_t entry, std::uint32_t exponent, bool constant_exponent) {
+		    if (kind != pair) {
+			call(reinterpret_cast<const void*>(raise));
+			return;
+		    }
+		    for (std::uint32_t half = 0; half < 16; half += 8) {
+			scalar_memory(load, 0, rsp, entry + half);
+			if (constant_exponent) {
+			    scalar_memory(load, 1, rbx, exponent);
+			}
+			else {
+			    scalar_memory(load, 1, rsp, exponent + half);
+			}
+			call(reinterpret_cast<const void*>(raise));
+			scalar_memory(store, 0, rsp, entry + half);
+		    }
+		    memory(0x66, load, 0, rsp, entry);
+		}
+	    };
+
+	    void assembler::body(const std::vector<program::instruction>& instructions,
+				 const std::vector<node::built_in_function>& functions, mode kind) {
+		typedef program::opcode opcode;
+		std::size_t height = 0;
+		for (const program::instruction& ins : instructions) {
+		    switch (ins.op) {
+		    case opcode::constant:
+			push(kind, height);
+			constant(kind, load, ins.operand);
+			break;
+		    case opcode::variable:
+			push(kind, height);
+			variable(kind, load, ins.operand);
+			break;
+		    case opcode::add_zero:
+			// xorpd xmm1, xmm1; addsd or addpd xmm1, xmm0; movapd xmm0, xmm1
+			bytes({ 0x66, 0x0F, 0x57, 0xC9, kind == pair ? std::uint8_t(0x66) : std::uint8_t(0xF2), 0x0F, add, 0xC8,
+				0x66, 0x0F, 0x28, 0xC1 });
+			break;
+		    case opcode::add:
+			combine(kind, add, entry(height - 2));
+			height--;
+			break;
+		    case opcode::multiply:
+			combine(kind, multiply, entry(height - 2));
+			height--;
+			break;
+		    case opcode::add_constant:
+			constant(kind, add, ins.operand);
+			break;
+		    case opcode::add_variable:
+			variable(kind, add, ins.operand);
+			break;
+		    case opcode::multiply_constant:
+			constant(kind, multiply, ins.operand);
+			break;
+		    case opcode::multiply_variable:
+			variable(kind, multiply, ins.operand);
+			break;
+		    case opcode::power:
+			if (kind == pair) {
+			    operand(kind, store, rsp, scratch);
+			}
+			else {
+			    // movapd xmm1, xmm0
+			    bytes({ 0x66, 0x0F, 0x28, 0xC8 });
+			    scalar_memory(load, 0, rsp, entry(height - 2));
+			}
+			power(kind, entry(height - 2), scratch, false);
+			height--;
+			break;
+		    case opcode::power_constant:
+			if (kind == pair) {
+			    operand(kind, store, rsp, scratch);
+			}
+			else {
+			    scalar_memory(load, 1, rbx, 8 * ins.operand);
+			}
+			power(kind, scratch, 8 * ins.operand, true);
+			break;
+		    case opcode::call:
+			if (kind != pair) {
+			    call_function(functions[ins.operand]);
+			    break;
+			}
+			operand(kind, store, rsp, scratch);
+			for (std::uint32_t half = 0; half < 16; half += 8) {
+			    scalar_memory(load, 0, rsp, scratch + half);
+			    call_function(functions[ins.operand]);
+			    scalar_memory(store, 0, rsp, scratch + half);
+			}
+			operand(kind, load, rsp, scratch);
+			break;
+		    }
+		}
+	    }
+	}
+#endif
+
+	native_program::pages::~pages() {
+#ifdef GOLD_NATIVE_X86_64
+	    munmap(address, size);
+#endif
+	}
+
+	bool native_program::supported() {
+#ifdef GOLD_NATIVE_X86_64
+	    return true;
+#else
+	    return false;
+#endif
+	}
+
+	native_program::native_program(program _source) : source(std::move(_source)), scalar(nullptr), rows(nullptr) {
+#ifdef GOLD_NATIVE_X86_64
+	    const std::vector<double>& constants = source.constants();
+	    std::size_t constant_bytes = constants.size() * sizeof(double);
+	    std::size_t pairs = (constant_bytes + 15) / 16 * 16;
+	    std::size_t code_offset = pairs + 2 * constant_bytes;
+	    std::size_t page = std::size_t(sysconf(_SC_PAGESIZE));
+
+	    // The constants go first in the pages, so their address is known before any code is written
+	    std::size_t estimate = code_offset + 256 + source.code().size() * 192;
+	    std::size_t size = (estimate + page - 1) / page * page;
+	    void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	    if (address == MAP_FAILED) {
+		return;
+	    }
+	    std::unique_ptr<pages> mapping(new pages { address, size });
+	    std::uint8_t* base = static_cast<std::uint8_t*>(address);
+	    if (!constants.empty()) {
+		std::memcpy(base, constants.data(), constant_bytes);
+	    }
+	    for (std::size_t i = 0; i < constants.size(); i++) {
+		std::memcpy(base + pairs + 16 * i, &constants[i], sizeof(double));
+		std::memcpy(base + pairs + 16 * i + 8, &constants[i], sizeof(double));
+	    }
+
+	    assembler out(std::uint32_t(pairs), source.stack_depth());
+	    out.prologue(base);
+	    out.body(source.instructions, source.functions, single);
+	    out.epilogue();
+
+	    // Two rows at a time while there are two left, then one
+	    std::size_t batch_entry = out.code.size();
+	    out.prologue(base);
+	    // mov r14, rsi; mov r15, rdx; xor r13d, r13d; cmp r14, 2; jb tail
+	    out.bytes({ 0x49, 0x89, 0xF6, 0x49, 0x89, 0xD7, 0x45, 0x31, 0xED });
+	    std::size_t skip_pairs = out.jump({ 0x49, 0x83, 0xFE, 0x02, 0x0F, 0x82 });
+	    std::size_t loop = out.code.size();
+	    out.body(source.instructions, source.functions, pair);
+	    out.result(pair);
+	    // add r13, 2; mov rax, r13; add rax, 2; cmp rax, r14; jbe loop
+	    out.bytes({ 0x49, 0x83, 0xC5, 0x02, 0x4C, 0x89, 0xE8, 0x48, 0x83, 0xC0, 0x02 });
+	    out.patch(out.jump({ 0x4C, 0x39, 0xF0, 0x0F, 0x86 }), loop);
+	    out.patch(skip_pairs, out.code.size());
+	    // cmp r13, r14; jae done
+	    std::size_t skip_tail = out.jump({ 0x4D, 0x39, 0xF5, 0x0F, 0x83 });
+	    out.body(source.instructions, source.functions, row);
+	    out.result(row);
+	    out.patch(skip_tail, out.code.size());
+	    out.epilogue();
+
+	    if (code_offset + out.code.size() > size) {
+		return;
+	    }
+	    std::memcpy(base + code_offset, out.code.data(), out.code.size());
+	    if (mprotect(address, size, PROT_READ | PROT_EXEC) != 0) {
+		return;
+	    }
+	    code = std::move(mapping);
+	    scalar = reinterpret_cast<scalar_function>(base + code_offset);
+	    rows = reinterpret_cast<batch_function>(base + code_offset + batch_entry);
+#endif
+	}
+
+	native_program::native_program(native_program&& other) noexcept
+	    : source(std::move(other.source)), code(std::move(other.code)), scalar(other.scalar), rows(other.rows) {
+	    other.scalar = nullptr;
+	    other.rows = nullptr;
+	}
+
+	native_program& native_program::operator=(native_program&& other) noexcept {
+	    if (this != &other) {
+		source = std::move(other.source);
+		code = std::move(other.code);
+		scalar = other.scalar;
+		rows = other.rows;
+		other.scalar = nullptr;
+		other.rows = nullptr;
+	    }
+	    return *this;
+	}
+
+	void native_program::evaluate_batch(const double* const* columns, std::size_t count, double* out) const {
+	    if (rows) {
+		rows(columns, count, out);
+	    }
+	    else {
+		source.evaluate_batch(columns, count, out);
+	    }
+	}
+    }
+}
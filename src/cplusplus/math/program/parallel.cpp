@@ -0,0 +1,76 @@
+#include "Gold/math/program.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace Gold {
+    namespace math {
+
+	namespace {
+	    // Rows of grid coordinates built at a time by each chunk
+	    constexpr std::size_t grid_block = 4096;
+
+	    std::size_t pick_chunk(std::size_t chunk, std::size_t count, const thread_pool& pool) {
+		if (chunk != 0) {
+		    return chunk;
+		}
+		// Several chunks per thread balances the threads when they run at different speeds
+		return std::max<std::size_t>(4096, count / (pool.size() * 8));
+	    }
+	}
+
+	void program::evaluate_batch(const double* const* columns, std::size_t count, double* out,
+				     thread_pool& pool, std::size_t chunk) const {
+	    pool.parallel_for(count, pick_chunk(chunk, count, pool), [&](std::size_t begin, std::size_t end) {
+		    std::vector<const double*> offset(slots.size(), nullptr);
+		    for (std::uint32_t slot : read_slots) {
+			offset[slot] = columns[slot] + begin;
+		    }
+		    evaluate_batch(offset.data(), end - begin, out + begin);
+		});
+	}
+
+	void program::evaluate_grid(const std::vector<std::vector<double> >& axes, double* out,
+				    thread_pool& pool, std::size_t chunk) const {
+	    if (axes.size() != slots.size()) {
+		throw std::length_error("Incorrect number of variables");
+	    }
+	    std::size_t count = 1;
+	    for (const std::vector<double>& axis : axes) {
+		count *= axis.size();
+	    }
+
+	    pool.parallel_for(count, pick_chunk(chunk, count, pool), [&](std::size_t begin, std::size_t end) {
+		    std::size_t dimensions = axes.size();
+		    std::vector<double> block(dimensions * std::min(grid_block, end - begin));
+		    std::vector<const double*> columns(dimensions);
+		    // Coordinates of row begin, counting like an odometer from there
+		    std::vector<std::size_t> index(dimensions);
+		    std::size_t rest = begin;
+		    for (std::size_t d = dimensions; d-- > 0;) {
+			index[d] = rest % axes[d].size();
+			rest /= axes[d].size();
+		    }
+
+		    for (std::size_t row = begin; row < end; row += grid_block) {
+			std::size_t rows = std::min(grid_block, end - row);
+			std::size_t stride = block.size() / std::max<std::size_t>(dimensions, 1);
+			for (std::size_t d = 0; d < dimensions; d++) {
+			    columns[d] = block.data() + d * stride;
+			}
+			for (std::size_t i = 0; i < rows; i++) {
+			    for (std::size_t d = 0; d < dimensions; d++) {
+				block[d * stride + i] = axes[d][index[d]];
+			    }
+			    for (std::size_t d = dimensions; d-- > 0;) {
+				if (++index[d] < axes[d].size()) {
+				    break;
+				}
+				index[d] = 0;
+			    }
+			}
+			evaluate_batch(columns.data(), rows, out + row);
+		    }
+		});
+	}
+    }
+}
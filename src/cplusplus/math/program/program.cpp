@@ -0,0 +1,288 @@
+#include "Gold/math/program.hpp"
+#include "Gold/math/exception.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+namespace Gold {
+    namespace math {
+
+	namespace {
+	    // Programs needing no more than this much stack, or this many slots, evaluate without allocating
+	    constexpr std::size_t local_size = 64;
+
+	    void collect_variables(const node::base_node& node, std::vector<std::string>& names) {
+		if (node.kind() == node::node_kind::variable) {
+		    names.push_back(static_cast<const node::variable&>(node).name());
+		}
+		else if (node.kind() != node::node_kind::integer && node.kind() != node::node_kind::number) {
+		    const node::operation& op = static_cast<const node::operation&>(node);
+		    for (auto iter = op.begin(); iter != op.end(); iter++) {
+			collect_variables(**iter, names);
+		    }
+		}
+	    }
+
+	    bool is_constant(const node::base_node& node) {
+		return node.kind() == node::node_kind::integer || node.kind() == node::node_kind::number;
+	    }
+
+	    double constant_value(const node::base_node& node) {
+		if (node.kind() == node::node_kind::integer) {
+		    return static_cast<const node::integer&>(node).value();
+		}
+		return static_cast<const node::number&>(node).value();
+	    }
+	}
+
+	program::program(const node::base_node& root) : depth(0), height(0) {
+	    if (root.is_undefined()) {
+		throw undefined_expression("Undefined evaluation");
+	    }
+	    collect_variables(root, slots);
+	    std::sort(slots.begin(), slots.end());
+	    slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+	    for (std::size_t i = 0; i < slots.size(); i++) {
+		read_slots.push_back(std::uint32_t(i));
+	    }
+	    compile(root);
+	}
+
+	void program::emit(opcode op, std::uint32_t operand) {
+	    instructions.push_back(instruction { op, operand });
+	    switch (op) {
+	    case opcode::constant:
+	    case opcode::variable:
+		height++;
+		break;
+	    case opcode::add:
+	    case opcode::multiply:
+	    case opcode::power:
+		height--;
+		break;
+	    default:
+		break;
+	    }
+	    depth = std::max(depth, height);
+	}
+
+	std::uint32_t program::intern_constant(double value) {
+	    // Compare bits so that 0 and -0 stay distinct
+	    for (std::size_t i = 0; i < constant_pool.size(); i++) {
+		if (std::memcmp(&constant_pool[i], &value, sizeof(value)) == 0) {
+		    return std::uint32_t(i);
+		}
+	    }
+	    constant_pool.push_back(value);
+	    return std::uint32_t(constant_pool.size() - 1);
+	}
+
+	std::uint32_t program::intern_function(node::built_in_function implementation) {
+	    auto found = std::find(functions.begin(), functions.end(), implementation);
+	    if (found != functions.end()) {
+		return std::uint32_t(found - functions.begin());
+	    }
+	    functions.push_back(implementation);
+	    return std::uint32_t(functions.size() - 1);
+	}
+
+	void program::compile(const node::base_node& node) {
+	    switch (node.kind()) {
+	    case node::node_kind::integer:
+	    case node::node_kind::number:
+		emit(opcode::constant, intern_constant(constant_value(node)));
+		return;
+	    case node::node_kind::variable: {
+		const std::string& name = static_cast<const node::variable&>(node).name();
+		emit(opcode::variable, std::uint32_t(std::lower_bound(slots.begin(), slots.end(), name) - slots.begin()));
+		return;
+	    }
+	    default:
+		break;
+	    }
+
+	    const node::operation& op = static_cast<const node::operation&>(node);
+	    switch (node.kind()) {
+	    case node::node_kind::add:
+	    case node::node_kind::multiply: {
+		bool sum = node.kind() == node::node_kind::add;
+		if (op.is_leaf()) {
+		    throw invalid_node(sum ? "Add node not initialized with children" : "multiply node not initialized with children");
+		}
+		// Evaluation starts from 0 or 1 and folds each child in, in order. 0+x is not x when
+		// x is -0, so sums keep that step, but 1*x is x.
+		const node::base_node& first = op.child(0);
+		if (is_constant(first)) {
+		    double value = constant_value(first);
+		    emit(opcode::constant, intern_constant(sum ? 0.0 + value : 1.0 * value));
+		}
+		else {
+		    compile(first);
+		    if (sum) {
+			emit(opcode::add_zero);
+		    }
+		}
+		for (auto iter = op.begin() + 1; iter != op.end(); iter++) {
+		    const node::base_node& child = **iter;
+		    if (is_constant(child)) {
+			emit(sum ? opcode::add_constant : opcode::multiply_constant, intern_constant(constant_value(child)));
+		    }
+		    else if (child.kind() == node::node_kind::variable) {
+			const std::string& name = static_cast<const node::variable&>(child).name();
+			emit(sum ? opcode::add_variable : opcode::multiply_variable,
+			     std::uint32_t(std::lower_bound(slots.begin(), slots.end(), name) - slots.begin()));
+		    }
+		    else {
+			compile(child);
+			emit(sum ? opcode::add : opcode::multiply);
+		    }
+		}
+		return;
+	    }
+	    case node::node_kind::power:
+		if (op.size() != 2) {
+		    throw invalid_node("Power node initialized with more or less than two children");
+		}
+		compile(op.child(0));
+		if (is_constant(op.child(1))) {
+		    emit(opcode::power_constant, intern_constant(constant_value(op.child(1))));
+		}
+		else {
+		    compile(op.child(1));
+		    emit(opcode::power);
+		}
+		return;
+	    default: {
+		const node::function& call = static_cast<const node::function&>(node);
+		if (op.is_leaf()) {
+		    throw invalid_node("Function node not initialized with children");
+		}
+		if (!call.implementation()) {
+		    throw std::invalid_argument(call.name() + " not found in functions");
+		}
+		if (op.size() != 1) {
+		    throw invalid_node("Built in functions take only one argument");
+		}
+		compile(op.child(0));
+		emit(opcode::call, intern_function(call.implementation()));
+		return;
+	    }
+	    }
+	}
+
+	program program::bind(const std::vector<std::string>& names) const {
+	    std::unordered_map<std::string_view, std::uint32_t> positions;
+	    positions.reserve(names.size());
+	    for (std::size_t i = 0; i < names.size(); i++) {
+		positions.emplace(names[i], std::uint32_t(i));
+	    }
+
+	    std::vector<std::uint32_t> remap(slots.size());
+	    program bound(*this);
+	    bound.read_slots.clear();
+	    for (std::uint32_t slot : read_slots) {
+		auto found = positions.find(slots[slot]);
+		if (found == positions.end()) {
+		    throw std::invalid_argument("Variable not found\n");
+		}
+		remap[slot] = found->second;
+		bound.read_slots.push_back(found->second);
+	    }
+	    std::sort(bound.read_slots.begin(), bound.read_slots.end());
+	    for (instruction& ins : bound.instructions) {
+		if (ins.op == opcode::variable || ins.op == opcode::add_variable || ins.op == opcode::multiply_variable) {
+		    ins.operand = remap[ins.operand];
+		}
+	    }
+	    bound.slots = names;
+	    return bound;
+	}
+
+	double program::evaluate(const std::map<std::string, double>& args) const {
+	    double local[local_size];
+	    std::vector<double> allocated;
+	    double* values = local;
+	    if (slots.size() > local_size) {
+		allocated.resize(slots.size());
+		values = allocated.data();
+	    }
+	    for (std::uint32_t slot : read_slots) {
+		auto iter = args.find(slots[slot]);
+		if (iter == args.end()) {
+		    throw std::invalid_argument("Variable not found\n");
+		}
+		values[slot] = iter->second;
+	    }
+	    return evaluate(values);
+	}
+
+	double program::evaluate(const double* values, std::size_t count) const {
+	    if (count != slots.size()) {
+		throw std::length_error("Incorrect number of variables");
+	    }
+	    return evaluate(values);
+	}
+
+	double program::evaluate(const double* values) const {
+	    if (depth <= local_size) {
+		double stack[local_size];
+		return run(values, stack);
+	    }
+	    std::vector<double> stack(depth);
+	    return run(values, stack.data());
+	}
+
+	double program::run(const double* values, double* stack) const {
+	    const double* constants = constant_pool.data();
+	    const node::built_in_function* calls = functions.data();
+	    double* top = stack - 1;
+	    for (const instruction& ins : instructions) {
+		switch (ins.op) {
+		case opcode::constant:
+		    *++top = constants[ins.operand];
+		    break;
+		case opcode::variable:
+		    *++top = values[ins.operand];
+		    break;
+		case opcode::add_zero:
+		    *top = 0.0 + *top;
+		    break;
+		case opcode::add:
+		    top[-1] = top[-1] + top[0];
+		    top--;
+		    break;
+		case opcode::add_constant:
+		    *top = *top + constants[ins.operand];
+		    break;
+		case opcode::add_variable:
+		    *top = *top + values[ins.operand];
+		    break;
+		case opcode::multiply:
+		    top[-1] = top[-1] * top[0];
+		    top--;
+		    break;
+		case opcode::multiply_constant:
+		    *top = *top * constants[ins.operand];
+		    break;
+		case opcode::multiply_variable:
+		    *top = *top * values[ins.operand];
+		    break;
+		case opcode::power:
+		    top[-1] = std::pow(top[-1], top[0]);
+		    top--;
+		    break;
+		case opcode::power_constant:
+		    *top = std::pow(*top, constants[ins.operand]);
+		    break;
+		case opcode::call:
+		    *top = calls[ins.operand](*top);
+		    break;
+		}
+	    }
+	    return *top;
+	}
+    }
+}
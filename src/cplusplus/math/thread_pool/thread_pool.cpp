@@ -0,0 +1,114 @@
+#include "Gold/math/thread_pool.hpp"
+#include <algorithm>
+
+namespace Gold {
+    namespace math {
+
+	namespace {
+	    thread_local bool inside_task = false;
+	}
+
+	thread_pool::thread_pool(unsigned threads) :
+	    body(nullptr), count(0), grain(1), next(0), busy(0), generation(0), stopping(false) {
+	    unsigned extra = (threads > 1) ? threads - 1 : 0;
+	    workers.reserve(extra);
+	    for (unsigned i = 0; i < extra; i++) {
+		workers.emplace_back([this]() { work(); });
+	    }
+	}
+
+	thread_pool::~thread_pool() {
+	    {
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	    }
+	    wake.notify_all();
+	    for (auto& worker : workers) {
+		worker.join();
+	    }
+	}
+
+	thread_pool& thread_pool::shared() {
+	    static thread_pool pool;
+	    return pool;
+	}
+
+	void thread_pool::parallel_for(std::size_t _count, std::size_t _grain, const task& _body) {
+	    if (_count == 0) {
+		return;
+	    }
+	    _grain = std::max<std::size_t>(_grain, 1);
+	    if (workers.empty() || inside_task || _count <= _grain) {
+		for (std::size_t begin = 0; begin < _count; begin += _grain) {
+		    _body(begin, std::min(_count, begin + _grain));
+		}
+		return;
+	    }
+
+	    std::lock_guard<std::mutex> job(job_mutex);
+	    {
+		std::lock_guard<std::mutex> lock(mutex);
+		body = &_body;
+		count = _count;
+		grain = _grain;
+		next = 0;
+		busy = workers.size() + 1;
+		error = nullptr;
+		generation++;
+	    }
+	    wake.notify_all();
+
+	    run_chunks();
+
+	    std::unique_lock<std::mutex> lock(mutex);
+	    busy--;
+	    finished.wait(lock, [this]() { return busy == 0; });
+	    body = nullptr;
+	    if (error) {
+		std::exception_ptr thrown = error;
+		error = nullptr;
+		std::rethrow_exception(thrown);
+	    }
+	}
+
+	void thread_pool::work() {
+	    unsigned long seen = 0;
+	    while (true) {
+		{
+		    std::unique_lock<std::mutex> lock(mutex);
+		    wake.wait(lock, [this, seen]() { return stopping || generation != seen; });
+		    if (stopping) {
+			return;
+		    }
+		    seen = generation;
+		}
+		run_chunks();
+		std::lock_guard<std::mutex> lock(mutex);
+		if (--busy == 0) {
+		    finished.notify_all();
+		}
+	    }
+	}
+
+	void thread_pool::run_chunks() {
+	    inside_task = true;
+	    while (true) {
+		std::size_t begin = next.fetch_add(grain);
+		if (begin >= count) {
+		    break;
+		}
+		try {
+		    (*body)(begin, std::min(count, begin + grain));
+		}
+		catch (...) {
+		    std::lock_guard<std::mutex> lock(mutex);
+		    if (!error) {
+			error = std::current_exception();
+		    }
+		    next = count;
+		}
+	    }
+	    inside_task = false;
+	}
+    }
+}
@@ -1,6 +1,7 @@
 #include "Gold/math/utils.hpp"
 #include "Gold/math/exception.hpp"
 #include <algorithm>
+#include <charconv>
 #include <cmath>
 #include <cstdlib>
 #include <regex>
@@ -65,23 +66,14 @@ namespace Gold {
 
 
 	    bool is_string_num(const std::string& str) {
-		if (str == "") {
-		    return false;
-		} else if (str.size() == 1 && !is_char_num(str[0])) {
-		    return false;
-		} else if (str[0] != '-' && str[0] != '.' && !is_char_num(str[0])) {
-		    return false;
-		}
-		bool oneDecimal = false;
-		for (auto it = str.begin()+1; it != str.end(); it++) {
-		    if (is_char_num(*it)) continue;
-		    if (*it == '.' && !oneDecimal) {
-			oneDecimal = true;
-			continue;
-		    }
+		// from_chars also takes inf and nan, so insist on a digit or point after any sign
+		std::size_t start = (!str.empty() && str[0] == '-') ? 1 : 0;
+		if (start == str.size() || (str[start] != '.' && !is_char_num(str[start]))) {
 		    return false;
 		}
-		return true;
+		double value;
+		std::from_chars_result parsed = std::from_chars(str.data(), str.data() + str.size(), value);
+		return parsed.ec != std::errc::invalid_argument && parsed.ptr == str.data() + str.size();
 	    }
       
 	    bool is_string_var(const std::string& var) {
@@ -0,0 +1,141 @@
+#include "gtest/gtest.h"
+#include "Gold/math/encoding.hpp"
+#include "Gold/math/exception.hpp"
+#include <climits>
+#include <typeinfo>
+
+using Gold::math::expression;
+using Gold::math::invalid_encoding;
+using namespace Gold::math::node;
+
+TEST(Encoding, RoundTrip) {
+    const char* sources[] = {
+	"x+y*z", "(x+y)*z", "x^y^z", "-x/y", "Sin[x+y]*Cos[x]^2", "Ln[x]*Exp[y]", "2.5*x^1e-9", "Exp[x]^(x*y)"
+    };
+    for (const char* source : sources) {
+	expression expr(source);
+	expression decoded = Gold::math::decode(Gold::math::encode(expr));
+	EXPECT_EQ(expr.string(), decoded.string());
+
+	expression rate = derivative(expr, "x");
+	EXPECT_EQ(rate.string(), Gold::math::decode(Gold::math::encode(rate)).string());
+    }
+    expression call("Log[x, y+1, Abs[z]]");
+    EXPECT_EQ(call.string(), Gold::math::decode(Gold::math::encode(call)).string());
+
+    expression expr("x*y/z");
+    std::map<std::string, double> args = { {"x", 2}, {"y", 3}, {"z", 4} };
+    EXPECT_EQ(expr.evaluate(args), Gold::math::decode(Gold::math::encode(expr)).evaluate(args));
+}
+
+TEST(Encoding, Classes) {
+    base_node::ptr tree = std::make_unique<rational>(integer(5), integer(10));
+    std::string data;
+    encode(*tree, data);
+    base_node::ptr decoded = decode(data);
+    EXPECT_EQ(typeid(rational), typeid(*decoded));
+    EXPECT_EQ(typeid(inverse), typeid(static_cast<operation&>(*decoded).child(1)));
+    EXPECT_EQ(tree->string(), decoded->string());
+}
+
+TEST(Encoding, Literals) {
+    const double numbers[] = { 1e-9, -2.5, 0.1, 1e300, -0.0 };
+    for (double value : numbers) {
+	std::string data;
+	encode(number(value), data);
+	base_node::ptr decoded = decode(data);
+	EXPECT_EQ(node_kind::number, decoded->kind());
+	EXPECT_EQ(value, static_cast<number&>(*decoded).value());
+    }
+    const int integers[] = { 0, -1, 7, INT_MAX, INT_MIN };
+    for (int value : integers) {
+	std::string data;
+	encode(integer(value), data);
+	EXPECT_EQ(value, static_cast<integer&>(*decode(data)).value());
+    }
+}
+
+TEST(Encoding, Names) {
+    // Each name is stored once however often it is used
+    std::string once = Gold::math::encode(expression("longname"));
+    std::string twice = Gold::math::encode(expression("longname*longname"));
+    EXPECT_LT(twice.size(), once.size() + std::string("longname").size());
+}
+
+TEST(Encoding, Empty) {
+    expression empty;
+    expression decoded = Gold::math::decode(Gold::math::encode(empty));
+    EXPECT_FALSE(decoded.defined());
+}
+
+TEST(Encoding, Errors) {
+    std::string data = Gold::math::encode(expression("Sin[x]+2.5*y^-1"));
+    for (std::size_t length = 0; length < data.size(); length++) {
+	EXPECT_THROW(Gold::math::decode(std::string_view(data.data(), length)), invalid_encoding) << length;
+    }
+    EXPECT_THROW(Gold::math::decode(data + "x"), invalid_encoding);
+
+    std::string wrong_version = data;
+    wrong_version[4]++;
+    EXPECT_THROW(Gold::math::decode(wrong_version), invalid_encoding);
+
+    std::string wrong_magic = data;
+    wrong_magic[0] = 'g';
+    EXPECT_THROW(Gold::math::decode(wrong_magic), invalid_encoding);
+
+    // Flipping bytes must never crash, only throw or decode something
+    for (std::size_t i = 5; i < data.size(); i++) {
+	std::string corrupt = data;
+	corrupt[i] = char(0xff);
+	try {
+	    Gold::math::decode(corrupt);
+	}
+	catch (const invalid_encoding&) {
+	}
+    }
+}
+
+TEST(Encoding, Depth) {
+    // A chain of sums, each holding the next
+    auto chain = [](std::size_t levels) {
+	add::ptr root = std::make_unique<add>();
+	add* last = root.get();
+	for (std::size_t i = 1; i < levels; i++) {
+	    add::ptr next = std::make_unique<add>();
+	    add* inner = next.get();
+	    last->append(std::move(next));
+	    last = inner;
+	}
+	last->append(std::make_unique<variable>("x"));
+	return root;
+    };
+    std::string data;
+    encode(*chain(10000), data);
+    EXPECT_EQ(2, decode(data)->evaluate({ {"x", 2} }));
+    data.clear();
+    encode(*chain(10001), data);
+    EXPECT_THROW(decode(data), invalid_encoding);
+}
+
+TEST(Encoding, Arity) {
+    // The node count, then the tag and arity of the first node, come just before the nodes
+    std::string power = Gold::math::encode(expression("x^y"));
+    std::size_t at = power.size() - 7;
+    ASSERT_EQ(3, power[at]);
+    ASSERT_EQ(2, power[at + 2]);
+    // Drop the exponent
+    power.resize(power.size() - 2);
+    power[at] = 2;
+    power[at + 2] = 1;
+    EXPECT_THROW(Gold::math::decode(power), invalid_encoding);
+
+    // Drop the argument of a call
+    std::string call = Gold::math::encode(expression("Sin[x]"));
+    at = call.size() - 6;
+    ASSERT_EQ(2, call[at]);
+    ASSERT_EQ(1, call[at + 3]);
+    call.resize(call.size() - 2);
+    call[at] = 1;
+    call[at + 3] = 0;
+    EXPECT_THROW(Gold::math::decode(call), invalid_encoding);
+}
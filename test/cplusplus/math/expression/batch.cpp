@@ -0,0 +1,37 @@
+#include "gtest/gtest.h"
+#include "Gold/math/batch.hpp"
+
+using namespace Gold::math;
+
+TEST(ParseBatch, Results) {
+    std::vector<std::string> sources;
+    for (int i = 0; i < 500; i++) {
+	sources.push_back("x^" + std::to_string(i) + "+y");
+    }
+    std::vector<std::string_view> views(sources.begin(), sources.end());
+    std::vector<parse_error> errors;
+    thread_pool pool(4);
+    std::vector<expression> results = parse_batch(views, errors, pool);
+    ASSERT_EQ(sources.size(), results.size());
+    EXPECT_TRUE(errors.empty());
+    for (std::size_t i = 0; i < sources.size(); i++) {
+	EXPECT_EQ(sources[i], results[i].string());
+    }
+}
+
+TEST(ParseBatch, Errors) {
+    std::vector<std::string_view> views;
+    for (int i = 0; i < 200; i++) {
+	views.push_back(i % 50 == 3 ? "(a+b" : "a+b");
+    }
+    std::vector<parse_error> errors;
+    thread_pool pool(3);
+    std::vector<expression> results = parse_batch(views, errors, pool);
+    ASSERT_EQ(std::size_t(4), errors.size());
+    for (std::size_t i = 0; i < errors.size(); i++) {
+	EXPECT_EQ(i * 50 + 3, errors[i].index);
+	EXPECT_EQ("(a+b has mismatched parentheses", errors[i].message);
+	EXPECT_FALSE(results[errors[i].index].defined());
+    }
+    EXPECT_TRUE(results[4].defined());
+}
@@ -0,0 +1,134 @@
+#include "gtest/gtest.h"
+#include "Gold/math/disk_cache.hpp"
+#include "Gold/math/exception.hpp"
+#include <filesystem>
+#include <fstream>
+
+using namespace Gold::math;
+
+namespace {
+    std::string fresh_directory(const std::string& name) {
+	std::string directory = testing::TempDir() + name;
+	std::filesystem::remove_all(directory);
+	return directory;
+    }
+}
+
+TEST(DiskCache, ColdThenWarm) {
+    std::string directory = fresh_directory("gold_disk_cache_warm");
+    {
+	disk_cache cache(directory);
+	EXPECT_EQ("x+1", cache.parse("x + 1").string());
+	EXPECT_EQ("Sin[x]*y", cache.parse("Sin[x]*y").string());
+	EXPECT_EQ("Sin[x]*y", cache.parse("Sin[x]*y").string());
+	disk_cache::statistics stats = cache.stats();
+	EXPECT_EQ(std::size_t(2), stats.misses);
+	EXPECT_EQ(std::size_t(1), stats.hits);
+	EXPECT_EQ(std::size_t(2), stats.entries);
+	cache.flush();
+    }
+    disk_cache cache(directory);
+    EXPECT_EQ(std::size_t(2), cache.stats().entries);
+    EXPECT_EQ("x+1", cache.parse("x+1").string());
+    EXPECT_EQ(0, cache.parse("Sin[x]*y").evaluate({ {"x", 0}, {"y", 1} }));
+    EXPECT_EQ(std::size_t(2), cache.stats().hits);
+    EXPECT_EQ(std::size_t(0), cache.stats().misses);
+}
+
+TEST(DiskCache, FlushesOnDestruction) {
+    std::string directory = fresh_directory("gold_disk_cache_destroy");
+    {
+	disk_cache cache(directory);
+	cache.parse("a*b");
+    }
+    disk_cache cache(directory);
+    cache.parse("a*b");
+    EXPECT_EQ(std::size_t(1), cache.stats().hits);
+}
+
+TEST(DiskCache, FailsWhereParseFails) {
+    std::string directory = fresh_directory("gold_disk_cache_exponent");
+    disk_cache cache(directory);
+    cache.parse("1e-5");
+    for (const char* source : { "1e -5", "1e- 5" }) {
+	if (try_parse(source)) {
+	    EXPECT_EQ(expression(source).string(), cache.parse(source).string()) << source;
+	}
+	else {
+	    EXPECT_THROW(cache.parse(source), invalid_expression) << source;
+	}
+    }
+}
+
+TEST(DiskCache, SharedDirectory) {
+    // Each flush merges with the pack on disk, so the last writer keeps the first one's entries
+    std::string directory = fresh_directory("gold_disk_cache_shared");
+    {
+	disk_cache first(directory);
+	disk_cache second(directory);
+	first.parse("a+1");
+	second.parse("b+1");
+	second.parse("a*2");
+	first.flush();
+	second.flush();
+	EXPECT_EQ(std::size_t(3), second.stats().entries);
+	first.parse("c+1");
+    }
+    disk_cache cache(directory);
+    EXPECT_EQ(std::size_t(4), cache.stats().entries);
+    for (const char* source : { "a+1", "b+1", "a*2", "c+1" }) {
+	cache.parse(source);
+    }
+    EXPECT_EQ(std::size_t(4), cache.stats().hits);
+
+    // No temporary files are left behind
+    std::size_t files = 0;
+    for (const auto& file : std::filesystem::directory_iterator(directory)) {
+	EXPECT_TRUE(file.path().filename() == "expressions.gold" || file.path().filename() == "expressions.gold.lock")
+	    << file.path();
+	files++;
+    }
+    EXPECT_EQ(std::size_t(2), files);
+}
+
+TEST(DiskCache, Corruption) {
+    std::string directory = fresh_directory("gold_disk_cache_corrupt");
+    std::string path;
+    {
+	disk_cache cache(directory);
+	cache.parse("Exp[x]^2");
+	path = cache.path();
+    }
+    {
+	// Flip the last byte, which belongs to the encoded tree
+	std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+	file.seekg(-1, std::ios::end);
+	char last = char(file.get());
+	file.seekp(-1, std::ios::end);
+	file.put(char(last ^ 0x55));
+    }
+    {
+	disk_cache cache(directory);
+	EXPECT_EQ("Exp[x]^2", cache.parse("Exp[x]^2").string());
+	EXPECT_EQ(std::size_t(1), cache.stats().stale);
+    }
+    disk_cache cache(directory);
+    EXPECT_EQ("Exp[x]^2", cache.parse("Exp[x]^2").string());
+    EXPECT_EQ(std::size_t(1), cache.stats().hits);
+}
+
+TEST(DiskCache, ForeignFile) {
+    std::string directory = fresh_directory("gold_disk_cache_foreign");
+    std::filesystem::create_directories(directory);
+    std::ofstream(directory + "/expressions.gold", std::ios::binary) << "not a pack file";
+    disk_cache cache(directory);
+    EXPECT_EQ(std::size_t(0), cache.stats().entries);
+    EXPECT_EQ("x^2", cache.parse("x^2").string());
+    EXPECT_EQ(std::size_t(1), cache.stats().misses);
+}
+
+TEST(DiskCache, Errors) {
+    disk_cache cache(fresh_directory("gold_disk_cache_errors"));
+    EXPECT_THROW(cache.parse("(x+"), invalid_expression);
+    EXPECT_EQ(std::size_t(0), cache.stats().entries);
+}
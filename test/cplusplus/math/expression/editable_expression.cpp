@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+#include "Gold/math/editable_expression.hpp"
+#include "Gold/math/exception.hpp"
+
+using namespace Gold::math;
+
+namespace {
+    void expect_edit(editable_expression& expr, const text_edit& change, bool incremental) {
+	EXPECT_EQ(incremental, expr.edit(change)) << expr.source();
+	EXPECT_EQ(expression(expr.source()).string(), expr.value().string()) << expr.source();
+    }
+}
+
+TEST(EditableExpression, Regions) {
+    editable_expression expr("a*(b+c)^2 + Sin[x*(y+1)]");
+    EXPECT_EQ("a*(b+c)^2+Sin[x*(y+1)]", expr.value().string());
+
+    expect_edit(expr, { 3, 1, "d" }, true);
+    EXPECT_EQ("a*(d+c)^2 + Sin[x*(y+1)]", expr.source());
+
+    expect_edit(expr, { 22, 0, "*z" }, true);
+    EXPECT_EQ("a*(d+c)^2 + Sin[x*(y+1*z)]", expr.source());
+
+    expect_edit(expr, { 16, 1, "Cos[t]" }, true);
+    EXPECT_EQ("a*(d+c)^2 + Sin[Cos[t]*(y+1*z)]", expr.source());
+
+    expect_edit(expr, { 0, 1, "b" }, false);
+    EXPECT_EQ("b*(d+c)^2+Sin[Cos[t]*(y+1*z)]", expr.value().string());
+}
+
+TEST(EditableExpression, Splicing) {
+    // Groups flattened into their surroundings have no subtree of their own
+    editable_expression sum("a+(b*c)");
+    expect_edit(sum, { 3, 1, "e" }, false);
+    EXPECT_EQ("a+e*c", sum.value().string());
+
+    // Turning a bracketed sum into a product changes how it joins the enclosing product
+    editable_expression product("x*(a+b)*y");
+    expect_edit(product, { 4, 1, "*" }, false);
+    EXPECT_EQ("x*a*b*y", product.value().string());
+
+    editable_expression nested("Exp[x*(a+b)*y]");
+    expect_edit(nested, { 8, 1, "/" }, true);
+    EXPECT_EQ("Exp[x*a*b^(-1)*y]", nested.value().string());
+}
+
+TEST(EditableExpression, Errors) {
+    editable_expression expr("Sin[x]+1");
+    EXPECT_THROW(expr.edit({ 5, 0, "+" }), invalid_expression);
+    EXPECT_THROW(expr.edit({ 5, 0, ")" }), invalid_expression);
+    EXPECT_THROW(expr.edit({ 9, 0, "x" }), std::out_of_range);
+    EXPECT_EQ("Sin[x]+1", expr.source());
+    EXPECT_EQ("Sin[x]+1", expr.value().string());
+}
+
+TEST(EditableExpression, RandomEdits) {
+    const std::vector<std::string> insertions = { "x", "+y", "*2", "(z-1)", "-", "/", "Cos[w]", "^3", "(", ")", " " };
+    editable_expression expr("a*(b+c)^2 - Sin[x*(y+1)]/(2*Exp[-(k*t)^2]) + (u*(v-w))^(1/2)");
+    unsigned seed = 12345;
+    auto random = [&seed](std::size_t bound) {
+	seed = seed * 1103515245u + 12345u;
+	return std::size_t((seed >> 16) % bound);
+    };
+
+    std::size_t incremental = 0;
+    for (int i = 0; i < 2000; i++) {
+	std::string before = expr.source();
+	std::size_t offset = random(before.size() + 1);
+	text_edit change { offset, 0, "" };
+	if (offset < before.size() && random(3) == 0) {
+	    change.removed = 1;
+	}
+	else {
+	    change.inserted = insertions[random(insertions.size())];
+	}
+	try {
+	    incremental += expr.edit(change);
+	}
+	catch (const std::exception&) {
+	    EXPECT_EQ(before, expr.source());
+	    continue;
+	}
+	ASSERT_EQ(expression(expr.source()).string(), expr.value().string()) << before << " => " << expr.source();
+	if (expr.source().size() > 400) {
+	    expr.edit({ 0, expr.source().size(), "a*(b+c)^2 - Sin[x*(y+1)]" });
+	}
+    }
+    EXPECT_LT(std::size_t(100), incremental);
+}
@@ -2,6 +2,7 @@
 #include "Gold/math/expression.hpp"
 #include <iostream>
 #include <exception>
+#include <tuple>
 
 using namespace Gold::math;
 
@@ -20,6 +21,84 @@ TEST(Expression, Constructors) {
     EXPECT_FALSE(expr2.defined());
 }
 
+TEST(Expression, StringViewConstructors) {
+    std::string buffer = "{\"f\": \"x + 2.5*y\", \"g\": \"12\"}";
+    expression f(std::string_view(buffer).substr(7, 9));
+    EXPECT_EQ("x+2.5*y", f.string());
+
+    expression g(buffer.data() + 25, 1);
+    EXPECT_EQ("1", g.string());
+
+    std::string digits = "2.51";
+    expression h(digits.data(), 3);
+    EXPECT_EQ("2.5", h.string());
+}
+
+TEST(Expression, TryParse) {
+    result<expression> parsed = try_parse("a + b^2");
+    ASSERT_TRUE(parsed.ok());
+    EXPECT_EQ("a+b^2", parsed.value().string());
+
+    std::vector<std::tuple<std::string, error_code, std::size_t>> failures {
+	{ "", error_code::empty_expression, 0 },
+	{ "a+$", error_code::unexpected_character, 2 },
+	{ "a*(b+c", error_code::mismatched_brackets, 2 },
+	{ "a+)", error_code::mismatched_brackets, 2 },
+	{ "a+*b", error_code::unexpected_token, 2 },
+	{ "a+", error_code::unexpected_end, 2 },
+	{ "Sin[]", error_code::unexpected_token, 4 },
+	{ "a*Foo[x]", error_code::function_not_found, 2 },
+	{ "1+1e999", error_code::literal_out_of_range, 2 },
+    };
+    for (const auto& failure : failures) {
+	result<expression> attempt = try_parse(std::get<0>(failure));
+	EXPECT_FALSE(attempt.ok()) << std::get<0>(failure);
+	EXPECT_FALSE(attempt.value().defined());
+	EXPECT_EQ(std::get<1>(failure), attempt.error().code) << std::get<0>(failure);
+	EXPECT_EQ(std::get<2>(failure), attempt.error().position) << std::get<0>(failure);
+	EXPECT_EQ(std::get<1>(failure), validate(std::get<0>(failure)).code);
+    }
+    EXPECT_EQ(error_code::none, validate("Sin[x]^-2/(a-b)").code);
+}
+
+TEST(Evaluation, TryEvaluate) {
+    result<double> value = expression("a+b^2").try_evaluate({{ "a", 1}, {"b", 2}});
+    ASSERT_TRUE(value.ok());
+    EXPECT_EQ(5, value.value());
+
+    EXPECT_EQ(error_code::variable_not_found, expression("a+b").try_evaluate({{ "a", 1 }}).error().code);
+    EXPECT_EQ(error_code::wrong_argument_count, expression("Sin[x, x]").try_evaluate({{ "x", 1 }}).error().code);
+    EXPECT_EQ(error_code::undefined_expression, expression().try_evaluate().error().code);
+    EXPECT_STREQ("Variable not found", describe(error_code::variable_not_found));
+}
+
+TEST(Expression, Literals) {
+    EXPECT_EQ(0.1, expression("0.1").evaluate());
+    EXPECT_EQ("0.1", expression("0.1").string());
+    EXPECT_EQ("1e-09+x", expression("1e-9 + x").string());
+    EXPECT_EQ("-2.5e+300", expression("-2.5E300").string());
+    EXPECT_EQ("0.30000000000000004", expression(0.1 + 0.2).string());
+    EXPECT_EQ("1234", expression(1.234e3).string());
+    EXPECT_EQ("-7", expression(-7).string());
+    for (double value : { 1.0 / 3, 2.0 / 7e-200, 123456.789, 5e-324 }) {
+	EXPECT_EQ(value, expression(expression(value).string()).evaluate());
+    }
+    EXPECT_THROW(expression("1e999"), std::out_of_range);
+}
+
+TEST(Expression, LargeWholeNumbers) {
+    // Printed as digits alone, which read back as a number once they are too large for an integer
+    for (double value : { 2147483648.0, -2147483649.0, 9999999999.0, 123456789012.0, 1e22 }) {
+	std::string printed = expression(value).string();
+	expression reparsed(printed);
+	EXPECT_EQ(value, reparsed.evaluate()) << printed;
+	EXPECT_EQ(printed, reparsed.string());
+    }
+    EXPECT_EQ(-2147483648.0, expression("-2147483648").evaluate());
+    EXPECT_EQ(99999999999.0, expression("1+99999999999").evaluate() - 1);
+    EXPECT_THROW(expression(std::string(400, '9')), std::out_of_range);
+}
+
 TEST(Evaluation, Sucess) {
     expression expr("a+b^2");
     EXPECT_EQ(5, expr.evaluate( {{ "a", 1}, {"b", 2}}) );
@@ -88,8 +167,8 @@ TEST(Subtraction, AddNode) {
 
 TEST(Subtraction, FuncNode) {
     expression a("a+b");
-    expression b("Func[a,b]");
-    EXPECT_EQ("a+b+-1*Func[a, b]", (a-b).string());
+    expression b("Log[a,b]");
+    EXPECT_EQ("a+b+-1*Log[a, b]", (a-b).string());
 }
 
 TEST(Multiplication, MultNode) {
@@ -111,6 +190,23 @@ TEST(Multiplication, RightMultNode) {
     EXPECT_EQ("(a+b)*c*d", (a*b).string());
 }
 
+TEST(Multiplication, NoMultNodes) {
+    expression a("a+b");
+    expression b("c+d");
+    expression c = a*b;
+    EXPECT_EQ("(a+b)*(c+d)", c.string());
+    EXPECT_EQ(21, c.evaluate({{"a", 1}, {"b", 2}, {"c", 3}, {"d", 4}}));
+}
+
+TEST(Algebra, Temporaries) {
+    expression a("a*b");
+    expression b("c+d");
+    expression c = std::move(a) * std::move(b) + expression("e")/expression("f") - pow(expression("g"), expression(2));
+    EXPECT_EQ("a*b*(c+d)+e*f^(-1)+-1*g^2", c.string());
+    EXPECT_FALSE(a.defined());
+    EXPECT_FALSE(b.defined());
+}
+
 TEST(Division, Adds) {
     expression a("a+b");
     expression b("c+d");
@@ -130,9 +226,9 @@ TEST(Division, Power) {
 }
 
 TEST(Division, Function) {
-    expression a("Func[a^b]");
-    expression b("Gunc[c^d]");
-    EXPECT_EQ("Func[a^b]*Gunc[c^d]^(-1)", (a/b).string());
+    expression a("Log[a^b]");
+    expression b("Exp[c^d]");
+    EXPECT_EQ("Log[a^b]*Exp[c^d]^(-1)", (a/b).string());
 }
 
 TEST(PowerQ, Adds) {
@@ -154,9 +250,9 @@ TEST(Power, Power) {
 }
 
 TEST(Power, Function) {
-    expression a("Func[a^b]");
-    expression b("Gunc[c^d]");
-    EXPECT_EQ("Func[a^b]^Gunc[c^d]", pow(a,b).string());
+    expression a("Log[a^b]");
+    expression b("Exp[c^d]");
+    EXPECT_EQ("Log[a^b]^Exp[c^d]", pow(a,b).string());
 }
 
 TEST(Derivative, Add) {
@@ -395,11 +491,11 @@ TEST(ChangeVariables, Power) {
 }
 
 TEST(ChangeVariables, Function) {
-    expression a("Func[a,b]");
+    expression a("Log[a,b]");
     try {
 	expression result = a( {{"a", expression("2*a")}, {"b", expression("c+2")}, {"Func", expression("Barf")}} );
 	std::string string = result.string();
-	EXPECT_EQ("Func[2*a, c+2]", string);
+	EXPECT_EQ("Log[2*a, c+2]", string);
     }
     catch (std::string& e) {
 	EXPECT_EQ(e, "");
@@ -0,0 +1,53 @@
+#include "gtest/gtest.h"
+#include "Gold/math/expression_builder.hpp"
+#include <stdexcept>
+
+using namespace Gold::math;
+
+TEST(ExpressionBuilder, Sum) {
+    expression_builder builder = expression_builder::sum();
+    builder.append(expression("a*b")).append(expression("c+d")).append(expression(2));
+    EXPECT_EQ(4u, builder.size());
+
+    expression sum = builder.finish();
+    EXPECT_EQ("a*b+c+d+2", sum.string());
+    EXPECT_EQ(0u, builder.size());
+    EXPECT_EQ(expression("a*b+c+d+2").string(), (expression("a*b") + expression("c+d") + expression(2)).string());
+}
+
+TEST(ExpressionBuilder, Product) {
+    expression_builder builder = expression_builder::product();
+    builder.append(expression("a+b")).append(expression("c*d")).append(expression("x/y"));
+    expression product = builder.finish();
+    EXPECT_EQ("(a+b)*c*d*x*y^(-1)", product.string());
+    EXPECT_EQ(14, product.evaluate({{"a", 1}, {"b", 2}, {"c", 3}, {"d", 4}, {"x", 7}, {"y", 18}}));
+}
+
+TEST(ExpressionBuilder, FewTerms) {
+    expression_builder sum(node::node_kind::add);
+    EXPECT_EQ("0", sum.finish().string());
+    EXPECT_EQ("1", expression_builder::product().finish().string());
+
+    sum.append(expression("Sin[x]"));
+    EXPECT_EQ("Sin[x]", sum.finish().string());
+
+    // The builder can be reused once finished
+    sum.append(expression("x")).append(expression("y"));
+    EXPECT_EQ("x+y", sum.finish().string());
+}
+
+TEST(ExpressionBuilder, ManyTerms) {
+    expression_builder builder = expression_builder::sum();
+    builder.reserve(10000);
+    expression x("x");
+    for (int i = 0; i < 10000; i++) {
+	builder.append(x * expression(i));
+    }
+    expression sum = builder.finish();
+    EXPECT_EQ(49995000, sum.evaluate({{"x", 1}}));
+}
+
+TEST(ExpressionBuilder, Errors) {
+    EXPECT_THROW(expression_builder(node::node_kind::power), std::invalid_argument);
+    EXPECT_THROW(expression_builder::sum().append(expression()), std::invalid_argument);
+}
@@ -0,0 +1,78 @@
+#include "gtest/gtest.h"
+#include "Gold/math/formula_reader.hpp"
+#include "Gold/math/exception.hpp"
+#include <fstream>
+
+using namespace Gold::math;
+
+namespace {
+    std::string write_file(const std::string& name, const std::string& contents) {
+	std::string path = testing::TempDir() + name;
+	std::ofstream(path, std::ios::binary) << contents;
+	return path;
+    }
+
+    std::vector<formula_reader::record> read_all(const std::string& path, std::size_t chunk_size, bool pipelined) {
+	std::vector<formula_reader::record> records;
+	formula_reader reader(path, chunk_size, pipelined);
+	for (formula_reader::record& rec : reader) {
+	    records.push_back(std::move(rec));
+	}
+	return records;
+    }
+}
+
+TEST(FormulaReader, Lines) {
+    std::string path = write_file("gold_formulas.txt", "x+1\r\n\n  \n(a+b\nSin[x]*y\n2^3");
+    for (bool pipelined : { false, true }) {
+	for (std::size_t chunk_size : { 1, 3, 7, 4096 }) {
+	    std::vector<formula_reader::record> records = read_all(path, chunk_size, pipelined);
+	    ASSERT_EQ(std::size_t(4), records.size());
+	    EXPECT_EQ(std::size_t(1), records[0].line);
+	    EXPECT_EQ("x+1", records[0].value.string());
+	    EXPECT_EQ(std::size_t(4), records[1].line);
+	    EXPECT_FALSE(records[1].ok());
+	    EXPECT_EQ("(a+b has mismatched parentheses", records[1].error);
+	    EXPECT_FALSE(records[1].value.defined());
+	    EXPECT_EQ(std::size_t(5), records[2].line);
+	    EXPECT_EQ("Sin[x]*y", records[2].value.string());
+	    EXPECT_EQ(std::size_t(6), records[3].line);
+	    EXPECT_EQ(8, records[3].value.evaluate());
+	}
+    }
+}
+
+TEST(FormulaReader, Large) {
+    std::string contents;
+    for (int i = 0; i < 5000; i++) {
+	contents += "x^" + std::to_string(i) + "+y\n";
+    }
+    std::string path = write_file("gold_formulas_large.txt", contents);
+    formula_reader reader(path, 1024);
+    formula_reader::record rec;
+    std::size_t count = 0;
+    while (reader.next(rec)) {
+	EXPECT_EQ("x^" + std::to_string(count) + "+y", rec.value.string());
+	count++;
+	EXPECT_EQ(count, rec.line);
+    }
+    EXPECT_EQ(std::size_t(5000), count);
+}
+
+TEST(FormulaReader, EarlyExit) {
+    std::string contents;
+    for (int i = 0; i < 1000; i++) {
+	contents += "a*b\n";
+    }
+    std::string path = write_file("gold_formulas_exit.txt", contents);
+    formula_reader reader(path, 64);
+    formula_reader::record rec;
+    ASSERT_TRUE(reader.next(rec));
+    EXPECT_EQ("a*b", rec.value.string());
+}
+
+TEST(FormulaReader, Errors) {
+    EXPECT_THROW(formula_reader(testing::TempDir() + "gold_missing/formulas.txt"), io_error);
+    std::string path = write_file("gold_formulas_empty.txt", "");
+    EXPECT_TRUE(read_all(path, 16, true).empty());
+}
@@ -0,0 +1,105 @@
+#include "gtest/gtest.h"
+#include "Gold/math/library.hpp"
+#include "Gold/math/encoding.hpp"
+#include "Gold/math/exception.hpp"
+#include <cstring>
+
+using namespace Gold::math;
+
+namespace {
+    const char* const sources[] = {
+	"x+y*z", "(x+y)*z", "x^y^z", "-x/y", "Sin[x+y]*Cos[x]^2", "Ln[x]*Exp[y]", "2.5*x^1e-9", "Exp[x]^(x*y)", "3"
+    };
+
+    library_builder make_builder() {
+	library_builder builder;
+	for (const char* source : sources) {
+	    builder.add(source, expression(source));
+	}
+	return builder;
+    }
+
+    // Images need 8 byte alignment, which std::string does not promise
+    std::vector<std::uint64_t> aligned_copy(const std::string& image) {
+	std::vector<std::uint64_t> copy((image.size() + 7) / 8);
+	std::memcpy(copy.data(), image.data(), image.size());
+	return copy;
+    }
+
+    std::string_view view(const std::vector<std::uint64_t>& copy, std::size_t size) {
+	return std::string_view(reinterpret_cast<const char*>(copy.data()), size);
+    }
+}
+
+TEST(Library, Evaluate) {
+    std::string image = make_builder().image();
+    std::vector<std::uint64_t> copy = aligned_copy(image);
+    expression_library library = expression_library::from_image(view(copy, image.size()));
+    ASSERT_EQ(sizeof(sources) / sizeof(sources[0]), library.size());
+
+    std::map<std::string, double> args = { {"x", 1.5}, {"y", 0.25}, {"z", -2} };
+    for (const char* source : sources) {
+	std::size_t index = library.find(source);
+	ASSERT_NE(expression_library::npos, index) << source;
+	EXPECT_EQ(source, library.name(index));
+	EXPECT_EQ(expression(source).evaluate(args), library.evaluate(index, args)) << source;
+	EXPECT_EQ(expression(source).string(), library.materialize(index).string()) << source;
+    }
+    EXPECT_EQ(expression_library::npos, library.find("x+y"));
+    EXPECT_EQ(expression_library::npos, library.find(""));
+}
+
+TEST(Library, File) {
+    std::string path = testing::TempDir() + "gold_library.image";
+    make_builder().write(path);
+    expression_library library = expression_library::open(path);
+    EXPECT_EQ(1.5 + 0.25 * 4, library.evaluate(library.find("x+y*z"), { {"x", 1.5}, {"y", 0.25}, {"z", 4} }));
+}
+
+TEST(Library, Errors) {
+    library_builder builder;
+    // The parser rejects unknown functions, but a decoded tree may still hold one
+    node::function unknown("F");
+    unknown.append(std::make_unique<node::variable>("x"));
+    std::string encoded;
+    encode(unknown, encoded);
+    builder.add("f", decode(encoded));
+    builder.add("g", expression("1/0"));
+    builder.add("h", expression("x*y"));
+    EXPECT_THROW(builder.add("h", expression("x")), std::invalid_argument);
+    EXPECT_THROW(builder.add("empty", expression()), std::invalid_argument);
+
+    std::string image = builder.image();
+    std::vector<std::uint64_t> copy = aligned_copy(image);
+    expression_library library = expression_library::from_image(view(copy, image.size()));
+    EXPECT_THROW(library.evaluate(library.find("f"), { {"x", 1} }), std::invalid_argument);
+    EXPECT_THROW(library.evaluate(library.find("g")), undefined_expression);
+    EXPECT_THROW(library.evaluate(library.find("h"), { {"x", 1} }), std::invalid_argument);
+    EXPECT_THROW(library.evaluate(library.size()), std::out_of_range);
+}
+
+TEST(Library, Damaged) {
+    std::string image = make_builder().image();
+    std::vector<std::uint64_t> copy = aligned_copy(image);
+    EXPECT_THROW(expression_library::from_image(view(copy, image.size() - 1)), invalid_encoding);
+    EXPECT_THROW(expression_library::from_image(std::string_view(image.data(), 8)), std::exception);
+
+    // Corrupting any single word must be caught on open or be harmless
+    std::map<std::string, double> args = { {"x", 1.5}, {"y", 0.25}, {"z", -2} };
+    for (std::size_t i = 0; i < copy.size(); i++) {
+	std::vector<std::uint64_t> damaged = copy;
+	damaged[i] ^= 0x0000ffff0000ffffull;
+	try {
+	    expression_library library = expression_library::from_image(view(damaged, image.size()));
+	    for (std::size_t j = 0; j < library.size(); j++) {
+		try {
+		    library.evaluate(j, args);
+		}
+		catch (const std::exception&) {
+		}
+	    }
+	}
+	catch (const invalid_encoding&) {
+	}
+    }
+}
@@ -0,0 +1,110 @@
+#include "gtest/gtest.h"
+#include "Gold/math/parse_cache.hpp"
+#include "Gold/math/exception.hpp"
+#include <thread>
+
+using namespace Gold::math;
+
+TEST(ParseCache, Normalize) {
+    EXPECT_EQ("x+1", parse_cache::normalize("  x +\t1 "));
+    EXPECT_EQ("Sin[a b]", parse_cache::normalize("Sin[ a   b ]"));
+    EXPECT_EQ("1 2", parse_cache::normalize("1 \n 2"));
+    EXPECT_EQ("1e -5", parse_cache::normalize("1e -5"));
+    EXPECT_EQ("2.5E- 3", parse_cache::normalize("2.5E-  3"));
+    EXPECT_EQ("e-5", parse_cache::normalize("e - 5"));
+}
+
+TEST(ParseCache, Hits) {
+    parse_cache cache;
+    parse_cache::handle first = cache.get("a + b^2");
+    parse_cache::handle second = cache.get("a+b ^ 2");
+    EXPECT_EQ(first, second);
+    EXPECT_EQ("a+b^2", first->string());
+    EXPECT_EQ(5, second->evaluate({{"a", 1}, {"b", 2}}));
+
+    parse_cache::statistics stats = cache.stats();
+    EXPECT_EQ(std::size_t(1), stats.hits);
+    EXPECT_EQ(std::size_t(1), stats.misses);
+    EXPECT_EQ(std::size_t(1), stats.entries);
+    EXPECT_LT(std::size_t(0), stats.bytes);
+
+    cache.clear();
+    EXPECT_EQ(std::size_t(0), cache.stats().entries);
+    EXPECT_NE(first, cache.get("a+b^2"));
+}
+
+TEST(ParseCache, SameAsParsed) {
+    parse_cache cache;
+    for (std::string source : { "2+(-1)", "-x^2", "1/x", "a-(b+c)", "Sin[x]*Cos[y]/z", "2.5", "(a*b)/(c*d)" }) {
+	expression cached = cache.parse(source);
+	expression parsed(source);
+	EXPECT_EQ(parsed.string(), cached.string());
+	EXPECT_EQ(derivative(parsed, "x").string(), derivative(cached, "x").string());
+    }
+}
+
+TEST(ParseCache, Errors) {
+    parse_cache cache;
+    EXPECT_THROW(cache.get("(a+b"), invalid_expression);
+    EXPECT_EQ(std::size_t(0), cache.stats().entries);
+    EXPECT_EQ(std::size_t(1), cache.stats().misses);
+}
+
+TEST(ParseCache, FailsWhereParseFails) {
+    // Each pair differs only in whitespace, which splits an exponent in the second
+    const char* pairs[][2] = {
+	{ "1e-5", "1e -5" }, { "1e-5", "1e- 5" }, { "2E+3", "2E +3" }, { "2.5e3", "2.5e 3" }, { "1e5*x", "1 e5*x" },
+	{ ".5e-1", ".5e - 1" }, { "x+1e-2", "x + 1e -2" }
+    };
+    parse_cache cache;
+    for (const auto& pair : pairs) {
+	cache.get(pair[0]);
+	result<expression> fresh = try_parse(pair[1]);
+	if (fresh) {
+	    EXPECT_EQ(fresh.value().string(), cache.parse(pair[1]).string()) << pair[1];
+	}
+	else {
+	    EXPECT_THROW(cache.get(pair[1]), invalid_expression) << pair[1];
+	}
+    }
+}
+
+TEST(ParseCache, Eviction) {
+    parse_cache cache(0);
+    parse_cache::handle kept = cache.get("x+y");
+    EXPECT_EQ(std::size_t(0), cache.stats().entries);
+    EXPECT_EQ(std::size_t(1), cache.stats().evictions);
+    EXPECT_EQ("x+y", kept->string());
+
+    cache.set_capacity(std::size_t(1) << 20);
+    cache.get("a");
+    cache.get("b");
+    cache.get("a");
+    std::size_t one = cache.stats().bytes / 2;
+    cache.set_capacity(one + 1);
+    // b was used least recently, so it goes first
+    parse_cache::statistics stats = cache.stats();
+    EXPECT_EQ(std::size_t(1), stats.entries);
+    EXPECT_EQ(std::size_t(2), stats.evictions);
+    cache.get("a");
+    EXPECT_EQ(std::size_t(2), cache.stats().hits);
+}
+
+TEST(ParseCache, Threads) {
+    parse_cache cache;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+	threads.emplace_back([&cache]() {
+		for (int i = 0; i < 200; i++) {
+		    parse_cache::handle expr = cache.get("x^" + std::to_string(i % 20) + " + 1");
+		    EXPECT_EQ("x^" + std::to_string(i % 20) + "+1", expr->string());
+		}
+	    });
+    }
+    for (auto& thread : threads) {
+	thread.join();
+    }
+    parse_cache::statistics stats = cache.stats();
+    EXPECT_EQ(std::size_t(800), stats.hits + stats.misses);
+    EXPECT_EQ(std::size_t(20), stats.entries);
+}
@@ -0,0 +1,95 @@
+#include "gtest/gtest.h"
+#include "Gold/math/fixed.hpp"
+#include "Gold/math/expression.hpp"
+#include "formulas.hpp"
+#include <cmath>
+
+using namespace Gold::math;
+using namespace Gold::test;
+
+namespace {
+
+    constexpr fixed::variable<0> x;
+    constexpr fixed::variable<1> y;
+    constexpr fixed::variable<2> z;
+    const std::vector<std::string> names = { "x", "y", "z" };
+
+    template <class T>
+    void expect_matches(const T& formula, const std::string& source) {
+	node::base_node::ptr tree = formula.tree(names);
+	node::base_node::ptr parsed = node::make_tree(source);
+	EXPECT_EQ(parsed->string(), tree->string()) << source;
+	for (const auto& row : rows) {
+	    std::map<std::string, double> args = arguments(row);
+	    EXPECT_EQ(bits(parsed->evaluate(args)), bits(fixed::evaluate(formula, row))) << source;
+	}
+    }
+
+    template <class T>
+    void expect_derivative(const T& formula, const std::string& source) {
+	node::base_node::ptr expected = node::make_tree(source)->derivative("x");
+	auto prime = fixed::derivative<0>(formula);
+	EXPECT_EQ(expected->string(), prime.tree(names)->string()) << source;
+	for (const auto& row : rows) {
+	    std::map<std::string, double> args = arguments(row);
+	    double value = expected->evaluate(args);
+	    if (std::isnan(value)) {
+		// Outside the domain of an inverse function. Optimized builds do not keep the sign of a NaN.
+		EXPECT_TRUE(std::isnan(fixed::evaluate(prime, row))) << source;
+	    }
+	    else {
+		EXPECT_EQ(bits(value), bits(fixed::evaluate(prime, row))) << source;
+	    }
+	}
+    }
+}
+
+TEST(Fixed, Evaluate) {
+    using fixed::literal;
+    expect_matches(x + y * z, "x+y*z");
+    expect_matches((x + y) * z, "(x+y)*z");
+    expect_matches(x - y, "x-y");
+    expect_matches(-x * y, "-x*y");
+    expect_matches(x - y * z + 2.5, "x-y*z+2.5");
+    expect_matches(x / y, "x/y");
+    expect_matches(fixed::pow(x, fixed::pow(y, z)), "x^y^z");
+    expect_matches(fixed::pow(x, literal<-2>) * literal<3>, "x^-2*3");
+    expect_matches(fixed::Sin(x + y) * fixed::pow(fixed::Cos(x), literal<2>), "Sin[x+y]*Cos[x]^2");
+    expect_matches(fixed::Ln(x) + fixed::Log(y) - fixed::Tanh(z), "Ln[x]+Log[y]-Tanh[z]");
+    expect_matches(fixed::Csc(x) + fixed::Abs(y) * fixed::H(z), "Csc[x]+Abs[y]*H[z]");
+}
+
+TEST(Fixed, ConstantFolding) {
+    // Arithmetic on literals and variables is a constant expression
+    static_assert(fixed::evaluate(x * y + fixed::literal<2>, 3.0, 4.0) == 14);
+    static_assert(fixed::evaluate(x - y * 0.5, 1.0, 4.0) == -1);
+    constexpr auto formula = (x + 1) * (y - 2);
+    static_assert(fixed::evaluate(formula, 1.0, 5.0) == 6);
+}
+
+TEST(Fixed, Derivative) {
+    using fixed::literal;
+    expect_derivative(x * y + z, "x*y+z");
+    expect_derivative(literal<3> * x * x, "3*x*x");
+    expect_derivative(fixed::pow(x, literal<2>), "x^2");
+    expect_derivative(fixed::pow(y, x), "y^x");
+    expect_derivative(fixed::pow(x, x), "x^x");
+    expect_derivative(fixed::Sin(x), "Sin[x]");
+    expect_derivative(fixed::Cos(fixed::pow(x, literal<2>)), "Cos[x^2]");
+    expect_derivative(fixed::Exp(x * y) * fixed::Tan(x), "Exp[x*y]*Tan[x]");
+    expect_derivative(fixed::Log(x) + fixed::Ln(y * x) + fixed::Sech(x), "Log[x]+Ln[y*x]+Sech[x]");
+    expect_derivative(fixed::Sec(x) * fixed::Cot(y * x) - fixed::Csch(x), "Sec[x]*Cot[y*x]-Csch[x]");
+    expect_derivative(fixed::Arcsin(x * y), "Arcsin[x*y]");
+    expect_derivative(fixed::Arccos(x) + fixed::Arctan(fixed::pow(x, literal<2>)), "Arccos[x]+Arctan[x^2]");
+    expect_derivative(fixed::Arcsinh(x) * fixed::Arctanh(y * x), "Arcsinh[x]*Arctanh[y*x]");
+    expect_derivative(fixed::Arccosh(x + y), "Arccosh[x+y]");
+    expect_derivative(fixed::Arccosh(x), "Arccosh[x]");
+
+    // Zero and one are dropped as the node rules drop them, by type
+    static_assert(std::is_same_v<decltype(fixed::derivative<0>(y * z)), fixed::add<> >);
+    static_assert(std::is_same_v<decltype(fixed::derivative<0>(fixed::literal<2> * fixed::literal<3>)),
+		  fixed::add<> >);
+    static_assert(std::is_same_v<decltype(fixed::derivative<0>(fixed::literal<-1> * fixed::literal<-1>)),
+		  fixed::integer<0> >);
+    static_assert(std::is_same_v<decltype(fixed::derivative<0>(fixed::Sin(y))), fixed::integer<0> >);
+}
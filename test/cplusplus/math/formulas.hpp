@@ -0,0 +1,49 @@
+#ifndef GOLD_TEST_FORMULAS_HPP
+#define GOLD_TEST_FORMULAS_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+
+namespace Gold {
+    namespace test {
+
+	/**********************************//**
+	* The representation of value, so that
+	* results can be compared bit for bit,
+	* signed zeros and NaNs included.
+	**************************************/
+	inline std::uint64_t bits(double value) {
+	    std::uint64_t result;
+	    std::memcpy(&result, &value, sizeof(value));
+	    return result;
+	}
+
+	/**********************************//**
+	* Formulas in x, y and z that every way
+	* of evaluating must agree on, including
+	* ones that fold away and ones that meet
+	* signed zeros and infinities at rows.
+	**************************************/
+	inline constexpr const char* formulas[] = {
+	    "x+y*z", "(x+y)*z", "x^y^z", "-x", "x-y", "x/y", "x/(y-z)", "Sin[x+y]*Cos[x]^2", "2.5*x^1e-9",
+	    "-3*x^-2", "(-x)^2", "Exp[x]^(x*y)", "x*0", "0+x*0", "Ln[x]+Log[y]-Tanh[z]", "Csc[x]+Sec[y*z]",
+	    "((x+1)*(y+2)*(z+3)+(x*y+z)*(y*z+x))^(x+y)", "7", "x"
+	};
+
+	/**********************************//**
+	* Values of x, y and z to evaluate them
+	* at.
+	**************************************/
+	inline constexpr double rows[][3] = {
+	    { 1.5, -0.25, 3 }, { -0.0, 2, -1e300 }, { 0.0, -0.0, 0.5 }, { 0.75, 1.25, -2 }
+	};
+
+	inline std::map<std::string, double> arguments(const double (&row)[3]) {
+	    return { {"x", row[0]}, {"y", row[1]}, {"z", row[2]} };
+	}
+    }
+}
+
+#endif
@@ -44,3 +44,16 @@ TEST(Evaluate, Numbers) {
     double result = f.evaluate({5,10});
     EXPECT_EQ(15, result);
 }
+
+TEST(Evaluate, VariableOrder) {
+    variable x("x");
+    variable y("y");
+    function f({y, x}, expression("x-y*Sin[x]"));
+    for (double value = -2; value < 2; value += 0.5) {
+	EXPECT_EQ(value - 3 * std::sin(value), f.evaluate({3, value}));
+    }
+    EXPECT_THROW(f.evaluate({1}), std::length_error);
+
+    function g(x, expression("x*y"));
+    EXPECT_THROW(g.evaluate({1}), std::invalid_argument);
+}
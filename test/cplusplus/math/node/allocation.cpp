@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+#include "Gold/math/expression.hpp"
+#include "Gold/math/node.hpp"
+#include "Gold/math/parser.hpp"
+#include "Gold/math/program.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Counts every allocation in the test binary, so that tests can check a piece of code makes none
+namespace {
+    std::atomic<std::size_t> allocations(0);
+
+    template<typename Body>
+    std::size_t allocations_during(Body body) {
+	std::size_t before = allocations.load();
+	body();
+	return allocations.load() - before;
+    }
+}
+
+void* operator new(std::size_t size) {
+    allocations++;
+    if (void* memory = std::malloc(size ? size : 1)) {
+	return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+// GCC cannot see that these pair with the replacements above
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+using namespace Gold::math;
+
+TEST(Allocation, EvaluateNode) {
+    const char* formula = "x^2 + 3*x*y - y/(x+1) + Sin[x]^Cos[y] + 2^(x*y) + Abs[x^2 - y^2] - 1/y";
+    node::base_node::ptr root = parser::tree_parser(formula).parse();
+    expression expr(formula);
+    std::map<std::string, double> args = { {"x", 1.5}, {"y", -2.25} };
+    double value = 0;
+    error_code code = error_code::none;
+
+    EXPECT_EQ(0u, allocations_during([&]() { value = root->evaluate(args); }));
+    EXPECT_EQ(0u, allocations_during([&]() { code = root->try_evaluate(args, value); }));
+    EXPECT_EQ(error_code::none, code);
+    EXPECT_EQ(0u, allocations_during([&]() { value = expr.evaluate(args); }));
+    EXPECT_EQ(0u, allocations_during([&]() { expr.try_evaluate(args); }));
+}
+
+TEST(Allocation, Predicates) {
+    node::integer five(5);
+    node::variable x("x");
+    node::quotient ratio(x, five);
+    node::power square(x, node::integer(2));
+    node::base_node::ptr inverse = node::inverse::make_inverse(x);
+    bool result = false;
+
+    EXPECT_EQ(0u, allocations_during([&]() {
+	result = square.is_zero() || square.is_one() || square.is_minus_one() || square.is_undefined();
+	result = result || inverse->is_one() || inverse->is_minus_one() || inverse->is_undefined();
+	result = result || ratio.is_one() || ratio.is_minus_one() || ratio.is_undefined();
+    }));
+    EXPECT_FALSE(result);
+
+    EXPECT_EQ(0u, allocations_during([&]() {
+	result = &ratio.numerator() == &ratio.child(0) && &square.base() == &square.child(0) &&
+	    &square.exponent() == &square.child(1) && inverse->numerator().is_one() && five.denominator().is_one();
+    }));
+    EXPECT_TRUE(result);
+}
+
+TEST(Allocation, EvaluateProgram) {
+    program compiled(*parser::tree_parser("x^2 + 3*x*y - y/(x+1) + Sin[x]^Cos[y]").parse());
+    std::map<std::string, double> args = { {"x", 1.5}, {"y", -2.25} };
+    double values[] = { 1.5, -2.25 };
+    double value = 0;
+
+    EXPECT_EQ(0u, allocations_during([&]() { value = compiled.evaluate(values); }));
+    EXPECT_EQ(0u, allocations_during([&]() { value = compiled.evaluate(args); }));
+    EXPECT_EQ(compiled.evaluate(values), value);
+}
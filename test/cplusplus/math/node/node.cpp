@@ -1,5 +1,7 @@
 #include "gtest/gtest.h"
 #include "Gold/math/node.hpp"
+#include "Gold/math/encoding.hpp"
+#include <cmath>
 
 using namespace Gold::math::node;
 
@@ -20,13 +22,17 @@ TEST(Node, Constructors) {
     EXPECT_EQ("5", root->get_token());
 
     root = std::make_unique<Gold::math::node::number>(5);
-    EXPECT_EQ("5.000000", root->get_token());
+    EXPECT_EQ("5", root->get_token());
 
     root = std::make_unique<Gold::math::node::number>(5.1);
-    EXPECT_EQ("5.100000", root->get_token());
+    EXPECT_EQ("5.1", root->get_token());
 
     root = std::make_unique<Gold::math::node::number>("5.1");
-    EXPECT_EQ("5.100000", root->get_token());
+    EXPECT_EQ("5.1", root->get_token());
+
+    root = std::make_unique<Gold::math::node::number>("1e-9");
+    EXPECT_EQ("1e-09", root->get_token());
+    EXPECT_EQ(1e-9, root->evaluate());
 
     root = std::make_unique<Gold::math::node::variable>("x");
     EXPECT_EQ("x", root->get_token());
@@ -36,18 +42,39 @@ TEST(Node, Constructors) {
 
     root = inverse::make_inverse(five);
     EXPECT_EQ("^", root->get_token());
-    EXPECT_EQ("1", root->numerator()->get_token());
-    EXPECT_EQ("5", root->denominator()->get_token());
+    EXPECT_EQ("1", root->numerator().get_token());
+    EXPECT_EQ("5", root->denominator().get_token());
 
     root = std::make_unique<quotient>(five, ten);
     EXPECT_EQ("*", root->get_token());
-    EXPECT_EQ("5", root->numerator()->get_token());
-    EXPECT_EQ("10", root->denominator()->get_token());
+    EXPECT_EQ("5", root->numerator().get_token());
+    EXPECT_EQ("10", root->denominator().get_token());
 
     root = std::make_unique<rational>(five, ten);
     EXPECT_EQ("*", root->get_token());
-    EXPECT_EQ("5", root->numerator()->get_token());
-    EXPECT_EQ("10", root->denominator()->get_token());
+    EXPECT_EQ("5", root->numerator().get_token());
+    EXPECT_EQ("10", root->denominator().get_token());
+}
+
+TEST(Node, Moves) {
+    base_node::ptr x = std::make_unique<variable>("x");
+    const base_node* address = x.get();
+    power square(std::move(x), std::make_unique<integer>(2));
+    EXPECT_EQ(address, &square.base());
+
+    power moved(std::move(square));
+    EXPECT_EQ(address, &moved.base());
+    EXPECT_TRUE(square.is_leaf());
+
+    function sine("Sin", base_node::vec());
+    sine.append(std::make_unique<variable>("y"));
+    function assigned;
+    assigned = std::move(sine);
+    EXPECT_EQ("Sin[y]", assigned.string());
+    EXPECT_EQ(std::sin(0.5), assigned.evaluate({{"y", 0.5}}));
+
+    quotient ratio(std::make_unique<integer>(1), std::make_unique<variable>("y"));
+    EXPECT_EQ("y", ratio.denominator().get_token());
 }
 
 TEST(Evaluatation, Integer) {
@@ -113,6 +140,31 @@ TEST(Evaluation, Function) {
     base_node::ptr root = std::make_unique<function>("Abs", x_vec);
     EXPECT_EQ(5, root->evaluate( {{"x", 5}}));
     EXPECT_EQ(5, root->evaluate( {{"x", -5}}));
+    // Abs is the double fabs, so fractions are kept rather than truncated as int abs would
+    EXPECT_EQ(2.5, root->evaluate( {{"x", -2.5}}));
+    EXPECT_EQ(0.25, make_tree("Abs[-0.25]")->evaluate());
+
+    // Names that are not built in are allowed in nodes, but fail to evaluate
+    base_node::ptr unknown = std::make_unique<function>("F", x_vec);
+    double value;
+    EXPECT_THROW(unknown->evaluate({{"x", 1}}), std::invalid_argument);
+    EXPECT_EQ(Gold::math::error_code::function_not_found, unknown->try_evaluate({{"x", 1}}, value));
+}
+
+TEST(Evaluation, BuiltIns) {
+    EXPECT_EQ(nullptr, find_built_in("F"));
+    EXPECT_EQ(nullptr, find_built_in("sin"));
+    EXPECT_EQ(std::sin(0.5), find_built_in("Sin")(0.5));
+    EXPECT_EQ(1.0 / std::sinh(0.5), find_built_in("Csch")(0.5));
+    EXPECT_EQ(1.0 / std::cosh(0.5), find_built_in("Sech")(0.5));
+    EXPECT_EQ(0.0, find_built_in("H")(-1));
+    EXPECT_EQ(find_built_in("ArcTan")(0.5), find_built_in("Arctan")(0.5));
+
+    function call("Cos");
+    EXPECT_EQ(find_built_in("Cos"), call.implementation());
+    function copy(call);
+    EXPECT_EQ(call.implementation(), copy.implementation());
+    EXPECT_EQ(make_tree("ArcSin[x^2]")->derivative("x")->string(), make_tree("Arcsin[x^2]")->derivative("x")->string());
 }
 
 
@@ -121,7 +173,7 @@ TEST(MakeLeafNode, Test) {
     EXPECT_EQ(root->get_token(), "1");
     
     root = make_leaf_node("1.5");
-    EXPECT_EQ(root->get_token(), "1.500000");
+    EXPECT_EQ(root->get_token(), "1.5");
 
     root = make_leaf_node("Hello");
     EXPECT_EQ(root->get_token(), "Hello");
@@ -151,7 +203,7 @@ TEST(MakeTree, LeafTest) {
     EXPECT_EQ(root->get_token(), "1");
     
     root = make_tree("1.5");
-    EXPECT_EQ(root->get_token(), "1.500000");
+    EXPECT_EQ(root->get_token(), "1.5");
 
     root = make_tree("Hello");
     EXPECT_EQ(root->get_token(), "Hello");
@@ -204,14 +256,14 @@ TEST(MakeString, Test) {
     root = make_tree("a-b*(c/d)");
     EXPECT_EQ("a+-1*b*c*d^(-1)", root->string());
 
-    root = make_tree("Func[a,b,a*b]");
-    EXPECT_EQ("Func[a, b, a*b]", root->string());
+    root = make_tree("Log[a,b,a*b]");
+    EXPECT_EQ("Log[a, b, a*b]", root->string());
 
     root = make_tree("2^(a/b)");
     EXPECT_EQ("2^(a*b^(-1))", root->string());
 
-    root = make_tree("-Func[a]");
-    EXPECT_EQ("-1*Func[a]", root->string());
+    root = make_tree("-Log[a]");
+    EXPECT_EQ("-1*Log[a]", root->string());
 }
 
 TEST(MakeString, Inverse) {
@@ -281,7 +333,7 @@ TEST(Is, Power) {
 }
 
 TEST(Is, Function) {
-    auto root = make_tree("F[a,b]");
+    auto root = make_tree("Log[a,b]");
     EXPECT_FALSE(root->is_zero());
     EXPECT_FALSE(root->is_one());
     EXPECT_FALSE(root->is_minus_one());
@@ -419,3 +471,45 @@ TEST(IsUndefined, TrueCases) {
     root = make_tree("a+0^0");
     EXPECT_TRUE(root->is_undefined());
 }
+
+TEST(BuiltInDerivative, MatchesFormulas) {
+    // Each rule as a formula in __, applied the way the rules used to be: parse and substitute
+    const std::pair<const char*, const char*> formulas[] = {
+	{"Sin", "Cos[__]"}, {"Cos", "-1*Sin[__]"}, {"Tan", "Sec[__]^(2)"},
+	{"Csc", "-1*Cot[__]*Csc[__]"}, {"Sec", "Sec[__]*Tan[__]"}, {"Cot", "-1*Csc[__]^(2)"},
+	{"ArcSin", "1/((1-__^(2))^(1/2))"}, {"ArcCos", "-1/((1-__^(2))^(1/2))"}, {"ArcTan", "1/(1+__^(2))"},
+	{"Sinh", "Cosh[__]"}, {"Cosh", "Sinh[__]"}, {"Tanh", "Sech[__]^(2)"},
+	{"Csch", "-1*Coth[__]*Csch[__]"}, {"Sech", "-1*Sech[__]*Tanh[__]"}, {"Coth", "-1*Csch[__]^(2)"},
+	{"ArcSinh", "1/((1+__^(2))^(1/2))"}, {"ArcCosh", "1/((__-1)^(1/2)*(__+1)^(1/2))"}, {"ArcTanh", "1/(1-__^(2))"},
+	{"Exp", "Exp[__]"}, {"Ln", "1/__"}, {"Log", "1/(__*Ln[10])"}
+    };
+    const char* arguments[] = { "x", "2", "-1.5", "x+y", "x*y", "x/y", "x^2", "Sin[x]", "a-b+c" };
+
+    for (const auto& formula : formulas) {
+	for (const char* argument : arguments) {
+	    base_node::ptr u = make_tree(argument);
+	    std::map<std::string, base_node::ptr> change;
+	    change.emplace("__", base_node::ptr(u->clone()));
+	    base_node::ptr expected = make_tree(formula.second)->change_variables(change);
+
+	    base_node::ptr actual = built_in_derivative(formula.first, *u);
+	    ASSERT_TRUE(actual) << formula.first;
+	    std::string expected_data, actual_data;
+	    encode(*expected, expected_data);
+	    encode(*actual, actual_data);
+	    EXPECT_EQ(expected_data, actual_data) << formula.first << " at " << argument;
+	    EXPECT_EQ(expected->string(), actual->string());
+	}
+    }
+    EXPECT_FALSE(built_in_derivative("Abs", *make_tree("x")));
+    EXPECT_FALSE(built_in_derivative("", *make_tree("x")));
+    EXPECT_FALSE(built_in_derivative("Tanhh", *make_tree("x")));
+}
+
+TEST(BuiltInDerivative, ChainRule) {
+    EXPECT_EQ("Cos[x]", make_tree("Sin[x]")->derivative("x")->string());
+    EXPECT_EQ("(1+-1*x^2)^(-1)", make_tree("ArcTanh[x]")->derivative("x")->string());
+    EXPECT_EQ("-1*1*Sin[x^2]*x^(2+-1)*2*1", make_tree("Cos[x^2]")->derivative("x")->string());
+    EXPECT_EQ("0", make_tree("Cos[y]")->derivative("x")->string());
+    EXPECT_THROW(make_tree("Abs[x]")->derivative("x"), std::invalid_argument);
+}
@@ -0,0 +1,152 @@
+#include "gtest/gtest.h"
+#include "Gold/math/node.hpp"
+#include "Gold/math/expression.hpp"
+#include "Gold/math/batch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Gold::math;
+
+TEST(NodePool, Mode) {
+    // The test main asks for the pool before any node is built, after which the mode is fixed
+    EXPECT_EQ(node::pool::mode::pooled, node::pool::current_mode());
+    EXPECT_TRUE(node::pool::set_mode(node::pool::mode::pooled));
+    EXPECT_FALSE(node::pool::set_mode(node::pool::mode::system));
+    EXPECT_EQ(node::pool::mode::pooled, node::pool::current_mode());
+}
+
+TEST(NodePool, Reuse) {
+    void* first = node::pool::allocate(40);
+    node::pool::deallocate(first, 40);
+    void* second = node::pool::allocate(33);
+    EXPECT_EQ(first, second);
+    node::pool::deallocate(second, 33);
+
+    void* large = node::pool::allocate(node::pool::max_block + 1);
+    node::pool::deallocate(large, node::pool::max_block + 1);
+}
+
+TEST(NodePool, Nodes) {
+    node::base_node::ptr tree = node::make_tree("x^2 + 3*Sin[x*y] - y/(x+1)");
+    node::base_node::ptr copy(tree->clone());
+    EXPECT_EQ(tree->string(), copy->string());
+    tree.reset();
+    EXPECT_DOUBLE_EQ(2.25 + 3 * std::sin(-3.375) + 2.25 / 2.5, copy->evaluate({{"x", 1.5}, {"y", -2.25}}));
+
+    // Child arrays beyond the largest block come from operator new
+    node::base_node::vec children;
+    for (int i = 0; i < 100; i++) {
+	children.push_back(std::make_unique<node::integer>(i));
+    }
+    node::add sum(std::move(children));
+    EXPECT_EQ(4950, sum.evaluate());
+}
+
+TEST(NodePool, Threads) {
+    // Trees built on threads that exit before the trees are destroyed, here
+    std::vector<expression> built(4);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < built.size(); i++) {
+	threads.emplace_back([&built, i]() {
+	    expression sum(0);
+	    for (int j = 0; j < 1000; j++) {
+		sum = std::move(sum) + expression(int(i)) * expression("x");
+		derivative(sum, "x");
+	    }
+	    built[i] = std::move(sum);
+	});
+    }
+    for (std::thread& thread : threads) {
+	thread.join();
+    }
+    for (std::size_t i = 0; i < built.size(); i++) {
+	EXPECT_EQ(2000.0 * i, built[i].evaluate({{"x", 2}}));
+    }
+    built.clear();
+
+    // Reusing what the threads left behind
+    expression product(1);
+    for (int j = 0; j < 1000; j++) {
+	product = std::move(product) * expression("x");
+    }
+    EXPECT_EQ(1, product.evaluate({{"x", 1}}));
+}
+
+TEST(NodePool, FreedOnAnotherThread) {
+    // parse_batch builds trees on the pool's threads, and they are dropped on this one
+    std::vector<std::string> sources;
+    for (int i = 0; i < 2000; i++) {
+	sources.push_back("a*(x+" + std::to_string(i) + ")^2*Sin[y]+Cos[x*y]/(z-" + std::to_string(i) + ")");
+    }
+    std::vector<std::string_view> views(sources.begin(), sources.end());
+    const std::size_t threads = 4;
+    thread_pool pool(threads);
+    std::size_t before = node::pool::reserved();
+    std::size_t first_round = 0;
+    for (int round = 0; round < 30; round++) {
+	std::vector<parse_error> errors;
+	std::vector<expression> results = parse_batch(views, errors, pool);
+	ASSERT_TRUE(errors.empty());
+	results.clear();
+	if (round == 0) {
+	    first_round = std::max(node::pool::reserved(), before) - before;
+	}
+    }
+    // Each thread holds at most what one round needs, however the formulas were shared out, and
+    // for each size a chunk or two of blocks freed here that it takes back when it next needs one
+    const std::size_t sizes = node::pool::max_block / 16;
+    const std::size_t chunk = 64 * 1024;
+    EXPECT_LE(node::pool::reserved(), before + threads * (first_round + 2 * sizes * chunk));
+}
+
+TEST(NodePool, FreedWhileOwnerReleases) {
+    // One thread frees blocks while the thread that owns them keeps emptying, resizing and
+    // unmapping chunks, so that the chunk of a block freed remotely may be let go of at any time
+    std::mutex lock;
+    std::vector<std::pair<void*, std::size_t> > handed;
+    std::atomic<bool> done { false };
+    std::thread freer([&]() {
+	std::vector<std::pair<void*, std::size_t> > taken;
+	while (!done.load() || !taken.empty()) {
+	    for (const auto& block : taken) {
+		node::pool::deallocate(block.first, block.second);
+	    }
+	    taken.clear();
+	    std::lock_guard<std::mutex> guard(lock);
+	    taken.swap(handed);
+	}
+    });
+    std::thread owner([&]() {
+	std::vector<std::pair<void*, std::size_t> > kept;
+	for (int round = 0; round < 40; round++) {
+	    // Enough blocks for more empty chunks than a thread keeps
+	    std::size_t size = 16 * (1 + round % 16);
+	    for (int i = 0; i < 20000; i++) {
+		void* memory = node::pool::allocate(size);
+		std::memset(memory, round, size);
+		kept.emplace_back(memory, size);
+	    }
+	    std::vector<std::pair<void*, std::size_t> > remote;
+	    for (std::size_t i = 0; i < kept.size(); i++) {
+		if (i % 7 == 0) {
+		    remote.push_back(kept[i]);
+		}
+		else {
+		    node::pool::deallocate(kept[i].first, kept[i].second);
+		}
+	    }
+	    kept.clear();
+	    std::lock_guard<std::mutex> guard(lock);
+	    handed.insert(handed.end(), remote.begin(), remote.end());
+	}
+    });
+    owner.join();
+    done.store(true);
+    freer.join();
+    EXPECT_TRUE(handed.empty());
+}
@@ -0,0 +1,135 @@
+#include "gtest/gtest.h"
+#include "Gold/math/parser.hpp"
+#include "Gold/math/exception.hpp"
+
+using namespace Gold::math::parser;
+using Gold::math::node::make_tree;
+using Gold::math::invalid_expression;
+
+TEST(Tokenize, Types) {
+    std::vector<token> tokens = tokenize("Sin[x1] + 2.5*(a-b)^c");
+    std::vector<token_type> types {
+	token_type::identifier, token_type::open_bracket, token_type::identifier, token_type::close_bracket,
+	token_type::plus, token_type::number, token_type::times, token_type::open_paren,
+	token_type::identifier, token_type::minus, token_type::identifier, token_type::close_paren,
+	token_type::caret, token_type::identifier, token_type::end
+    };
+    ASSERT_EQ(types.size(), tokens.size());
+    for (std::size_t i = 0; i < types.size(); i++) {
+	EXPECT_EQ(types[i], tokens[i].type);
+    }
+    EXPECT_EQ(std::size_t(10), tokens[5].begin);
+    EXPECT_EQ(std::size_t(3), tokens[5].length);
+}
+
+TEST(Tokenize, Exponents) {
+    std::vector<token> tokens = tokenize("1e-9*2E5-3e+x");
+    std::vector<token_type> types {
+	token_type::number, token_type::times, token_type::number, token_type::minus, token_type::number,
+	token_type::identifier, token_type::plus, token_type::identifier, token_type::end
+    };
+    ASSERT_EQ(types.size(), tokens.size());
+    for (std::size_t i = 0; i < types.size(); i++) {
+	EXPECT_EQ(types[i], tokens[i].type) << i;
+    }
+    EXPECT_EQ(std::size_t(4), tokens[0].length);
+    EXPECT_EQ(std::size_t(3), tokens[2].length);
+}
+
+TEST(Tokenize, Groups) {
+    std::vector<token> tokens = tokenize("(a*(b-c))");
+    EXPECT_EQ(std::size_t(8), tokens[0].match);
+    EXPECT_EQ(std::size_t(0), tokens[8].match);
+    EXPECT_FALSE(tokens[0].additive);
+    EXPECT_TRUE(tokens[0].multiplicative);
+    EXPECT_TRUE(tokens[3].additive);
+    EXPECT_FALSE(tokens[3].multiplicative);
+
+    tokens = tokenize("(-a)");
+    EXPECT_FALSE(tokens[0].additive);
+}
+
+TEST(Tokenize, ReusedBuffer) {
+    std::vector<token> tokens;
+    tokenize("a+b*c", tokens);
+    EXPECT_EQ(std::size_t(6), tokens.size());
+    tokenize("(x)", tokens);
+    ASSERT_EQ(std::size_t(4), tokens.size());
+    EXPECT_EQ(token_type::open_paren, tokens[0].type);
+    EXPECT_EQ(std::size_t(2), tokens[0].match);
+}
+
+TEST(Tokenize, Errors) {
+    EXPECT_THROW(tokenize("(a"), invalid_expression);
+    EXPECT_THROW(tokenize("a)"), invalid_expression);
+    EXPECT_THROW(tokenize("Sin[(a+b]+c)"), invalid_expression);
+    EXPECT_THROW(tokenize("a$b"), invalid_expression);
+}
+
+TEST(TreeParser, Whitespace) {
+    EXPECT_EQ("a+b*c", make_tree(" a +\tb * c ")->string());
+}
+
+TEST(TreeParser, Flattening) {
+    EXPECT_EQ("a+b+c+d*(e+f)", make_tree("a+b+(c+d*(e+f))")->string());
+    EXPECT_EQ("a+-1*b+-1*c+d", make_tree("a-b-(c-d)")->string());
+    EXPECT_EQ("a*b^(-1)*c^(-1)*d", make_tree("a/b/(c/d)")->string());
+    EXPECT_EQ("a*1*b^(-1)", make_tree("a*(1/b)")->string());
+}
+
+TEST(TreeParser, Negatives) {
+    EXPECT_EQ("-5", make_tree("-5")->string());
+    EXPECT_EQ("a+-1*(-5)", make_tree("a-(-5)")->string());
+    EXPECT_EQ("a+b", make_tree("a-(-b)")->string());
+    EXPECT_EQ("-1*5*x", make_tree("-5*x")->string());
+    EXPECT_EQ("-1*x^2", make_tree("-x^2")->string());
+    EXPECT_EQ("2^(-1)", make_tree("2^-1")->string());
+}
+
+TEST(TreeParser, Power) {
+    EXPECT_EQ("a^b^c", make_tree("a^b^c")->string());
+    EXPECT_EQ("(a^b)^c", make_tree("(a^b)^c")->string());
+    EXPECT_EQ("x^(-1)", make_tree("1/x")->string());
+}
+
+TEST(TreeParser, Functions) {
+    EXPECT_EQ("Log[Abs[a, b], c]", make_tree("Log[Abs[a,b],c]")->string());
+    EXPECT_EQ("Sin[x]^2", make_tree("Sin[x]^2")->string());
+}
+
+TEST(TreeParser, Errors) {
+    EXPECT_THROW(make_tree(""), invalid_expression);
+    EXPECT_THROW(make_tree("a+"), invalid_expression);
+    EXPECT_THROW(make_tree("a b"), invalid_expression);
+    EXPECT_THROW(make_tree("()"), invalid_expression);
+    EXPECT_THROW(make_tree("Sin[]"), invalid_expression);
+    EXPECT_THROW(make_tree("F[x]"), invalid_expression);
+    EXPECT_THROW(make_tree("1+sin[x]"), invalid_expression);
+    EXPECT_THROW(make_tree("2x"), invalid_expression);
+}
+
+TEST(TreeParser, CheckAgreesWithParse) {
+    const std::string alphabet = "ab1.2+-*/^()[],FH ";
+    std::vector<token> tokens;
+    unsigned seed = 2017;
+    for (int i = 0; i < 20000; i++) {
+	std::string str;
+	std::size_t length = 1 + (seed >> 16) % 10;
+	for (std::size_t j = 0; j < length; j++) {
+	    seed = seed * 1103515245u + 12345u;
+	    str.push_back(alphabet[(seed >> 16) % alphabet.size()]);
+	}
+	Gold::math::error_info failure { Gold::math::error_code::none, 0 };
+	tree_parser checker(str, tokens, failure);
+	bool valid = checker.check(failure);
+	bool parsed = true;
+	try {
+	    make_tree(str);
+	}
+	catch (const std::exception&) {
+	    parsed = false;
+	}
+	ASSERT_EQ(parsed, valid) << str;
+	EXPECT_EQ(valid, failure.code == Gold::math::error_code::none) << str;
+    }
+}
@@ -0,0 +1,117 @@
+#include "gtest/gtest.h"
+#include "Gold/math/printer.hpp"
+#include "Gold/math/expression.hpp"
+#include "Gold/math/utils.hpp"
+#include <sstream>
+
+using namespace Gold::math::node;
+using Gold::math::utils::append_with_parens;
+
+namespace {
+
+    // The string building printer that print replaced, kept here as the reference
+    std::string reference(const base_node& tree) {
+	if (tree.kind() == node_kind::integer || tree.kind() == node_kind::number || tree.kind() == node_kind::variable) {
+	    return tree.get_token();
+	}
+	const operation& op = static_cast<const operation&>(tree);
+	if (op.is_leaf()) {
+	    return "";
+	}
+	if (tree.kind() == node_kind::function) {
+	    std::string str = tree.get_token().append("[");
+	    for (uint i = 0; i < op.size(); i++) {
+		str.append(i == 0 ? "" : ", ").append(reference(op.child(i)));
+	    }
+	    return str.append("]");
+	}
+	std::string token = tree.get_token();
+	std::string first = reference(op.child(0));
+	std::string first_token = op.child(0).get_token();
+	if ((token == "*" && first_token == "+") ||
+	    (token == "^" && (first_token == "+" || first_token == "*" || first_token == "^"))) {
+	    first = std::string("(").append(first).append(")");
+	}
+	for (uint i = 1; i < op.size(); i++) {
+	    append_with_parens(first, reference(op.child(i)), token, true);
+	}
+	return first;
+    }
+
+    base_node::ptr random_tree(unsigned& seed, int depth) {
+	seed = seed * 1103515245u + 12345u;
+	unsigned choice = (seed >> 16) % (depth > 0 ? 9 : 4);
+	seed = seed * 1103515245u + 12345u;
+	unsigned value = (seed >> 16);
+	switch (choice) {
+	case 0: return std::make_unique<integer>(int(value % 7) - 3);
+	case 1: return std::make_unique<number>(value % 2 ? -2.5 : 1e-9);
+	case 2: return std::make_unique<variable>(value % 2 ? "x" : "y2");
+	case 3: return std::make_unique<add>();
+	default: break;
+	}
+	std::unique_ptr<operation> op;
+	switch (choice) {
+	case 4: op = std::make_unique<add>(); break;
+	case 5: op = std::make_unique<multiply>(); break;
+	case 6: op = std::make_unique<power>(); break;
+	case 7: op = std::make_unique<function>(value % 2 ? "F" : "Sin"); break;
+	default: op = std::make_unique<multiply>(); break;
+	}
+	std::size_t count = value % 4;
+	for (std::size_t i = 0; i < count; i++) {
+	    op->append(random_tree(seed, depth - 1));
+	}
+	return op;
+    }
+}
+
+TEST(Printer, Parsed) {
+    const char* sources[] = {
+	"x+y*z", "(x+y)*z", "x*(y+z)", "x^y^z", "(x^y)^z", "(x*y)^z", "x^(y*z)", "-x", "x-y", "x/y",
+	"x/(y-z)", "Sin[x+y]*Cos[x]^2", "Log[x, y+1, Abs[z]]", "2.5*x^1e-9", "-3*x^-2", "(-x)^2", "Exp[x]^(x*y)"
+    };
+    for (const char* source : sources) {
+	base_node::ptr tree = make_tree(source);
+	// Derivatives of unknown functions throw, which just ends the chain
+	for (int i = 0; i < 3 && !tree->is_undefined(); i++) {
+	    std::string printed;
+	    print(*tree, printed);
+	    EXPECT_EQ(reference(*tree), printed) << source;
+	    EXPECT_EQ(printed, tree->string()) << source;
+	    try {
+		tree = tree->derivative("x");
+	    }
+	    catch (const std::exception&) {
+		break;
+	    }
+	}
+    }
+}
+
+TEST(Printer, MatchesReference) {
+    unsigned seed = 42;
+    for (int i = 0; i < 5000; i++) {
+	base_node::ptr tree = random_tree(seed, 4);
+	std::string printed = "prefix";
+	print(*tree, printed);
+	ASSERT_EQ("prefix" + reference(*tree), printed);
+	std::ostringstream stream;
+	print(*tree, stream);
+	ASSERT_EQ(reference(*tree), stream.str());
+    }
+}
+
+TEST(Printer, Stream) {
+    std::ostringstream stream;
+    stream << Gold::math::expression("x*(y+1)") << ";" << Gold::math::expression() << ";";
+    EXPECT_EQ("x*(y+1);;", stream.str());
+
+    Gold::math::expression big("x");
+    for (int i = 0; i < 200; i++) {
+	big = big * Gold::math::expression("(y+1)");
+    }
+    stream.str("");
+    stream << big;
+    EXPECT_EQ(big.string(), stream.str());
+}
@@ -0,0 +1,84 @@
+#include "gtest/gtest.h"
+#include "Gold/math/native.hpp"
+#include "Gold/math/expression.hpp"
+#include "formulas.hpp"
+
+using namespace Gold::math;
+using namespace Gold::test;
+
+TEST(NativeProgram, MatchesProgram) {
+    for (const char* source : formulas) {
+	program compiled = expression(source).compile().bind({"x", "y", "z"});
+	native_program native(compiled);
+	EXPECT_EQ(native_program::supported(), native.native()) << source;
+	for (const auto& row : rows) {
+	    EXPECT_EQ(bits(compiled.evaluate(row)), bits(native.evaluate(row))) << source;
+	}
+    }
+}
+
+TEST(NativeProgram, Batch) {
+    std::vector<double> x, y, z;
+    for (int i = 0; i < 1000; i++) {
+	x.push_back(i / 100.0 - 5);
+	y.push_back(3 - i / 250.0);
+	z.push_back(i % 7 - 3.5);
+    }
+    for (const char* source : formulas) {
+	program compiled = expression(source).compile().bind({"x", "y", "z"});
+	native_program native(compiled);
+	const double* columns[] = { x.data(), y.data(), z.data() };
+	// Rows are done two at a time, so odd counts leave one over
+	for (std::size_t count : { std::size_t(1), std::size_t(999), x.size() }) {
+	    std::vector<double> expected(count), actual(count);
+	    compiled.evaluate_batch(columns, count, expected.data());
+	    native.evaluate_batch(columns, count, actual.data());
+	    for (std::size_t i = 0; i < count; i++) {
+		ASSERT_EQ(bits(expected[i]), bits(actual[i])) << source << " row " << i << " of " << count;
+	    }
+	}
+	native.evaluate_batch(columns, 0, nullptr);
+    }
+
+    // Columns of variables the program does not read are never touched
+    native_program native(expression("x*2").compile().bind({"y", "x"}));
+    const double* columns[] = { nullptr, x.data() };
+    std::vector<double> out(x.size());
+    native.evaluate_batch(columns, x.size(), out.data());
+    for (std::size_t i = 0; i < x.size(); i++) {
+	EXPECT_EQ(x[i] * 2, out[i]);
+    }
+}
+
+TEST(NativeProgram, DeepStack) {
+    // Right nested sums keep every partial result on the stack, well past the interpreter's local stack
+    std::string source = "x";
+    for (int i = 0; i < 100; i++) {
+	source = "x*" + std::to_string(i) + "+(" + source + ")";
+    }
+    program compiled = expression(source).compile();
+    native_program native(compiled);
+    double value = 0.5;
+    EXPECT_EQ(bits(compiled.evaluate(&value)), bits(native.evaluate(&value)));
+}
+
+TEST(NativeProgram, Move) {
+    native_program native(expression("x*y+1").compile());
+    native_program moved(std::move(native));
+    EXPECT_FALSE(native.native());
+    EXPECT_EQ(nullptr, native.function());
+    EXPECT_EQ(nullptr, native.batch());
+    double values[] = { 2, 3 };
+    EXPECT_EQ(7, moved.evaluate(values));
+    if (moved.native()) {
+	EXPECT_EQ(7, moved.function()(values));
+    }
+
+    native_program assigned(expression("x").compile());
+    assigned = std::move(moved);
+    EXPECT_FALSE(moved.native());
+    EXPECT_EQ(7, assigned.evaluate(values));
+    if (assigned.native()) {
+	EXPECT_EQ(7, assigned.function()(values));
+    }
+}
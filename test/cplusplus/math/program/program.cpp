@@ -0,0 +1,214 @@
+#include "gtest/gtest.h"
+#include "Gold/math/program.hpp"
+#include "Gold/math/expression.hpp"
+#include "Gold/math/exception.hpp"
+#include "formulas.hpp"
+#include <cstring>
+
+using namespace Gold::math;
+using namespace Gold::math::node;
+using namespace Gold::test;
+
+namespace {
+
+    base_node::ptr random_tree(unsigned& seed, int depth) {
+	seed = seed * 1103515245u + 12345u;
+	unsigned choice = (seed >> 16) % (depth > 0 ? 9 : 4);
+	seed = seed * 1103515245u + 12345u;
+	unsigned value = (seed >> 16);
+	switch (choice) {
+	case 0: return std::make_unique<integer>(int(value % 5) - 2);
+	case 1: return std::make_unique<number>(value % 2 ? -2.5 : -0.0);
+	case 2:
+	case 3: return std::make_unique<variable>(value % 2 ? "x" : "y");
+	default: break;
+	}
+	std::unique_ptr<operation> op;
+	switch (choice) {
+	case 4: op = std::make_unique<add>(); break;
+	case 5: op = std::make_unique<multiply>(); break;
+	case 6: op = std::make_unique<power>(); break;
+	case 7: op = std::make_unique<function>(value % 2 ? "Exp" : "Sin"); break;
+	default: op = std::make_unique<multiply>(); break;
+	}
+	std::size_t count = choice == 6 ? 2 : choice == 7 ? 1 : value % 3 + 1;
+	for (std::size_t i = 0; i < count; i++) {
+	    op->append(random_tree(seed, depth - 1));
+	}
+	return op;
+    }
+}
+
+TEST(Program, Parsed) {
+    for (const char* source : formulas) {
+	expression expr(source);
+	program compiled = expr.compile();
+	for (const auto& row : rows) {
+	    std::map<std::string, double> args = arguments(row);
+	    EXPECT_EQ(bits(expr.evaluate(args)), bits(compiled.evaluate(args))) << source;
+	}
+    }
+}
+
+TEST(Program, MatchesTree) {
+    unsigned seed = 7;
+    const std::map<std::string, double> arguments[] = {
+	{ {"x", 0.75}, {"y", -1.25} }, { {"x", -0.0}, {"y", 3} }, { {"x", 0.0}, {"y", -0.0} }
+    };
+    int compared = 0;
+    for (int i = 0; i < 5000; i++) {
+	base_node::ptr tree = random_tree(seed, 4);
+	if (tree->is_undefined()) {
+	    EXPECT_THROW(program compiled(*tree), undefined_expression);
+	    continue;
+	}
+	program compiled(*tree);
+	for (const auto& args : arguments) {
+	    ASSERT_EQ(bits(tree->evaluate(args)), bits(compiled.evaluate(args))) << tree->string();
+	    compared++;
+	}
+    }
+    EXPECT_GT(compared, 5000);
+}
+
+TEST(Program, Slots) {
+    program compiled = expression("b*a+Sin[b]-c*a").compile();
+    ASSERT_EQ(std::vector<std::string>({"a", "b", "c"}), compiled.variables());
+    const double values[] = { 2, 3, 5 };
+    EXPECT_EQ(3 * 2 + std::sin(3.0) - 5 * 2, compiled.evaluate(values));
+    EXPECT_TRUE(expression("2^3").compile().variables().empty());
+    EXPECT_EQ(8, expression("2^3").compile().evaluate(nullptr));
+}
+
+TEST(Program, Deep) {
+    // Deeper than the stack and wider than the slots evaluate keeps locally
+    std::string nested = "x";
+    for (int i = 0; i < 100; i++) {
+	nested = "(x+" + nested + ")*1.0001";
+    }
+    std::string wide = "0";
+    std::map<std::string, double> args = { {"x", 0.5} };
+    for (int i = 0; i < 100; i++) {
+	wide += "+v" + std::to_string(i);
+	args["v" + std::to_string(i)] = i * 0.25;
+    }
+    for (const std::string& source : { nested, wide }) {
+	expression expr(source);
+	program compiled = expr.compile();
+	EXPECT_EQ(bits(expr.evaluate(args)), bits(compiled.evaluate(args)));
+    }
+    EXPECT_GT(expression(nested).compile().stack_depth(), 64u);
+}
+
+TEST(Program, Errors) {
+    EXPECT_THROW(expression().compile(), undefined_expression);
+    EXPECT_THROW(expression("x/0").compile(), undefined_expression);
+    EXPECT_THROW(expression("Sin[x, y]").compile(), invalid_node);
+
+    function unknown("F");
+    unknown.append(std::make_unique<variable>("x"));
+    EXPECT_THROW(program compiled(unknown), std::invalid_argument);
+
+    power bad;
+    bad.append(std::make_unique<variable>("x"));
+    bad.append(std::make_unique<variable>("y"));
+    bad.append(std::make_unique<variable>("z"));
+    EXPECT_THROW(program compiled(bad), invalid_node);
+
+    program compiled = expression("x*y").compile();
+    EXPECT_THROW(compiled.evaluate({ {"x", 1} }), std::invalid_argument);
+    EXPECT_THROW(compiled.evaluate(), std::invalid_argument);
+}
+
+TEST(Program, Bind) {
+    expression expr("b*a+Sin[b]-c*a");
+    program bound = expr.compile().bind({"c", "unused", "a", "b", "a"});
+    EXPECT_EQ(std::vector<std::string>({"c", "unused", "a", "b", "a"}), bound.variables());
+
+    const double values[] = { 5, 1e300, 2, 3, -1 };
+    double expected = expr.evaluate({ {"a", 2}, {"b", 3}, {"c", 5} });
+    EXPECT_EQ(bits(expected), bits(bound.evaluate(values, 5)));
+    EXPECT_EQ(bits(expected), bits(bound.evaluate(std::vector<double>(values, values + 5))));
+    EXPECT_EQ(bits(expected), bits(bound.evaluate({ {"a", 2}, {"b", 3}, {"c", 5} })));
+    EXPECT_EQ(bits(expected), bits(bound.bind({"a", "b", "c"}).evaluate(std::vector<double>({2, 3, 5}))));
+
+    EXPECT_THROW(bound.evaluate(values, 4), std::length_error);
+    EXPECT_THROW(expr.compile().bind({"a", "b"}), std::invalid_argument);
+    EXPECT_EQ(4, expression("4").compile().bind({}).evaluate(std::vector<double>()));
+}
+
+TEST(Program, Batch) {
+    // More rows than fit in a tile, and a partial last tile
+    const std::size_t rows = 1237;
+    std::vector<double> x(rows), y(rows), out(rows);
+    for (std::size_t i = 0; i < rows; i++) {
+	x[i] = i % 7 == 0 ? -0.0 : (double(i) - 600) / 37;
+	y[i] = i % 5 == 0 ? 0.0 : std::sin(double(i)) * 4;
+    }
+
+    unsigned seed = 11;
+    for (int i = 0; i < 300; i++) {
+	base_node::ptr tree = random_tree(seed, 4);
+	if (tree->is_undefined()) {
+	    continue;
+	}
+	// Slot 1 is never read, so its column can be null
+	program compiled = program(*tree).bind({"x", "unused", "y"});
+	const double* columns[] = { x.data(), nullptr, y.data() };
+	compiled.evaluate_batch(columns, rows, out.data());
+	for (std::size_t row = 0; row < rows; row++) {
+	    double values[] = { x[row], 0, y[row] };
+	    ASSERT_EQ(bits(compiled.evaluate(values)), bits(out[row])) << tree->string() << " row " << row;
+	}
+    }
+
+    program constant = expression("2^0.5").compile();
+    constant.evaluate_batch(nullptr, 3, out.data());
+    EXPECT_EQ(std::vector<double>(3, std::pow(2, 0.5)), std::vector<double>(out.begin(), out.begin() + 3));
+    out[0] = 42;
+    constant.evaluate_batch(nullptr, 0, out.data());
+    EXPECT_EQ(42, out[0]);
+}
+
+TEST(Program, ParallelBatch) {
+    const std::size_t rows = 10007;
+    std::vector<double> x(rows), y(rows), serial(rows), parallel(rows);
+    for (std::size_t i = 0; i < rows; i++) {
+	x[i] = double(i) / 1000 - 5;
+	y[i] = std::cos(double(i));
+    }
+    program compiled = expression("Sin[x*y]^2+x/(1+y^2)").compile();
+    const double* columns[] = { x.data(), y.data() };
+    compiled.evaluate_batch(columns, rows, serial.data());
+
+    thread_pool pool(4);
+    for (std::size_t chunk : { std::size_t(0), std::size_t(1), std::size_t(333), rows * 2 }) {
+	std::fill(parallel.begin(), parallel.end(), 0.0);
+	compiled.evaluate_batch(columns, rows, parallel.data(), pool, chunk);
+	ASSERT_EQ(0, std::memcmp(serial.data(), parallel.data(), rows * sizeof(double))) << chunk;
+    }
+}
+
+TEST(Program, Grid) {
+    program compiled = expression("x*10+y-z/4").compile();
+    std::vector<std::vector<double> > axes = { {1, 2, 3}, {0.5, -0.5}, {0, 1, 2, 3, 4, 5, 6} };
+    std::vector<double> out(3 * 2 * 7);
+    thread_pool pool(3);
+    compiled.evaluate_grid(axes, out.data(), pool, 5);
+    std::size_t row = 0;
+    for (double x : axes[0]) {
+	for (double y : axes[1]) {
+	    for (double z : axes[2]) {
+		double values[] = { x, y, z };
+		EXPECT_EQ(bits(compiled.evaluate(values)), bits(out[row++]));
+	    }
+	}
+    }
+
+    EXPECT_THROW(compiled.evaluate_grid({ {1}, {2} }, out.data(), pool), std::length_error);
+    out[0] = 42;
+    compiled.evaluate_grid({ {1}, {}, {2} }, out.data(), pool);
+    EXPECT_EQ(42, out[0]);
+    expression("7").compile().evaluate_grid({}, out.data(), pool);
+    EXPECT_EQ(7, out[0]);
+}
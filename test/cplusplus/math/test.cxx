@@ -1,6 +1,9 @@
 #include "gtest/gtest.h"
+#include "Gold/math/node_pool.hpp"
 
 int main(int argc, char** argv) {
+    // Run the tests on the pool, which is off unless asked for
+    Gold::math::node::pool::set_mode(Gold::math::node::pool::mode::pooled);
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
@@ -0,0 +1,51 @@
+#include "gtest/gtest.h"
+#include "Gold/math/thread_pool.hpp"
+#include <stdexcept>
+
+using Gold::math::thread_pool;
+
+TEST(ThreadPool, CoversRange) {
+    thread_pool pool(4);
+    EXPECT_EQ(4u, pool.size());
+    std::vector<int> visits(1000, 0);
+    pool.parallel_for(visits.size(), 7, [&](std::size_t begin, std::size_t end) {
+	    for (std::size_t i = begin; i < end; i++) {
+		visits[i]++;
+	    }
+	});
+    EXPECT_EQ(visits, std::vector<int>(1000, 1));
+}
+
+TEST(ThreadPool, SingleThread) {
+    thread_pool pool(1);
+    EXPECT_EQ(1u, pool.size());
+    std::size_t total = 0;
+    pool.parallel_for(100, 10, [&](std::size_t begin, std::size_t end) { total += end - begin; });
+    EXPECT_EQ(std::size_t(100), total);
+}
+
+TEST(ThreadPool, Nested) {
+    thread_pool pool(3);
+    std::vector<int> visits(64, 0);
+    pool.parallel_for(8, 1, [&](std::size_t outer, std::size_t) {
+	    pool.parallel_for(8, 2, [&](std::size_t begin, std::size_t end) {
+		    for (std::size_t i = begin; i < end; i++) {
+			visits[outer * 8 + i]++;
+		    }
+		});
+	});
+    EXPECT_EQ(visits, std::vector<int>(64, 1));
+}
+
+TEST(ThreadPool, Exceptions) {
+    thread_pool pool(4);
+    EXPECT_THROW(pool.parallel_for(100, 1, [](std::size_t begin, std::size_t) {
+		if (begin == 50) {
+		    throw std::runtime_error("fail");
+		}
+	    }), std::runtime_error);
+
+    std::size_t total = 0;
+    pool.parallel_for(10, 10, [&](std::size_t begin, std::size_t end) { total += end - begin; });
+    EXPECT_EQ(std::size_t(10), total);
+}
@@ -40,12 +40,17 @@ TEST(IsStringNumber, NumberString) {
     EXPECT_TRUE( is_string_num("12.43"));
     EXPECT_TRUE( is_string_num("-0.435"));
     EXPECT_TRUE( is_string_num("-.43"));
+    EXPECT_TRUE( is_string_num("1e-9"));
+    EXPECT_TRUE( is_string_num("-2.5E+30"));
 }
 
 TEST(IsStringNumber, NonNumberString) {
     EXPECT_FALSE( is_string_num("Alex Guldemond"));
     EXPECT_FALSE( is_string_num("-0.4a"));
     EXPECT_FALSE( is_string_num("1+43"));
+    EXPECT_FALSE( is_string_num("1e"));
+    EXPECT_FALSE( is_string_num("inf"));
+    EXPECT_FALSE( is_string_num("-nan"));
 }
 
 TEST(IsStringVariable, True) {